@@ -8,7 +8,7 @@
     Pure DSP implementation of Sam Sampler for tvOS
     - Inherits from DSP::InstrumentDSP (no JUCE dependencies)
     - Headless operation (no GUI)
-    - SF2 SoundFont file loading
+    - SF2 SoundFont and SFZ instrument loading
     - JSON preset save/load system
     - Factory-creatable for dynamic instantiation
 
@@ -22,27 +22,253 @@
 #include <array>
 #include <memory>
 #include <cmath>
+#include <climits>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if defined(__APPLE__)
+    #include <dispatch/dispatch.h>
+#endif
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// Build option: render voices in single precision unless a preset says
+// otherwise (the "singlePrecision" parameter overrides per instance)
+#ifndef SAMSAMPLER_SINGLE_PRECISION
+ #define SAMSAMPLER_SINGLE_PRECISION 0
+#endif
 
 namespace DSP {
 
+//==============================================================================
+// Memory-Mapped Files
+//==============================================================================
+
+/**
+ * @brief Read-only mapping of a whole file
+ *
+ * mmap on POSIX, a file mapping view on Windows. Loaders read sample data
+ * straight from the page cache instead of copying the file into a buffer
+ * first. The view stays valid until close() or destruction.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map a file, replacing any current mapping; false if it cannot be read
+    bool open(const char* filePath);
+    void close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
 //==============================================================================
 // Sample Data Structure
 //==============================================================================
 
+/**
+ * @brief Allocator for cache-line aligned audio buffers
+ *
+ * Keeps every channel buffer on a 64-byte boundary so SIMD kernels can use
+ * aligned loads.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+using AudioChannelBuffer = std::vector<float, AlignedAllocator<float>>;
+
+struct LoopRegion;
+struct SamplePyramid;
+
 /**
  * @brief Audio sample data
+ *
+ * Planar layout: one aligned buffer per channel, so every channel is read
+ * contiguously. Samples are padded at load time with guard frames on both
+ * sides, so every interpolator (up to the 32-tap sinc) can read around any
+ * playable index without range checks. Fill channels with numSamples frames
+ * each, then call addGuardFrames(). Samples of a packed instrument read their
+ * padded channels straight from the mapped file instead.
  */
 struct Sample
 {
-    std::vector<float> audioData;
+    static constexpr int guardFrames = 16; // Padding frames before and after the audio (32-tap sinc reach)
+
+    std::vector<AudioChannelBuffer> channels;  // Includes guard frames once padded
     int numChannels = 1;
     int sampleRate = 44100;
-    int numSamples = 0;
+    int numSamples = 0;            // Audio frames, excluding guard frames
     double rootNote = 60.0;      // MIDI note number (60 = C4)
     double pitchCorrection = 0.0; // cents
 
-    bool isValid() const { return !audioData.empty() && numSamples > 0; }
+    // Loop points (frames); loopEnd <= loopStart means the sample has no loop
+    int loopStart = 0;
+    int loopEnd = 0;
+
+    // The loop points belong to the sample (SF2): its seam is baked there,
+    // unfaded, once, instead of at the engine's loop window
+    bool ownLoop = false;
+
+    bool guarded = false;
+
+    // Guard-padded channels inside a mapped packed instrument, used instead of
+    // channels when mapping is set (which keeps the file mapped)
+    std::shared_ptr<const MappedFile> mapping;
+    std::array<const float*, 2> mappedChannels {};
+
+    // Baked loop seam for the engine's current loop window. Rebuilt off the
+    // audio thread; always access through std::atomic_load/std::atomic_store
+    std::shared_ptr<const LoopRegion> loopRegion;
+
+    /**
+     * @brief Windowed-sinc conversion to another rate (allocates; never call on the audio thread)
+     *
+     * Returns an unpadded copy at targetRate with loop points scaled; the
+     * caller fills its channels with renderResampled() and then pads it.
+     * Downsampling lowers the kernel cutoff to the target Nyquist.
+     */
+    std::shared_ptr<Sample> resampledLayout(int targetRate) const;
+
+    // Render output frames [begin, end) of one channel of a resampledLayout() copy
+    void renderResampled(Sample& target, int channel, int begin, int end) const;
+
+    // Octave-decimated copies for large upward transpositions (opt-in). Built
+    // off the audio thread; always access through std::atomic_load/std::atomic_store
+    std::shared_ptr<const SamplePyramid> pyramid;
+
+    /**
+     * @brief Pad every channel with guard frames
+     *
+     * The pre-guard is silence. The post-guard is silence, or a copy of the
+     * loop start when the loop runs to the last frame.
+     */
+    void addGuardFrames();
+
+    // Fill from interleaved PCM (numFrames frames of numChannels channels)
+    void setInterleaved(const float* interleaved, int numFrames, int channelCount);
+
+    // First audio frame of a channel (skips the pre-guard)
+    const float* frames(int channel) const
+    {
+        return (mapping ? mappedChannels[channel] : channels[channel].data()) + guardFrames;
+    }
+
+    bool isValid() const
+    {
+        return guarded && numSamples > 0 && numChannels > 0
+            && (mapping ? numChannels <= 2 : static_cast<int>(channels.size()) == numChannels);
+    }
+};
+
+/**
+ * @brief Loop seam with the crossfade pre-rendered
+ *
+ * Holds the frames [tailStart, loopEnd) of a sample with the loop crossfade
+ * baked in, padded with guard frames that continue from loopStart. A looping
+ * voice reads the sample up to tailStart and this buffer from there to
+ * loopEnd, so every output sample is a single interpolated read.
+ *
+ * The crossfade blends the loop tail with the material just before loopStart,
+ * so it is limited to loopStart frames (loops starting at frame 0 are hard loops).
+ */
+struct LoopRegion
+{
+    int loopStart = 0;        // frames
+    int loopEnd = 0;          // frames (exclusive)
+    int crossfadeFrames = 0;
+    int tailStart = 0;        // first frame read from this buffer
+    int numChannels = 1;
+
+    std::vector<AudioChannelBuffer> channels;  // Guard-padded frames [tailStart, loopEnd)
+
+    // The seam stored in a packed instrument, used instead of channels when set
+    std::shared_ptr<const MappedFile> mapping;
+    std::array<const float*, 2> mappedChannels {};
+
+    // Frame tailStart of a channel (skips the pre-guard)
+    const float* frames(int channel) const
+    {
+        return (mapping ? mappedChannels[channel] : channels[channel].data()) + Sample::guardFrames;
+    }
+
+    /**
+     * @brief Bake a loop seam for a padded sample (allocates; never call on the audio thread)
+     *
+     * Returns nullptr when the loop window is empty.
+     */
+    static std::shared_ptr<const LoopRegion> create(const Sample& sample, int loopStart,
+                                                    int loopEnd, int crossfadeFrames);
+};
+
+/**
+ * @brief Octave mip levels of a sample
+ *
+ * levels[i] is the sample half-band filtered and decimated i + 1 times, so
+ * frame n of level L lines up with frame n * 2^L of the source. Each level is
+ * a complete padded Sample with the source's root note: a voice transposing
+ * up by more than about a fifth plays a level at 2^-L of its rate, and a short
+ * interpolator then stays inside the band. All levels together take about as
+ * much memory as the source.
+ */
+struct SamplePyramid
+{
+    static constexpr int maxLevels = 8;
+    static constexpr int minLevelFrames = 64;  // Stop decimating below this length
+
+    std::vector<std::shared_ptr<Sample>> levels;
+
+    /**
+     * @brief Build the levels for a padded sample (allocates; never call on the audio thread)
+     *
+     * Returns nullptr when the sample is too short to decimate.
+     */
+    static std::shared_ptr<const SamplePyramid> create(const Sample& sample);
 };
 
 //==============================================================================
@@ -91,6 +317,31 @@ struct ADSREnvelope
     void release();
     double process(double sampleRate, int numSamples);
 
+    /**
+     * @brief Samples left before the envelope leaves its current stage
+     *
+     * Returns 0 once a release has run out (the next process() call
+     * deactivates the envelope) and INT_MAX while sustaining.
+     */
+    int samplesUntilStageChange(double sampleRate) const;
+
+    /**
+     * @brief Render per-sample levels for a span inside the current stage
+     *
+     * Equivalent to calling process(sampleRate, 1) numSamples times, but the
+     * stage and curve are resolved once. numSamples must not exceed
+     * samplesUntilStageChange(). Level is float or double; the envelope state
+     * itself always advances in double.
+     */
+    template <typename Level>
+    void processSpan(double sampleRate, Level* levels, int numSamples);
+
+    // Past attack and hold: the level can only fall or hold from here
+    bool isPastAttack(double sampleRate) const
+    {
+        return isReleased || envelopeTime / sampleRate >= attack + hold;
+    }
+
 private:
     // Apply curve to normalized position (0-1)
     double applyCurve(double t, EnvelopeCurve curve) const;
@@ -139,10 +390,182 @@ struct StateVariableFilter
     double cachedR = 0.0;
     double cachedH = 0.0;
 
+    // Coefficient update rate: smoothing and coefficients advance every
+    // updateInterval blocks (raised by the CPU governor)
+    int updateInterval = 1;
+    int updateCountdown = 0;
+
     void reset();
     void prepare(double sampleRate);
     void setParameters(double cutoff, double resonance);
     void process(float** samples, int numChannels, int numSamples);
+
+    // Block-rate part of process(): smoothing step and the cached g/R/h
+    void advanceCoefficients();
+
+    // Jump to the smoothing targets (a new note has nothing to glide from)
+    void settle()
+    {
+        cutoff = cutoffSmooth;
+        resonance = resonanceSmooth;
+        coefficientsDirty = true;
+    }
+
+    // process() with the per-sample recursion in Real (float or double);
+    // coefficients and the stored state stay double between blocks
+    template <typename Real>
+    void processBlock(float** samples, int numChannels, int numSamples);
+
+    /**
+     * @brief Filter with a per-sample cutoff (audio-rate modulation)
+     *
+     * cutoffHz holds one cutoff per sample and bypasses the cutoff smoother;
+     * resonance and type behave as in process(). Coefficients are recomputed
+     * every sample with the rational tan approximation, so there is no trig call.
+     */
+    template <typename Real>
+    void processModulated(float** samples, int numChannels, int numSamples,
+                          const float* cutoffHz);
+
+    /**
+     * @brief Prewarped integrator gain g = tan(pi * cutoff / sampleRate)
+     *
+     * Rational approximation with reflection about pi/4 (relative error
+     * below 2e-8 in double); cutoff is clamped below Nyquist.
+     */
+    static double cutoffToGain(double cutoff, double sampleRate);
+};
+
+/**
+ * @brief Voice-parallel SVF: filters several voices side by side in SIMD lanes
+ *
+ * Each lane is one channel of a StateVariableFilter (a stereo voice takes
+ * two lanes) with its own coefficients. Filter types are resolved by masking
+ * the four responses per lane, so the sample loop has no branches. Arithmetic
+ * is single precision and matches StateVariableFilter::processBlock<float>.
+ */
+class SvfBank
+{
+public:
+    static constexpr int lanes = 4;
+
+    // Zero input for unused lanes (call off the audio thread)
+    void prepare(int maxBlockSize);
+
+    /**
+     * Advance the filter's coefficients for this block and queue its channels.
+     * They are filtered in place when the bank fills up or on flush(); every
+     * filter added between flushes must use the same numSamples.
+     */
+    void add(StateVariableFilter& filter, float* const* samples, int numChannels, int numSamples);
+
+    // Filter whatever is queued and store the lane states back
+    void flush();
+
+private:
+    struct Lane
+    {
+        StateVariableFilter* filter = nullptr;
+        int channel = 0;
+        float* samples = nullptr;
+    };
+
+    std::array<Lane, lanes> lanes_ {};
+    int numLanes_ = 0;
+    int numSamples_ = 0;
+    AudioChannelBuffer silence_;
+};
+
+//==============================================================================
+// SF2 Modulators
+//==============================================================================
+
+/**
+ * @brief Controller state a part feeds its voices' modulators
+ *
+ * Values are SF2 normalized sources (0-1). version changes with every
+ * update, so voices re-evaluate their programs only when something moved.
+ */
+struct ModulatorInputs
+{
+    std::array<float, 128> controllers {};       // MIDI CCs
+    float channelPressure = 0.0f;
+    float pitchWheel = 0.5f;                     // 0.5 = centered
+    float pitchWheelSensitivity = 2.0f / 127.0f; // Semitones / 127: whole semitones through the default modulator
+    uint32_t version = 0;
+
+    ModulatorInputs();
+
+    // Reset All Controllers (RP-015): volume and pan keep their values
+    void resetControllers();
+};
+
+/**
+ * @brief An SF2 zone's modulators compiled to a flat op program
+ *
+ * Built once at load (SamSamplerSF2.cpp) from the SF2 default modulators
+ * and the zone's imod and pmod lists, or from an SFZ region's opcodes. Ops whose sources are fixed at
+ * note-on (velocity, key) come first and run once per note; the rest run
+ * at control rate. Each op adds amount * source * amountSource to a target.
+ */
+struct ModulatorProgram
+{
+    // Destinations, in the units of the SF2 generators they stand for
+    enum Target
+    {
+        Pitch = 0,              // Cents (fine/coarse tune, pitch wheel)
+        Attenuation,            // Centibels
+        FilterCutoff,           // Cents
+        FilterQ,                // Centibels
+        Pan,                    // 0.1% units, 500 = hard right
+        VibLfoToPitch,          // Cents at full LFO excursion
+        ModLfoToPitch,          // Cents
+        ModLfoToFilterCutoff,   // Cents
+        ModLfoToVolume,         // Centibels (positive is louder at the LFO peak)
+        TargetCount
+    };
+
+    struct Op
+    {
+        uint8_t source = 0;         // SF2 source index; bit 7 selects a MIDI CC
+        uint8_t sourceShape = 0;    // SF2 source flags: direction, polarity, curve type
+        uint8_t amountSource = 0;
+        uint8_t amountShape = 0;
+        uint8_t target = 0;         // Target
+        bool absolute = false;      // Absolute-value transform
+        float amount = 0.0f;
+    };
+
+    // SF2 LFO: a triangle that starts rising from zero after its delay
+    struct Lfo
+    {
+        float delay = 0.001f;       // Seconds
+        float frequency = 8.176f;   // Hz
+
+        float valueAt(double seconds) const;
+    };
+
+    std::vector<Op> ops;
+    int numStatic = 0;              // Leading ops with note-on sources only
+    uint32_t dynamicTargets = 0;    // Bit per Target the control-rate ops reach
+
+    // Zone generator values the ops add to (the LFO depths and filter Q)
+    std::array<float, TargetCount> initial {};
+    Lfo vibLfo;
+    Lfo modLfo;
+
+    bool hasDynamicOps() const { return numStatic < static_cast<int>(ops.size()); }
+    bool isDynamic(Target target) const { return (dynamicTargets >> target) & 1u; }
+
+    // Move the note-on ops first and note the targets the rest reach; call
+    // once the ops are filled in
+    void partition();
+
+    // Add ops [begin, end) into targets (TargetCount values); velocity is 0-1
+    void run(const ModulatorInputs& inputs, int key, float velocity, int begin, int end, float* targets) const;
+
+    // Engine resonance (0-1) for an SF2 filter Q in centibels
+    static double resonanceForQ(double centibels);
 };
 
 //==============================================================================
@@ -160,8 +583,14 @@ public:
     SamSamplerVoice();
     ~SamSamplerVoice() = default;
 
+    // Allocate render scratch for the host block size (call off the audio thread)
+    void prepare(double sampleRate, int maxBlockSize);
+
     // Voice management
     void startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample);
+
+    // Start at pitchCents from the sample's recorded pitch (SF2 zone tuning)
+    void startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample, double pitchCents);
     void stopNote(float velocity);
     bool isActive() const { return isActive_; }
     void reset();
@@ -169,19 +598,130 @@ public:
     // Audio processing
     void process(float** outputs, int numChannels, int numSamples, double sampleRate);
 
+    /**
+     * The three stages of process(), for engines that batch work across voices:
+     * renderBlock() plays the sample into the voice's own buffers (returns
+     * false if nothing was rendered), filterBlock() runs the voice filter, and
+     * mixBlock() retires inaudible voices and accumulates into the bus.
+     */
+    bool renderBlock(int numSamples, double sampleRate);
+    void filterBlock(int numSamples);
+    void mixBlock(float** outputs, int numChannels, int numSamples, double sampleRate);
+
+    // Filtered in single precision: the block's filter can run in an SvfBank
+    // instead of filterBlock() (not while modulation moves it mid-block)
+    bool wantsFilterBank() const
+    {
+        return filterEnabled_ && singlePrecision_ && blockChannels_ > 0 && !modulatesFilter_;
+    }
+    void addToFilterBank(SvfBank& bank, int numSamples);
+
     // Get/set
     int getMidiNote() const { return midiNote_; }
+    float getVelocity() const { return velocity_; }
     double getFrequency() const { return frequency_; }
 
-    // Filter control
+    // Loudness now (envelope level times velocity), for choosing voices to shed
+    double getCurrentGain() const { return envelope_.currentLevel * velocity_; }
+    bool isReleasing() const { return envelope_.isReleased; }
+
+    // Release within releaseSeconds regardless of the release parameter
+    void releaseQuickly(double releaseSeconds);
+
+    /**
+     * Retire the voice once it is inaudible: when its envelope gain times
+     * velocity gain and its output peak are both below threshold (linear).
+     * Only checked past the attack. 0 disables.
+     */
+    void setSilenceThreshold(double threshold) { silenceThreshold_ = threshold; }
+
+    // Filter control (the filter stays on until clearFilter())
     void setFilterParameters(double cutoff, double resonance, FilterType type);
+    void clearFilter() { filterEnabled_ = false; }
+    void setFilterUpdateInterval(int blocks)
+    {
+        filter_.updateInterval = filterRight_.updateInterval = std::max(1, blocks);
+    }
+
+    /**
+     * Stereo enhancement (SamSamplerStereo.cpp). The left channel lags the
+     * right by offsetSeconds (up to maxStereoOffsetSeconds), and with the
+     * filter on the channels are filtered at cutoff * (1 -/+ filterSpread / 2).
+     * Either one turns a mono sample into a two-channel voice. Call after startNote.
+     */
+    static constexpr double maxStereoOffsetSeconds = 0.02;
+    void setStereoEnhancement(double offsetSeconds, double filterSpread);
+
+    /**
+     * Constant-power pan, -1 (left) to 1 (right), applied as a gain matrix as
+     * the voice accumulates into the bus. Center is unity on both sides, so a
+     * hard pan is +3 dB on its side. Stereo voices are balanced. gain scales
+     * both sides (part volume) at no extra cost.
+     */
+    void setPan(double pan, double gain = 1.0);
+
+    /**
+     * Output bus the voice accumulates into: 0 is the main bus, 1 and up the
+     * stereo aux buses (see SamSamplerDSP::setOutputGroup). Set at note-on.
+     */
+    void setOutputBus(int bus) { outputBus_ = bus; }
+    int getOutputBus() const { return outputBus_; }
+
+    // Multi-timbral part (0-15) that started the voice, for note-off and part changes
+    void setPart(int part) { part_ = part; }
+    int getPart() const { return part_; }
+
+    /**
+     * SF2 modulation. Every control period the program's control-rate ops and
+     * the zone LFOs move pitch, level, filter and pan around their note-on
+     * values. noteOn holds the targets at note-on (initial values plus the
+     * static ops): the voice takes the level, pan, filter Q and LFO depths
+     * from it, while pitch and cutoff are already in startNote() and
+     * setFilterParameters(). Call after those; modulateFilter lets the
+     * program drive the voice filter.
+     */
+    void setModulation(const ModulatorProgram& program, const ModulatorInputs& inputs,
+                       const float* noteOn, bool modulateFilter);
+
+    // Samples between modulation updates (16-64)
+    void setControlPeriod(int samples) { controlPeriod_ = std::max(16, std::min(64, samples)); }
 
     // Envelope control
     void setEnvelopeParameters(double attack, double hold, double decay, double sustain, double release,
                                EnvelopeCurve attackCurve, EnvelopeCurve decayCurve, EnvelopeCurve releaseCurve);
 
     // Sample interpolation
-    void setInterpolationQuality(int quality); // 0=linear, 1=cubic
+    enum InterpolationQuality
+    {
+        Linear = 0,
+        Cubic = 1,
+        Sinc8 = 2,      // Polyphase windowed sinc, 8 taps
+        Sinc16 = 3,     // 16 taps
+        Sinc32 = 4      // 32 taps
+    };
+    void setInterpolationQuality(int quality); // InterpolationQuality
+
+    // Loop over the sample's baked loop region, if it has one (call after startNote);
+    // untilRelease leaves the loop at note-off and plays on to the sample end
+    void setLooping(bool shouldLoop, bool untilRelease = false);
+
+    /**
+     * Playhead accumulator mode. Fixed point keeps a 32.32 phase: index and
+     * fraction come from shift and mask, boundaries are found with exact
+     * integer math, and renders are bit-stable regardless of block size or FPU.
+     */
+    void setFixedPointPhase(bool enabled);
+
+    // Play from the sample's mip pyramid when transposing up (applies from the next startNote)
+    void setMipMapping(bool enabled) { mipMapping_ = enabled; }
+
+    /**
+     * Arithmetic precision of the render loops. Single precision runs the
+     * envelope levels, interpolation, gain and filter recursion in float;
+     * the playhead stays double (or 32.32 fixed point) so long notes do not drift.
+     */
+    void setSinglePrecision(bool enabled) { singlePrecision_ = enabled; }
+    bool isSinglePrecision() const { return singlePrecision_; }
 
 private:
     // Voice state
@@ -194,32 +734,132 @@ private:
     std::shared_ptr<Sample> sample_;
     double playPosition_ = 0.0;
     double playbackRate_ = 1.0;
+    double sampleRate_ = 48000.0;   // Engine rate from prepare()
+
+    // 32.32 fixed-point playhead (authoritative when fixedPointPhase_ is set;
+    // playPosition_ then mirrors it)
+    bool fixedPointPhase_ = false;
+
+    // Mip level the current note plays (sample_ then points at that level)
+    bool mipMapping_ = false;
+    int mipLevel_ = 0;
+    uint64_t phase_ = 0;
+    uint64_t phaseIncrement_ = 0;
 
     // Envelope
     ADSREnvelope envelope_;
 
-    // Per-voice filter
+    // Per-voice filter (filterRight_ takes the right channel under filter spread)
     StateVariableFilter filter_;
+    StateVariableFilter filterRight_;
     bool filterEnabled_ = false;
+    double filterCutoff_ = 20000.0;
+    double filterResonance_ = 0.0;
+    bool filterSettling_ = false;   // Set by startNote until the first block renders
+
+    // Output gains for the left/right of each output pair (see setPan)
+    float panGains_[2] = { 1.0f, 1.0f };
+    float outputGain_ = 1.0f;       // Gain alone, for the unpanned mono sum
+    double panPosition_ = 0.0;      // As given to setPan(), before modulation
+    double panGain_ = 1.0;
+    int outputBus_ = 0;
+    int part_ = 0;
+
+    // Stereo enhancement: left-channel delay line (power-of-two ring) and spread
+    std::vector<float> stereoDelayLine_;
+    int stereoDelay_ = 0;
+    int stereoDelayWrite_ = 0;
+    double filterSpread_ = 0.0;
+
+    bool wantsStereo() const { return stereoDelay_ > 0 || (filterEnabled_ && filterSpread_ > 0.0); }
+    bool filterSplit() const { return filterSpread_ > 0.0 && blockChannels_ == 2; }
+    void applyFilterParameters();
+    void renderStereoChannels(int numSamples);
 
     // Interpolation quality
-    int interpolationQuality_ = 1; // 0=linear, 1=cubic
+    int interpolationQuality_ = Cubic;
+    bool singlePrecision_ = SAMSAMPLER_SINGLE_PRECISION != 0;
 
-    // Loop handling
+    // Early retirement of inaudible voices
+    double silenceThreshold_ = 1.5848931924611e-5;   // -96 dBFS
+
+    // Loop handling (seam baked into loopRegion_, captured at note start)
+    std::shared_ptr<const LoopRegion> loopRegion_;
     bool isLooping_ = false;
+    bool loopUntilRelease_ = false;
     double loopStart_ = 0.0;
     double loopEnd_ = 0.0;
-    double loopCrossfade_ = 0.0; // seconds
+    double loopTailStart_ = 0.0;
+
+    // SF2 modulation (see setModulation). A modulated voice renders its
+    // block in control periods, each starting with a program update
+    const ModulatorProgram* modProgram_ = nullptr;
+    const ModulatorInputs* modInputs_ = nullptr;
+    std::array<float, ModulatorProgram::TargetCount> modNoteOn_ {};
+    bool modulated_ = false;
+    bool modulatesFilter_ = false;
+    bool lfoActive_ = false;
+    uint32_t modInputsVersion_ = 0;
+    int controlPeriod_ = 32;
+    double modTime_ = 0.0;          // Seconds since note-on, for the LFOs
+    double modRate_ = 1.0;          // Playback rate at note-on
+    double modPan_ = 0.0;           // Pan offset (-1 to 1) from the program
+    float modNoteOnGain_ = 1.0f;    // Note-on level, folded into the pan gains
+    float modGain_ = 1.0f;          // Control-rate level at the last update
+    double modCutoff_ = 20000.0;    // Filter setting at the last update
+    double modResonance_ = 0.0;
+
+    // Filter settings per control period of the block, for filterBlock()
+    struct FilterTick
+    {
+        float cutoff = 20000.0f;
+        float resonance = 0.0f;
+    };
+    std::vector<FilterTick> filterTicks_;
+    int numFilterTicks_ = 0;
+
+    void updateModulation(int numSamples);
+    void applyPanGains();
+    int renderModulated(float* const* voiceBuffers, int voiceChannels, int numSamples, double sampleRate);
+    void filterModulated(float* const* voiceBuffers, int numSamples);
 
     // Calculate frequency from MIDI note
     double midiToFrequency(int midiNote) const;
 
-    // Interpolation methods
-    double interpolateLinear(double position) const;
-    double interpolateCubic(double position) const;
-
-    // Loop handling with crossfade
-    double processLoopCrossfade(double position, int channel);
+    // Render scratch (sized in prepare(), reused every block); one buffer per
+    // sample channel, so stereo samples render left and right in one pass
+    std::array<std::vector<float>, 2> voiceBuffers_;
+    int blockChannels_ = 0;     // Channels renderBlock() filled this block
+    std::vector<double> envelopeBuffer_;
+    std::vector<float> envelopeBufferFloat_;
+
+    // Interpolation methods for one channel (position is relative to frames)
+    double interpolateLinear(const float* frames, double position) const;
+    double interpolateCubic(const float* frames, double position) const;
+
+    // Output samples that can be rendered before the playhead reaches boundary
+    int samplesUntilPosition(double boundary) const;
+
+    // Playhead tests and loop wrap in whichever accumulator is active
+    bool playheadReached(double boundary) const;
+    void wrapPlayhead();
+
+    // Note start shared by both startNote() forms, around the playback rate
+    void beginNote(int midiNote, float velocity, std::shared_ptr<Sample> sample);
+    void beginPlayback();
+
+    // Boundary-free inner loop: the caller guarantees no loop tail start, loop
+    // end, sample end or envelope stage change falls inside the span.
+    // frames[ch][0] holds the audio of frame `origin` for each sample channel.
+    template <typename Real>
+    void renderSpan(float* const* output, const Real* envelope, int numSamples,
+                    const float* const* frames, double origin);
+
+    // Span loop over the block in Real precision; returns the samples rendered
+    // before the voice finished
+    template <typename Real>
+    int renderSpans(float* const* voiceBuffers, int voiceChannels, int numSamples,
+                    double sampleRate, Real* envelopeLevels);
 };
 
 //==============================================================================
@@ -227,13 +867,33 @@ private:
 //==============================================================================
 
 /**
- * @brief SF2 file parser (simplified for Phase 0)
+ * @brief SF2 and SFZ instrument reader
+ *
+ * Reads the RIFF structure (SamSamplerSF2.cpp) and resolves the preset ->
+ * instrument -> sample generator hierarchy once, at load: each preset
+ * becomes an Instrument whose zones are flat parameter records, so note-on
+ * copies a record instead of evaluating generators. SFZ files
+ * (SamSamplerSFZ.cpp) compile their regions into the same records.
+ *
+ * Packed instruments (SamSamplerPacked.cpp) store those records, the key
+ * index and guard-padded PCM with its loop seams and mip levels, laid out
+ * to be mapped and played as they are: loading one does no parsing,
+ * decoding, resampling or analysis. An SF2 file gets the same tables,
+ * without PCM, as an index cache beside it: reopening it maps the file and
+ * decodes only its sample data.
  */
 class SF2Reader
 {
 public:
     /**
-     * @brief SF2 instrument zone
+     * @brief Flattened SF2 zone
+     *
+     * One record per (preset zone, instrument zone) pair whose ranges
+     * intersect: instrument defaults, the instrument global zone and the
+     * instrument zone, plus the additive preset global and preset zone
+     * generators, already converted to engine units. Linked left/right
+     * sample zones are merged into one zone playing a stereo sample.
+     * An SFZ region, with its global, master and group opcodes, makes one zone.
      */
     struct Zone
     {
@@ -244,10 +904,46 @@ public:
         int sampleIndex = -1;
         int rootKey = 60;
         double tuning = 0.0; // cents
+        int pan = 0;         // SF2 pan generator: 0.1% units, -500 (left) to 500 (right)
+
+        // Set for zones read from a file; the built-in test zone leaves the
+        // engine's own envelope, filter and tuning in charge
+        bool hasGenerators = false;
+
+        float scaleTuning = 100.0f;    // Cents per key
+        float attenuation = 0.0f;      // dB
+
+        // Volume envelope (seconds; sustain as a linear level). Hold and decay
+        // scale by 2^((60 - key) * keyScale / 1200)
+        float envAttack = 0.001f;
+        float envHold = 0.001f;
+        float envDecay = 0.001f;
+        float envSustain = 1.0f;
+        float envRelease = 0.001f;
+        float envHoldKeyScale = 0.0f;  // Timecents per key
+        float envDecayKeyScale = 0.0f;
+
+        // Lowpass filter; filterCutoff at or above filterOpenHz means no filter
+        static constexpr float filterOpenHz = 19000.0f;
+        float filterCutoff = 20000.0f; // Hz
+        float filterResonance = 0.0f;  // Engine resonance (0-1) for the SF2 Q
+        float filterQ = 0.0f;          // SF2 Q (centibels), what modulators add to
+
+        // Loop (frames from the sample start, offsets applied). The zone's
+        // sample always carries these loop points (see Sample::ownLoop)
+        int sampleMode = 0;            // 0 = no loop, 1 = loop, 3 = loop until release
+        int loopStart = 0;
+        int loopEnd = 0;
+
+        // Default, instrument and preset modulators, with the LFOs they scale
+        ModulatorProgram modulators;
+
+        // Cents from the sample's recorded pitch for a MIDI note
+        double pitchCents(int midiNote) const { return (midiNote - rootKey) * scaleTuning + tuning; }
     };
 
     /**
-     * @brief SF2 instrument
+     * @brief SF2 instrument (an SF2 preset with its zones flattened, or an SFZ file)
      */
     struct Instrument
     {
@@ -255,13 +951,51 @@ public:
         int presetNumber = 0;
         int bank = 0;
         std::vector<Zone> zones;
+
+        // Zones covering each key, in zone order: keyZones[keyZoneStart[key]
+        // .. keyZoneStart[key + 1]), so a lookup only visits candidates
+        std::vector<int> keyZoneStart;
+        std::vector<int> keyZones;
     };
 
     /**
-     * @brief Load SF2 file from path
+     * @brief Load SF2 or SFZ file from path
+     *
+     * Files ending in .sfz load as SFZ, .sampack as a packed instrument,
+     * anything else as SF2. An empty path loads a built-in test instrument
+     * (a 440 Hz sine). Returns false, leaving the reader empty, if the file
+     * is not a readable instrument.
+     *
+     * SF2 files load from their index cache (indexCachePath()) when its
+     * size, modification time and content hash still match the file, and
+     * write one after parsing when they don't.
      */
     bool loadFile(const char* filePath);
 
+    /**
+     * @brief Use and write SF2 index caches (on by default)
+     */
+    void setIndexCacheEnabled(bool enabled) { indexCacheEnabled_ = enabled; }
+
+    /**
+     * @brief Check if the last SF2 loaded from its index cache instead of being parsed
+     */
+    bool isLoadedFromIndexCache() const { return loadedFromIndexCache_; }
+
+    /**
+     * @brief Path of the index cache kept beside an SF2 file
+     */
+    static std::string indexCachePath(const char* soundFontPath);
+
+    /**
+     * @brief Write the loaded instruments as a packed instrument (.sampack)
+     *
+     * sampleRate > 0 resamples every sample to that rate first, so an engine
+     * running at it plays the PCM as stored; mipLevels adds the octave levels
+     * mip-mapping plays. Returns false if the file cannot be written.
+     */
+    bool savePacked(const char* filePath, int sampleRate = 0, bool mipLevels = false) const;
+
     /**
      * @brief Get number of instruments
      */
@@ -272,6 +1006,11 @@ public:
      */
     const Instrument* getInstrument(int index) const;
 
+    /**
+     * @brief Get number of samples (zone sampleIndex values index these)
+     */
+    int getSampleCount() const { return static_cast<int>(samples_.size()); }
+
     /**
      * @brief Get sample by index
      */
@@ -282,6 +1021,11 @@ public:
      */
     const Sample* findSample(int instrumentIndex, int midiNote, float velocity) const;
 
+    /**
+     * @brief Find the zone findSample() plays for a MIDI note and velocity (0-127)
+     */
+    const Zone* findZone(int instrumentIndex, int midiNote, float velocity) const;
+
     /**
      * @brief Check if SF2 is loaded
      */
@@ -294,13 +1038,140 @@ public:
     const char* getRomVersion() const { return romVersion_.c_str(); }
 
 private:
+    /**
+     * @brief Sample header (shdr record), frames relative to the smpl chunk
+     */
+    struct SampleHeader
+    {
+        std::string name;
+        uint32_t start = 0;
+        uint32_t end = 0;
+        uint32_t loopStart = 0;
+        uint32_t loopEnd = 0;
+        uint32_t sampleRate = 44100;
+        int originalPitch = 60;
+        int pitchCorrection = 0;       // cents
+        int sampleLink = 0;
+        int sampleType = 1;            // 1 mono, 2 right, 4 left, 8 linked (0x8000 ROM)
+    };
+
     std::string romName_;
     std::string romVersion_;
     std::vector<std::unique_ptr<Sample>> samples_;
+    std::vector<SampleHeader> sampleHeaders_;
     std::vector<Instrument> instruments_;
+    bool indexCacheEnabled_ = true;
+    bool loadedFromIndexCache_ = false;
+
+    void clear();
+    void createTestInstrument();
+    bool parseRIFF(const uint8_t* file, size_t fileSize);
+    bool loadSampleData(const uint8_t* file, size_t smplOffset, size_t smplSize,
+                        size_t sm24Offset, size_t sm24Size);
+    static void decodeFrames(const uint8_t* smpl, const uint8_t* sm24, size_t firstFrame, int numFrames,
+                             float* frames);
+    void mergeStereoZones(Instrument& instrument, std::vector<int>& stereoSampleForLeft);
+    void assignZoneLoops();
+    static void indexZones(Instrument& instrument);
+
+    // SFZ (SamSamplerSFZ.cpp)
+    bool loadSFZ(const char* filePath);
+
+    // Packed instruments and SF2 index caches (SamSamplerPacked.cpp)
+    bool loadPacked(const char* filePath);
+    bool loadIndexCache(const char* soundFontPath, const MappedFile& soundFont);
+    bool saveIndexCache(const char* soundFontPath, const MappedFile& soundFont) const;
+};
+
+//==============================================================================
+// Denormal Protection
+//==============================================================================
+
+/**
+ * @brief Flush-to-zero / denormals-are-zero for the current thread, restored on scope exit
+ *
+ * Decaying filter states and envelope tails otherwise fall into subnormal
+ * range, where every operation can cost 100x. Sets FTZ and DAZ in MXCSR on
+ * x86 and FZ in FPCR/FPSCR on ARM; a no-op elsewhere. The engine scopes
+ * this itself, so hosts calling process() directly need not.
+ */
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals();
+    ~ScopedFlushDenormals();
+
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+private:
+    uint64_t previousState_ = 0;
+};
+
+//==============================================================================
+// Real-Time Worker Pool
+//==============================================================================
+
+/**
+ * @brief Worker threads that split one audio block's work across cores
+ *
+ * Workers are started off the audio thread and pinned one per core. run()
+ * publishes a batch by bumping a generation counter; idle workers spin on it
+ * briefly and then sleep on a futex (a dispatch semaphore on Apple platforms,
+ * a condition variable elsewhere), so back-to-back blocks are picked up
+ * without a syscall. The calling thread takes tasks as well and returns once
+ * every task is done. On Linux and Apple platforms run() neither allocates
+ * nor locks, and the workers run at realtime priority.
+ */
+class RealtimeWorkerPool
+{
+public:
+    using Task = void (*)(void* context, int index);
+
+    static constexpr int maxTasks = 0xFFFF;
+
+    RealtimeWorkerPool() = default;
+    ~RealtimeWorkerPool() { stop(); }
+
+    RealtimeWorkerPool(const RealtimeWorkerPool&) = delete;
+    RealtimeWorkerPool& operator=(const RealtimeWorkerPool&) = delete;
+
+    // Start numWorkers threads besides the caller (never call on the audio thread)
+    void start(int numWorkers);
+    void stop();
 
-    bool parseRIFF(const char* filePath);
-    bool parseChunk(const std::vector<uint8_t>& data, int& offset);
+    int getNumWorkers() const { return static_cast<int>(workers_.size()); }
+
+    // Run task(context, 0..numTasks-1) across the workers and the calling thread
+    void run(int numTasks, Task task, void* context);
+
+private:
+    void workerLoop(int workerIndex);
+    void runTasks(uint32_t generation);
+    uint32_t waitForWork(uint32_t seenGeneration);
+    void wakeWorkers();
+
+    std::vector<std::thread> workers_;
+
+    // Generation (high 32 bits), task count and next task index (16 bits each):
+    // a claim succeeds only while its batch is current
+    std::atomic<uint64_t> work_{0};
+    std::atomic<uint32_t> generation_{0};   // Futex word, mirrors work_'s generation
+    std::atomic<int> remaining_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> exit_{false};
+
+    Task task_ = nullptr;
+    void* context_ = nullptr;
+
+    // Sleep where there is no futex: one semaphore signal per sleeper on
+    // Apple platforms, a condition variable elsewhere
+#if defined(__APPLE__)
+    dispatch_semaphore_t sleepSemaphore_ = nullptr;
+#else
+    std::mutex sleepMutex_;
+    std::condition_variable sleepWake_;
+#endif
 };
 
 //==============================================================================
@@ -355,7 +1226,8 @@ public:
     //==============================================================================
 
     /**
-     * Load SF2 file from path
+     * Load SF2 or SFZ file from path. Replaces the sample cache, so call it
+     * while the engine is not processing (like prepare()).
      */
     bool loadSoundFont(const char* filePath);
 
@@ -379,6 +1251,98 @@ public:
      */
     bool isSoundFontLoaded() const { return sf2Reader_ != nullptr && sf2Reader_->isLoaded(); }
 
+    //==============================================================================
+    // Output Routing
+    //==============================================================================
+
+    /**
+     * With auxOutputs > 0, process() takes the main bus first and then that
+     * many stereo aux buses, in order, as the last 2 * auxOutputs channels.
+     * Channels are written in place, so a host buffer can be handed down as
+     * is. Buses the channel count does not cover fall back to the main bus.
+     */
+    static constexpr int maxAuxOutputs = 16;
+
+    /**
+     * Route notes lowKey..highKey to an output bus (0 = main, 1-16 = aux).
+     * Voices take their bus at note-on, so a kit piece keeps its output
+     * through release even if the routing changes.
+     */
+    void setOutputGroup(int lowKey, int highKey, int bus);
+
+    /**
+     * Route every key back to the main bus
+     */
+    void clearOutputGroups();
+
+    /**
+     * Output bus for a MIDI note (0 = main)
+     */
+    int getOutputGroup(int midiNote) const;
+
+    //==============================================================================
+    // Multi-Timbral Parts
+    //==============================================================================
+
+    /**
+     * With multiTimbral on, each MIDI channel (1-16) is a part with its own
+     * SF2 instrument, volume and pan. Parts share the one voice pool and
+     * sample cache. With it off the channel is ignored and every note plays
+     * the selected instrument, as through handleEvent().
+     */
+    static constexpr int numParts = 16;
+
+    void noteOn(int midiNote, float velocity, int midiChannel = 1);
+    void noteOff(int midiNote, float velocity = 0.0f, int midiChannel = 1);
+
+    /**
+     * CC 7 (volume) and CC 10 (pan) set the channel's part, value 0-1.
+     * Sounding voices of the part follow at once. Every controller also
+     * feeds the SF2 modulators of the part's voices; CC 121 resets them.
+     */
+    void controlChange(int controller, float value, int midiChannel = 1);
+
+    /**
+     * Pitch wheel (-1 to 1) and channel pressure (0-1) of a channel's part.
+     * They reach SF2 voices through the zone modulators: the default pitch
+     * wheel modulator bends by pitchBendRange semitones.
+     */
+    void pitchBend(float value, int midiChannel = 1);
+    void channelPressure(float pressure, int midiChannel = 1);
+
+    /**
+     * Part settings by MIDI channel (1-16): instrument index, volume (0-1
+     * linear gain) and pan (-1 to 1, added to the global pan)
+     */
+    bool setPartInstrument(int midiChannel, int instrumentIndex);
+    void setPartVolume(int midiChannel, float volume);
+    void setPartPan(int midiChannel, float pan);
+    int getPartInstrument(int midiChannel) const;
+    float getPartVolume(int midiChannel) const;
+    float getPartPan(int midiChannel) const;
+
+    /**
+     * Re-bake loop regions for every cached sample from the current loop
+     * parameters. Runs on the caller's thread (never the audio thread);
+     * loop parameter changes schedule this on the sample build thread.
+     */
+    void rebuildLoopRegions();
+
+    /**
+     * Build (or release) the mip pyramids of every cached sample to match the
+     * mipMapping parameter. Runs on the caller's thread (never the audio
+     * thread); toggling the parameter schedules this on the sample build thread.
+     */
+    void rebuildSamplePyramids();
+
+    /**
+     * Convert every cached sample to the engine rate (or back to its native
+     * rate when resampleOnLoad is off) on a pool of worker threads. Only
+     * samples not already at the wanted rate are converted, so this is cheap
+     * to repeat; prepare() calls it whenever the host rate changes.
+     */
+    void resampleSamples();
+
     //==============================================================================
     // Internal Methods
     //==============================================================================
@@ -394,8 +1358,78 @@ private:
     // Find free voice or steal oldest
     SamSamplerVoice* findFreeVoice();
 
-    // Find active voice by MIDI note
-    SamSamplerVoice* findVoiceForNote(int midiNote);
+    // Voice rendering runs in stages: every active voice renders into its
+    // own buffers (on the pool when there are workers), filters are banked
+    // across voices, then the audio thread mixes in voice order, so the mix
+    // is the same bit for bit however the work was split
+    RealtimeWorkerPool renderPool_;
+    SvfBank filterBank_;
+    std::array<int, maxVoices_> activeVoiceIndices_ {};
+    int renderSamples_ = 0;
+
+    void renderVoices(float** outputs, int numChannels, int numSamples);
+
+    // Output routing: bus per key (0 = main), and the aux buses a block of
+    // numChannels actually carries
+    std::array<std::uint8_t, 128> outputGroups_ {};
+    int auxOutputCount(int numChannels) const;
+    static void renderVoiceTask(void* context, int index);
+    bool renderVoicesParallel(int numActive, int numSamples);
+
+    //==============================================================================
+    // CPU Governor
+    //==============================================================================
+
+    // Degradation steps, cheapest loss first. Each pressured block moves one
+    // step down; a sustained run of blocks with headroom moves one step back up.
+    enum GovernorLevel
+    {
+        GovernorFull = 0,
+        GovernorCubic,          // Interpolation capped at cubic
+        GovernorLinear,         // Interpolation capped at linear
+        GovernorFilterRate,     // Filter coefficients updated every few blocks
+        GovernorPolyphony       // Quietest voice released on every pressured block
+    };
+
+    int governorLevel_ = GovernorFull;
+    double governorLoad_ = 0.0;          // Last render time / block duration
+    int governorHeadroomBlocks_ = 0;
+    int governorVoiceLimit_ = maxVoices_;
+
+    void updateGovernor(double renderSeconds, int numSamples);
+    void applyGovernorLevel();
+    void releaseQuietestVoice();
+
+    // Find active voice by MIDI note (and part, in multi-timbral mode)
+    SamSamplerVoice* findVoiceForNote(int midiNote, int part = 0);
+
+    //==============================================================================
+    // Multi-Timbral Parts
+    //==============================================================================
+
+    struct Part
+    {
+        int instrument = 0;           // SF2 instrument index
+        double volume = 1.0;          // Linear gain
+        double pan = 0.0;             // -1 to 1, added to the global pan
+        ModulatorInputs inputs;       // Controllers its voices' SF2 modulators read
+    };
+
+    std::array<Part, numParts> parts_ {};
+
+    // Part for a MIDI channel (1-16); always part 0 unless multi-timbral
+    int partForChannel(int midiChannel) const;
+    int partInstrument(int part) const;
+    double partVolume(int part) const;
+
+    void startVoice(int midiNote, float velocity, int part);
+
+    // Pitch wheel sensitivity source of every part, from pitchBendRange
+    void applyPitchBendRange();
+
+    // Output gain at note-on: part volume and the SF2 zone attenuation
+    double voiceGain(const SF2Reader::Zone* zone, int part) const;
+    void updatePartVoices(int part);
 
     //==============================================================================
     // Parameters
@@ -415,6 +1449,16 @@ private:
         double loopStart = 0.0;
         double loopEnd = 1.0;
         double crossfade = 0.01;      // Loop crossfade (seconds)
+        bool fixedPointPhase = false; // 32.32 fixed-point playhead (bit-stable renders)
+        bool singlePrecision = SAMSAMPLER_SINGLE_PRECISION != 0; // Float render loops (see SamSamplerVoice::setSinglePrecision)
+        bool filterBank = true;       // Run single-precision voice filters four at a time in SIMD lanes
+        int interpolationQuality = SamSamplerVoice::Cubic; // Voice interpolator (0-4, see InterpolationQuality)
+        bool mipMapping = false;      // Octave mip levels for upward transposition (+100% sample memory)
+        bool resampleOnLoad = false;  // Convert samples to the engine rate (root key plays as a copy)
+        int renderThreads = 0;        // Voice render workers besides the audio thread (applied by prepare())
+        double silenceThreshold = -96.0; // dBFS below which inaudible voices retire (-160 disables)
+        bool cpuGovernor = false;     // Trade quality for deadline safety under load
+        double cpuBudget = 0.7;       // Fraction of the block period a render may take before degrading (0 = always degraded)
 
         // Amplitude envelope (global, affects all voices)
         double envAttack = 0.01;
@@ -445,10 +1489,23 @@ private:
         // 1.0 = complex, rich (sample variation, filter modulation, envelope shaping)
         double structure = 0.5;
 
-        // Stereo Enhancement
-        double stereoWidth = 0.5f;     // 0=mono, 1=full stereo
-        double stereoPositionOffset = 0.0; // Sample position offset between channels (0-1)
-        double stereoFilterSpread = 0.1f;  // Filter cutoff spread between channels
+        // Stereo Enhancement (defaults leave the signal untouched)
+        double stereoWidth = 1.0;      // 0=mono, 1=full stereo
+        double stereoPositionOffset = 0.0; // Left-channel lag, 0-1 of SamSamplerVoice::maxStereoOffsetSeconds
+        double stereoFilterSpread = 0.0;   // Filter cutoff spread between channels
+
+        // Panning (per voice, taken at note-on; SF2 zone pan adds to it)
+        double pan = 0.0;             // -1 (left) to 1 (right), constant power
+        double panKeySpread = 0.0;    // Key-tracked pan: +/- this much 64 keys either side of middle C
+
+        // Multi-timbral: one part per MIDI channel (see SamSamplerDSP::noteOn)
+        bool multiTimbral = false;
+
+        // SF2 modulators
+        int controlPeriod = 32;       // Samples between modulator updates (16-64)
+
+        // Output routing
+        int auxOutputs = 0;           // Stereo aux buses after the main bus in process() (0-16, see setOutputGroup)
 
     } params_;
 
@@ -464,8 +1521,42 @@ private:
     std::unique_ptr<SF2Reader> sf2Reader_;
     int currentSoundFontInstrument_ = 0;
 
-    // Sample cache (for shared ownership with voices)
+    // Sample cache (for shared ownership with voices). Entries are replaced
+    // off the audio thread; read them through std::atomic_load
     std::vector<std::shared_ptr<Sample>> sampleCache_;
+    std::vector<std::shared_ptr<const Sample>> nativeSamples_;  // As loaded, parallel to sampleCache_
+
+    //==============================================================================
+    // Sample Build Thread
+    //==============================================================================
+
+    // Loop baking runs here so the audio thread never allocates or renders
+    // seams. The audio thread only raises flags; the thread polls them.
+    std::thread sampleBuildThread_;
+    std::mutex sampleBuildMutex_;        // Guards sampleCache_ against the build thread
+    std::condition_variable sampleBuildWake_;
+    std::atomic<bool> sampleBuildExit_{false};
+    std::atomic<bool> loopRegionsDirty_{false};
+    std::atomic<bool> pyramidsDirty_{false};
+    std::atomic<bool> requestedMipMapping_{false};
+    std::atomic<bool> resampleDirty_{false};
+    std::atomic<bool> requestedResampling_{false};
+    std::atomic<int> requestedSampleRate_{48000};
+
+    // Loop window last requested through setParameter()
+    std::atomic<float> requestedLoopStart_{0.0f};
+    std::atomic<float> requestedLoopEnd_{1.0f};
+    std::atomic<float> requestedCrossfade_{0.01f};
+
+    void startSampleBuildThread();
+    void stopSampleBuildThread();
+    void sampleBuildLoop();
+    void requestLoopRebuild();
+    void rebuildLoopRegionsLocked();
+    void rebuildSamplePyramidsLocked();
+    std::shared_ptr<const SamplePyramid> nativePyramid(size_t index, const Sample& sample) const;
+    void resampleSamplesLocked();
+    void bakeLoopRegion(Sample& sample) const;
 
     //==============================================================================
     // Helper Methods
@@ -475,7 +1566,10 @@ private:
     void applyParameters(SamSamplerVoice& voice);
 
     // Audio processing helpers
-    void processStereoSample(float& left, float& right, double phase);
+    void applyStereoWidth(float** outputs, int numChannels, int numSamples);
+
+    // Note-on pan: global and part pan, key-tracked spread and the SF2 zone pan generator
+    double voicePan(int midiNote, float velocity, int part) const;
     void applyFilter(float** samples, int numChannels, int numSamples);
     void applyEffects(float** samples, int numChannels, int numSamples);
 
@@ -53,7 +53,7 @@ public:
 
         addParameter (structureParam = new juce::AudioParameterFloat ("structure", "Structure", 0.0f, 1.0f, 0.5f));
 
-        addParameter (stereoWidthParam = new juce::AudioParameterFloat ("stereoWidth", "Stereo Width", 0.0f, 1.0f, 0.5f));
+        addParameter (stereoWidthParam = new juce::AudioParameterFloat ("stereoWidth", "Stereo Width", 0.0f, 1.0f, 1.0f));
 
         // Load factory presets
         loadFactoryPresets();
@@ -265,7 +265,7 @@ public:
                 *delayMixParam = state.getProperty ("delay", 0.0f);
                 *driveParam = state.getProperty ("drive", 0.0f);
                 *structureParam = state.getProperty ("structure", 0.5f);
-                *stereoWidthParam = state.getProperty ("stereoWidth", 0.5f);
+                *stereoWidthParam = state.getProperty ("stereoWidth", 1.0f);
 
                 currentPresetIndex = state.getProperty ("preset", 0);
 
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    SamSamplerByteOrder.h
+    Little-endian field readers shared by the instrument file parsers
+    (internal to src/dsp, not part of the public header)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace DSP {
+
+// RIFF, SF2 and WAV fields are little-endian whatever the host order; p need
+// not be aligned
+inline uint16_t readU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline int16_t readS16(const uint8_t* p) { return static_cast<int16_t>(readU16(p)); }
+inline uint32_t readU32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace DSP
@@ -26,9 +26,332 @@
 #include <iomanip>
 #include <algorithm>
 #include <fstream>
+#include <chrono>
+#include <functional>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+    #include <mach/mach_time.h>
+    #include <mach/thread_policy.h>
+    #include <pthread.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define SAMSAMPLER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SAMSAMPLER_NEON 1
+#endif
 
 namespace DSP {
 
+//==============================================================================
+// Sample Implementation
+//==============================================================================
+
+void Sample::setInterleaved(const float* interleaved, int numFrames, int channelCount)
+{
+    numSamples = std::max(0, numFrames);
+    numChannels = std::max(1, channelCount);
+    guarded = false;
+
+    channels.assign(static_cast<size_t>(numChannels), AudioChannelBuffer(static_cast<size_t>(numSamples)));
+    for (int i = 0; i < numSamples; ++i)
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] = interleaved[static_cast<size_t>(i) * numChannels + ch];
+}
+
+void Sample::addGuardFrames()
+{
+    if (guarded || numSamples <= 0 || numChannels <= 0
+        || static_cast<int>(channels.size()) != numChannels)
+        return;
+
+    for (auto& channel : channels)
+    {
+        AudioChannelBuffer padded(static_cast<size_t>(numSamples + 2 * guardFrames), 0.0f);
+        std::copy(channel.begin(), channel.begin() + std::min(channel.size(), static_cast<size_t>(numSamples)),
+                  padded.begin() + guardFrames);
+
+        // A loop that ends on the last frame continues into its start
+        if (loopEnd == numSamples && loopEnd > loopStart)
+        {
+            const int loopLength = loopEnd - loopStart;
+            for (int i = 0; i < guardFrames; ++i)
+                padded[guardFrames + numSamples + i] = padded[guardFrames + loopStart + i % loopLength];
+        }
+
+        channel.swap(padded);
+    }
+
+    guarded = true;
+}
+
+namespace {
+
+/**
+ * Kaiser-windowed sinc for offline resampling, tabulated over the distance
+ * from the kernel centre in zero crossings: entry i is the kernel at
+ * i / resampleTableResolution, out to resampleZeroCrossings.
+ */
+constexpr int resampleZeroCrossings = 32;
+constexpr int resampleTableResolution = 512;
+
+const std::vector<double>& resampleKernel()
+{
+    static const std::vector<double> table = [] {
+        const double beta = 9.0;
+        auto besselI0 = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 40; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+
+        std::vector<double> result(resampleZeroCrossings * resampleTableResolution + 2, 0.0);
+        for (int i = 0; i <= resampleZeroCrossings * resampleTableResolution; ++i)
+        {
+            const double t = static_cast<double>(i) / resampleTableResolution;
+            const double r = t / resampleZeroCrossings;
+            const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+            result[i] = (i == 0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t)) * window;
+        }
+        return result;
+    }();
+    return table;
+}
+
+} // namespace
+
+std::shared_ptr<Sample> Sample::resampledLayout(int targetRate) const
+{
+    if (!isValid() || targetRate <= 0)
+        return nullptr;
+
+    const double ratio = static_cast<double>(targetRate) / sampleRate;
+    auto target = std::make_shared<Sample>();
+    target->numChannels = numChannels;
+    target->sampleRate = targetRate;
+    target->numSamples = std::max(1, static_cast<int>(std::ceil(numSamples * ratio)));
+    target->rootNote = rootNote;
+    target->pitchCorrection = pitchCorrection;
+    target->loopStart = static_cast<int>(std::lround(loopStart * ratio));
+    target->loopEnd = loopEnd == numSamples ? target->numSamples
+                                            : static_cast<int>(std::lround(loopEnd * ratio));
+    target->ownLoop = ownLoop;
+    target->channels.assign(static_cast<size_t>(numChannels),
+                            AudioChannelBuffer(static_cast<size_t>(target->numSamples), 0.0f));
+    return target;
+}
+
+void Sample::renderResampled(Sample& target, int channel, int begin, int end) const
+{
+    const auto& kernel = resampleKernel();
+    const double step = static_cast<double>(sampleRate) / target.sampleRate;   // Source frames per output frame
+    const double cutoff = std::min(1.0, 1.0 / step);                           // Band-limit when decimating
+    const double reach = resampleZeroCrossings / cutoff;                         // Source frames either side
+    const float* source = frames(channel);
+    float* output = target.channels[channel].data();
+
+    for (int n = begin; n < end; ++n)
+    {
+        const double centre = n * step;
+        const int first = std::max(0, static_cast<int>(std::ceil(centre - reach)));
+        const int last = std::min(numSamples - 1, static_cast<int>(std::floor(centre + reach)));
+
+        double sum = 0.0;
+        for (int k = first; k <= last; ++k)
+        {
+            const double t = std::abs(centre - k) * cutoff * resampleTableResolution;
+            const int index = static_cast<int>(t);
+            const double frac = t - index;
+            sum += source[k] * (kernel[index] + frac * (kernel[index + 1] - kernel[index]));
+        }
+
+        output[n] = static_cast<float>(sum * cutoff);
+    }
+}
+
+std::shared_ptr<const LoopRegion> LoopRegion::create(const Sample& sample, int loopStart,
+                                                     int loopEnd, int crossfadeFrames)
+{
+    if (!sample.isValid())
+        return nullptr;
+
+    loopStart = std::max(0, std::min(loopStart, sample.numSamples - 1));
+    loopEnd = std::max(0, std::min(loopEnd, sample.numSamples));
+    if (loopEnd - loopStart < 1)
+        return nullptr;
+
+    const int guard = Sample::guardFrames;
+    const int loopLength = loopEnd - loopStart;
+    const int fade = std::max(0, std::min(crossfadeFrames, std::min(loopStart, loopLength)));
+
+    // Start the tail far enough ahead of the fade that no interpolator reading
+    // the untouched sample reaches into baked frames. Short loops live here whole.
+    int tailStart = loopEnd - fade - guard;
+    if (tailStart <= loopStart + guard)
+        tailStart = loopStart;
+    tailStart = std::max(0, tailStart);
+
+    auto region = std::make_shared<LoopRegion>();
+    region->loopStart = loopStart;
+    region->loopEnd = loopEnd;
+    region->crossfadeFrames = fade;
+    region->tailStart = tailStart;
+    region->numChannels = sample.numChannels;
+
+    const int fadeStart = loopEnd - fade;
+    const int firstFrame = tailStart - guard;
+    const int numFrames = (loopEnd + guard) - firstFrame;
+    region->channels.assign(static_cast<size_t>(sample.numChannels),
+                            AudioChannelBuffer(static_cast<size_t>(numFrames), 0.0f));
+
+    for (int ch = 0; ch < sample.numChannels; ++ch)
+    {
+        const float* source = sample.frames(ch);
+
+        // The looped signal as a voice hears it: reads past loopEnd continue from
+        // loopStart, and the fade blends the tail into the pre-loop material
+        auto loopedFrame = [&](int frame) -> float {
+            if (frame >= loopEnd)
+                frame = loopStart + (frame - loopEnd) % loopLength;
+            if (frame < -guard)
+                return 0.0f;
+            if (frame < fadeStart)
+                return source[frame];
+
+            double amount = static_cast<double>(frame - fadeStart) / fade;
+            double tail = source[frame];
+            double preLoop = source[loopStart - (loopEnd - frame)];
+            return static_cast<float>(tail * (1.0 - amount) + preLoop * amount);
+        };
+
+        for (int i = 0; i < numFrames; ++i)
+            region->channels[ch][i] = loopedFrame(firstFrame + i);
+    }
+
+    return region;
+}
+
+namespace {
+
+/**
+ * Kaiser-windowed half-band lowpass, odd taps only: h[0] is 0.5 and the even
+ * taps are zero. halfBandTaps[j] is h[2j + 1] (and h[-(2j + 1)]).
+ */
+constexpr int halfBandOddTaps = 16;
+
+const std::array<double, halfBandOddTaps>& halfBandTaps()
+{
+    static const std::array<double, halfBandOddTaps> taps = [] {
+        const double beta = 8.0;
+        const double halfWidth = 2.0 * halfBandOddTaps;
+
+        auto besselI0 = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+
+        std::array<double, halfBandOddTaps> result {};
+        double sum = 0.5;
+        for (int j = 0; j < halfBandOddTaps; ++j)
+        {
+            const double k = 2.0 * j + 1.0;
+            const double r = k / halfWidth;
+            const double window = besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+            result[j] = std::sin(M_PI * k / 2.0) / (M_PI * k) * window;
+            sum += 2.0 * result[j];
+        }
+
+        // Unity DC gain
+        for (auto& tap : result)
+            tap /= sum;
+        return result;
+    }();
+    return taps;
+}
+
+// Half-band filter and decimate one channel: output frame n is centred on input frame 2n
+void decimateChannel(const float* input, int numFrames, float* output, int outputFrames)
+{
+    const auto& taps = halfBandTaps();
+    const int reach = 2 * halfBandOddTaps - 1;
+
+    auto at = [&](int frame) -> double {
+        return (frame >= 0 && frame < numFrames) ? input[frame] : 0.0;
+    };
+
+    for (int n = 0; n < outputFrames; ++n)
+    {
+        const int centre = 2 * n;
+        double sum = 0.5 * at(centre);
+
+        if (centre - reach >= 0 && centre + reach < numFrames)
+        {
+            for (int j = 0; j < halfBandOddTaps; ++j)
+                sum += taps[j] * (static_cast<double>(input[centre - 2 * j - 1]) + input[centre + 2 * j + 1]);
+        }
+        else
+        {
+            for (int j = 0; j < halfBandOddTaps; ++j)
+                sum += taps[j] * (at(centre - 2 * j - 1) + at(centre + 2 * j + 1));
+        }
+
+        output[n] = static_cast<float>(sum);
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const SamplePyramid> SamplePyramid::create(const Sample& sample)
+{
+    if (!sample.isValid() || sample.numSamples / 2 < minLevelFrames)
+        return nullptr;
+
+    auto pyramid = std::make_shared<SamplePyramid>();
+    const Sample* source = &sample;
+
+    while (static_cast<int>(pyramid->levels.size()) < maxLevels && source->numSamples / 2 >= minLevelFrames)
+    {
+        auto level = std::make_shared<Sample>();
+        level->numChannels = source->numChannels;
+        level->sampleRate = std::max(1, source->sampleRate / 2);
+        level->numSamples = (source->numSamples + 1) / 2;
+        level->rootNote = source->rootNote;
+        level->pitchCorrection = source->pitchCorrection;
+        level->loopStart = source->loopStart / 2;
+        level->loopEnd = source->loopEnd == source->numSamples ? level->numSamples : source->loopEnd / 2;
+        level->ownLoop = source->ownLoop;
+
+        level->channels.assign(static_cast<size_t>(level->numChannels),
+                               AudioChannelBuffer(static_cast<size_t>(level->numSamples)));
+        for (int ch = 0; ch < level->numChannels; ++ch)
+            decimateChannel(source->frames(ch), source->numSamples, level->channels[ch].data(), level->numSamples);
+
+        level->addGuardFrames();
+        pyramid->levels.push_back(level);
+        source = level.get();
+    }
+
+    return pyramid;
+}
+
 //==============================================================================
 // Enhanced ADSR Envelope Implementation
 //==============================================================================
@@ -140,10 +463,176 @@ double ADSREnvelope::process(double sampleRate, int numSamples)
     return currentLevel;
 }
 
+namespace {
+
+// Count k >= 0 with (envelopeTime + k) / sampleRate < boundary, using the
+// same expression process() evaluates so span edges match it bit for bit
+int samplesBeforeTime(double boundary, double envelopeTime, double sampleRate)
+{
+    double estimate = std::ceil(boundary * sampleRate - envelopeTime);
+    if (estimate <= 0.0)
+        return 0;
+    if (estimate >= static_cast<double>(INT_MAX / 2))
+        return INT_MAX;
+
+    int count = static_cast<int>(estimate);
+    while (count > 0 && (envelopeTime + (count - 1)) / sampleRate >= boundary)
+        --count;
+    while ((envelopeTime + count) / sampleRate < boundary)
+        ++count;
+    return count;
+}
+
+// Curve shapes resolved at compile time so span loops carry no switch
+template <EnvelopeCurve Curve>
+inline double shapeCurve(double t)
+{
+    if constexpr (Curve == EnvelopeCurve::Linear)
+        return t;
+    else if constexpr (Curve == EnvelopeCurve::Exponential)
+        return std::pow(t, 2.0);
+    else if constexpr (Curve == EnvelopeCurve::Logarithmic)
+        return std::sqrt(t);
+    else
+        return (1.0 - std::cos(t * M_PI)) / 2.0;
+}
+
+template <typename SpanFn>
+void dispatchCurve(EnvelopeCurve curve, SpanFn&& fn)
+{
+    switch (curve)
+    {
+        case EnvelopeCurve::Linear:      fn([](double t) { return shapeCurve<EnvelopeCurve::Linear>(t); }); break;
+        case EnvelopeCurve::Exponential: fn([](double t) { return shapeCurve<EnvelopeCurve::Exponential>(t); }); break;
+        case EnvelopeCurve::Logarithmic: fn([](double t) { return shapeCurve<EnvelopeCurve::Logarithmic>(t); }); break;
+        case EnvelopeCurve::SCurve:      fn([](double t) { return shapeCurve<EnvelopeCurve::SCurve>(t); }); break;
+        default:                         fn([](double t) { return t; }); break;
+    }
+}
+
+} // namespace
+
+int ADSREnvelope::samplesUntilStageChange(double sampleRate) const
+{
+    if (!isActive)
+        return 0;
+
+    double time = envelopeTime / sampleRate;
+
+    if (isReleased)
+        return samplesBeforeTime(releaseTime, envelopeTime, sampleRate);
+
+    if (time < attack)
+        return samplesBeforeTime(attack, envelopeTime, sampleRate);
+    if (time < (attack + hold))
+        return samplesBeforeTime(attack + hold, envelopeTime, sampleRate);
+    if (time < (attack + hold + decay))
+        return samplesBeforeTime(attack + hold + decay, envelopeTime, sampleRate);
+
+    return INT_MAX;
+}
+
+template <typename Level>
+void ADSREnvelope::processSpan(double sampleRate, Level* levels, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (!isActive)
+    {
+        currentLevel = 0.0;
+        std::fill(levels, levels + numSamples, Level(0));
+        return;
+    }
+
+    double time = envelopeTime / sampleRate;
+
+    // Levels are computed in double and only narrowed on store, so currentLevel
+    // (and the release that starts from it) is identical at either precision
+    if (isReleased)
+    {
+        dispatchCurve(releaseCurve, [&](auto shape) {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double t = (envelopeTime / sampleRate) / releaseTime;
+                currentLevel = currentLevel * shape(1.0 - t);
+                levels[i] = static_cast<Level>(currentLevel);
+                envelopeTime += 1.0;
+            }
+        });
+    }
+    else if (time < attack)
+    {
+        dispatchCurve(attackCurve, [&](auto shape) {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double t = (envelopeTime / sampleRate) / attack;
+                currentLevel = shape(t);
+                levels[i] = static_cast<Level>(currentLevel);
+                envelopeTime += 1.0;
+            }
+        });
+    }
+    else if (time < (attack + hold))
+    {
+        std::fill(levels, levels + numSamples, Level(1));
+        envelopeTime += static_cast<double>(numSamples);
+        currentLevel = 1.0;
+    }
+    else if (time < (attack + hold + decay))
+    {
+        dispatchCurve(decayCurve, [&](auto shape) {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double t = ((envelopeTime / sampleRate) - attack - hold) / decay;
+                currentLevel = sustain + (1.0 - sustain) * shape(1.0 - t);
+                levels[i] = static_cast<Level>(currentLevel);
+                envelopeTime += 1.0;
+            }
+        });
+    }
+    else
+    {
+        std::fill(levels, levels + numSamples, static_cast<Level>(sustain));
+        envelopeTime += static_cast<double>(numSamples);
+        currentLevel = sustain;
+    }
+}
+
+template void ADSREnvelope::processSpan<float>(double, float*, int);
+template void ADSREnvelope::processSpan<double>(double, double*, int);
+
 //==============================================================================
 // State Variable Filter Implementation
 //==============================================================================
 
+namespace {
+
+// Highest cutoff relative to the sample rate; tan() has its pole at Nyquist
+constexpr double maxCutoffRatio = 0.49;
+
+// tan(x) for 0 <= x < pi/2: [7/6] Pade approximant on [0, pi/4], reflected
+// through tan(x) = 1 / tan(pi/2 - x) above it. No branches beyond a select.
+template <typename Real>
+inline Real tanApprox(Real x)
+{
+    const bool reflect = x > Real(0.78539816339744830962);
+    const Real y = reflect ? Real(1.57079632679489661923) - x : x;
+    const Real y2 = y * y;
+
+    const Real t = y * (Real(945) - Real(105) * y2 + y2 * y2)
+                 / (Real(945) - Real(420) * y2 + Real(15) * y2 * y2);
+    return reflect ? Real(1) / t : t;
+}
+
+} // namespace
+
+double StateVariableFilter::cutoffToGain(double cutoff, double sampleRate)
+{
+    cutoff = std::min(cutoff, maxCutoffRatio * sampleRate);
+    return tanApprox(M_PI * cutoff / sampleRate);
+}
+
 void StateVariableFilter::reset()
 {
     s1[0] = s1[1] = 0.0;
@@ -155,7 +644,7 @@ void StateVariableFilter::reset()
 
 void StateVariableFilter::prepare(double sampleRate)
 {
-    sampleRate = sampleRate;
+    this->sampleRate = sampleRate;
     reset();
 }
 
@@ -172,55 +661,69 @@ void StateVariableFilter::setParameters(double cutoff, double resonance)
 
 void StateVariableFilter::process(float** samples, int numChannels, int numSamples)
 {
-    // Smooth parameter changes
-    cutoff = cutoff + (cutoffSmooth - cutoff) * (1.0 - smoothingCoeff);
-    resonance = resonance + (resonanceSmooth - resonance) * (1.0 - smoothingCoeff);
+    processBlock<double>(samples, numChannels, numSamples);
+}
+
+void StateVariableFilter::advanceCoefficients()
+{
+    // Smooth parameter changes (every updateInterval blocks)
+    if (--updateCountdown <= 0)
+    {
+        updateCountdown = updateInterval;
+        cutoff = cutoff + (cutoffSmooth - cutoff) * (1.0 - smoothingCoeff);
+        resonance = resonance + (resonanceSmooth - resonance) * (1.0 - smoothingCoeff);
+    }
 
     // Clamp values
     cutoff = std::max(20.0, std::min(20000.0, cutoff));
     resonance = std::max(0.0, std::min(1.0, resonance));
 
     // Only calculate coefficients if parameters changed
-    double g, R, h;
     if (coefficientsDirty)
     {
         // Calculate filter coefficients (TPT topology)
-        g = std::tan(M_PI * cutoff / sampleRate);
-        R = 1.0 - (resonance * 0.99);  // Q = 1/R, range 0.5 to 100
-        h = 1.0 / (1.0 + g * (2.0 * R + g));
+        const double g = cutoffToGain(cutoff, sampleRate);
+        const double R = 1.0 - (resonance * 0.99);  // Q = 1/R, range 0.5 to 100
 
         // Cache the coefficients
         cachedG = g;
         cachedR = R;
-        cachedH = h;
+        cachedH = 1.0 / (1.0 + g * (2.0 * R + g));
         coefficientsDirty = false;
     }
-    else
-    {
-        // Use cached coefficients
-        g = cachedG;
-        R = cachedR;
-        h = cachedH;
-    }
+}
+
+template <typename Real>
+void StateVariableFilter::processBlock(float** samples, int numChannels, int numSamples)
+{
+    advanceCoefficients();
+
+    const Real g = static_cast<Real>(cachedG);
+    const Real h = static_cast<Real>(cachedH);
+    const Real feedback = static_cast<Real>(2.0 * cachedR + cachedG);
+
+    // Recursion runs on Real copies of the state, stored back once per block
+    Real z1[2] = { static_cast<Real>(s1[0]), static_cast<Real>(s1[1]) };
+    Real z2[2] = { static_cast<Real>(s2[0]), static_cast<Real>(s2[1]) };
 
     // Process each sample
     for (int i = 0; i < numSamples; ++i)
     {
         for (int ch = 0; ch < numChannels; ++ch)
         {
-            double input = static_cast<double>(samples[ch][i]);
+            const Real input = static_cast<Real>(samples[ch][i]);
 
             // TPT State Variable Filter
-            double highpass = (input - (1.0 + g * 2.0 * R) * s1[ch] - g * g * s2[ch]) * h;
-            double bandpass = g * highpass + s1[ch];
-            double lowpass = g * bandpass + s2[ch];
+            const Real highpass = (input - feedback * z1[ch] - z2[ch]) * h;
+            const Real bandpass = g * highpass + z1[ch];
+            const Real lowpass = g * bandpass + z2[ch];
 
             // Update states
-            s1[ch] = 2.0 * bandpass - s1[ch];
-            s2[ch] = 2.0 * lowpass - s2[ch];
+            z1[ch] = Real(2) * bandpass - z1[ch];
+            z2[ch] = Real(2) * lowpass - z2[ch];
 
             // Select output based on filter type
-            double output = 0.0;
+            Real output = 0;
             switch (type)
             {
                 case FilterType::Lowpass:
@@ -240,177 +743,830 @@ void StateVariableFilter::process(float** samples, int numChannels, int numSampl
             samples[ch][i] = static_cast<float>(output);
         }
     }
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        s1[ch] = static_cast<double>(z1[ch]);
+        s2[ch] = static_cast<double>(z2[ch]);
+    }
+}
+
+template void StateVariableFilter::processBlock<float>(float**, int, int);
+template void StateVariableFilter::processBlock<double>(float**, int, int);
+
+template <typename Real>
+void StateVariableFilter::processModulated(float** samples, int numChannels, int numSamples,
+                                           const float* cutoffHz)
+{
+    // Resonance keeps its block-rate smoothing
+    if (--updateCountdown <= 0)
+    {
+        updateCountdown = updateInterval;
+        resonance = resonance + (resonanceSmooth - resonance) * (1.0 - smoothingCoeff);
+    }
+    resonance = std::max(0.0, std::min(1.0, resonance));
+
+    const Real R2 = static_cast<Real>(2.0 * (1.0 - resonance * 0.99));
+    const Real radiansPerHz = static_cast<Real>(M_PI / sampleRate);
+    const Real minCutoff = Real(20);
+    const Real maxCutoff = static_cast<Real>(std::min(20000.0, maxCutoffRatio * sampleRate));
+
+    Real z1[2] = { static_cast<Real>(s1[0]), static_cast<Real>(s1[1]) };
+    Real z2[2] = { static_cast<Real>(s2[0]), static_cast<Real>(s2[1]) };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const Real fc = std::max(minCutoff, std::min(maxCutoff, static_cast<Real>(cutoffHz[i])));
+        const Real g = tanApprox(radiansPerHz * fc);
+        const Real feedback = R2 + g;
+        const Real h = Real(1) / (Real(1) + g * feedback);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const Real input = static_cast<Real>(samples[ch][i]);
+
+            const Real highpass = (input - feedback * z1[ch] - z2[ch]) * h;
+            const Real bandpass = g * highpass + z1[ch];
+            const Real lowpass = g * bandpass + z2[ch];
+
+            z1[ch] = Real(2) * bandpass - z1[ch];
+            z2[ch] = Real(2) * lowpass - z2[ch];
+
+            Real output = 0;
+            switch (type)
+            {
+                case FilterType::Lowpass:  output = lowpass; break;
+                case FilterType::Bandpass: output = bandpass; break;
+                case FilterType::Highpass: output = highpass; break;
+                case FilterType::Notch:    output = input - bandpass; break;
+            }
+
+            samples[ch][i] = static_cast<float>(output);
+        }
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        s1[ch] = static_cast<double>(z1[ch]);
+        s2[ch] = static_cast<double>(z2[ch]);
+    }
 }
 
+template void StateVariableFilter::processModulated<float>(float**, int, int, const float*);
+template void StateVariableFilter::processModulated<double>(float**, int, int, const float*);
+
 //==============================================================================
-// SamSamplerVoice Implementation
+// SVF Filter Bank
 //==============================================================================
 
-SamSamplerVoice::SamSamplerVoice()
+namespace {
+
+// Four-lane vector ops for the filter bank: SSE, NEON or a portable fallback
+#if defined(SAMSAMPLER_SSE)
+using LaneVector = __m128;
+inline LaneVector laneLoad(const float* p) { return _mm_loadu_ps(p); }
+inline void laneStore(float* p, LaneVector v) { _mm_storeu_ps(p, v); }
+inline LaneVector laneSplat(float v) { return _mm_set1_ps(v); }
+inline LaneVector laneAdd(LaneVector a, LaneVector b) { return _mm_add_ps(a, b); }
+inline LaneVector laneSub(LaneVector a, LaneVector b) { return _mm_sub_ps(a, b); }
+inline LaneVector laneMul(LaneVector a, LaneVector b) { return _mm_mul_ps(a, b); }
+inline LaneVector laneAnd(LaneVector a, LaneVector b) { return _mm_and_ps(a, b); }
+inline LaneVector laneOr(LaneVector a, LaneVector b) { return _mm_or_ps(a, b); }
+inline void laneTranspose(LaneVector& r0, LaneVector& r1, LaneVector& r2, LaneVector& r3)
 {
-    // Initialize filter
-    filter_.prepare(48000.0);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
 }
-
-void SamSamplerVoice::setFilterParameters(double cutoff, double resonance, FilterType type)
+#elif defined(SAMSAMPLER_NEON)
+using LaneVector = float32x4_t;
+inline LaneVector laneLoad(const float* p) { return vld1q_f32(p); }
+inline void laneStore(float* p, LaneVector v) { vst1q_f32(p, v); }
+inline LaneVector laneSplat(float v) { return vdupq_n_f32(v); }
+inline LaneVector laneAdd(LaneVector a, LaneVector b) { return vaddq_f32(a, b); }
+inline LaneVector laneSub(LaneVector a, LaneVector b) { return vsubq_f32(a, b); }
+inline LaneVector laneMul(LaneVector a, LaneVector b) { return vmulq_f32(a, b); }
+inline LaneVector laneAnd(LaneVector a, LaneVector b)
 {
-    filter_.type = type;
-    filter_.setParameters(cutoff, resonance);
-    filterEnabled_ = true;
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
 }
-
-void SamSamplerVoice::setEnvelopeParameters(double attack, double hold, double decay, double sustain, double release,
-                                            EnvelopeCurve attackCurve, EnvelopeCurve decayCurve, EnvelopeCurve releaseCurve)
+inline LaneVector laneOr(LaneVector a, LaneVector b)
 {
-    envelope_.attack = attack;
-    envelope_.hold = hold;
-    envelope_.decay = decay;
-    envelope_.sustain = sustain;
-    envelope_.releaseTime = release;
-    envelope_.attackCurve = attackCurve;
-    envelope_.decayCurve = decayCurve;
-    envelope_.releaseCurve = releaseCurve;
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
 }
-
-void SamSamplerVoice::setInterpolationQuality(int quality)
+inline void laneTranspose(LaneVector& r0, LaneVector& r1, LaneVector& r2, LaneVector& r3)
 {
-    interpolationQuality_ = quality;
+    const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
 }
-
-double SamSamplerVoice::interpolateLinear(double position) const
+#else
+struct LaneVector { float v[4]; };
+template <typename Op>
+inline LaneVector laneMap(LaneVector a, LaneVector b, Op op)
 {
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
+    LaneVector r;
+    for (int k = 0; k < 4; ++k)
+        r.v[k] = op(a.v[k], b.v[k]);
+    return r;
+}
+inline uint32_t laneBits(float f) { uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; }
+inline float laneFloat(uint32_t u) { float f; std::memcpy(&f, &u, sizeof(f)); return f; }
+inline LaneVector laneLoad(const float* p) { LaneVector r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void laneStore(float* p, LaneVector v) { std::memcpy(p, v.v, sizeof(v.v)); }
+inline LaneVector laneSplat(float v) { return LaneVector { { v, v, v, v } }; }
+inline LaneVector laneAdd(LaneVector a, LaneVector b) { return laneMap(a, b, [](float x, float y) { return x + y; }); }
+inline LaneVector laneSub(LaneVector a, LaneVector b) { return laneMap(a, b, [](float x, float y) { return x - y; }); }
+inline LaneVector laneMul(LaneVector a, LaneVector b) { return laneMap(a, b, [](float x, float y) { return x * y; }); }
+inline LaneVector laneAnd(LaneVector a, LaneVector b)
+{
+    return laneMap(a, b, [](float x, float y) { return laneFloat(laneBits(x) & laneBits(y)); });
+}
+inline LaneVector laneOr(LaneVector a, LaneVector b)
+{
+    return laneMap(a, b, [](float x, float y) { return laneFloat(laneBits(x) | laneBits(y)); });
+}
+inline void laneTranspose(LaneVector& r0, LaneVector& r1, LaneVector& r2, LaneVector& r3)
+{
+    LaneVector* rows[4] = { &r0, &r1, &r2, &r3 };
+    for (int a = 0; a < 4; ++a)
+        for (int b = a + 1; b < 4; ++b)
+            std::swap(rows[a]->v[b], rows[b]->v[a]);
+}
+#endif
 
-    int index0 = static_cast<int>(position);
-    int index1 = index0 + 1;
-    double frac = position - index0;
+static_assert(SvfBank::lanes == 4, "Lane helpers are four wide");
 
-    // Handle stereo samples
-    int stride = sample_->numChannels;
+// One TPT step for every lane, in the same operation order as the scalar filter
+struct SvfLanes
+{
+    LaneVector g, feedback, h, two;
+    LaneVector lowpassMask, bandpassMask, highpassMask, notchMask;
+    LaneVector z1, z2;
 
-    if (sample_->numChannels == 1)
-    {
-        // Mono
-        if (index0 >= 0 && index0 < sample_->numSamples - 1)
-        {
-            return sample_->audioData[index0] * (1.0 - frac) +
-                   sample_->audioData[index1] * frac;
-        }
-    }
-    else if (sample_->numChannels == 2)
+    LaneVector tick(LaneVector input)
     {
-        // Stereo - take left channel
-        index0 = index0 * 2;
-        index1 = index0 + 2;
+        const LaneVector highpass = laneMul(laneSub(laneSub(input, laneMul(feedback, z1)), z2), h);
+        const LaneVector bandpass = laneAdd(laneMul(g, highpass), z1);
+        const LaneVector lowpass = laneAdd(laneMul(g, bandpass), z2);
 
-        if (index0 >= 0 && index0 < sample_->numSamples * 2 - 2)
-        {
-            return sample_->audioData[index0] * (1.0 - frac) +
-                   sample_->audioData[index1] * frac;
-        }
+        z1 = laneSub(laneMul(two, bandpass), z1);
+        z2 = laneSub(laneMul(two, lowpass), z2);
+
+        return laneOr(laneOr(laneAnd(lowpass, lowpassMask), laneAnd(bandpass, bandpassMask)),
+                      laneOr(laneAnd(highpass, highpassMask), laneAnd(laneSub(input, bandpass), notchMask)));
     }
+};
 
-    return 0.0;
-}
+} // namespace
 
-double SamSamplerVoice::interpolateCubic(double position) const
+void SvfBank::prepare(int maxBlockSize)
 {
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
+    silence_.assign(static_cast<size_t>(std::max(maxBlockSize, 1)), 0.0f);
+}
 
-    int index = static_cast<int>(position);
-    double frac = position - index;
+void SvfBank::add(StateVariableFilter& filter, float* const* samples, int numChannels, int numSamples)
+{
+    if (numLanes_ > 0 && numSamples != numSamples_)
+        flush();
 
-    // Handle stereo samples
-    int stride = sample_->numChannels;
+    filter.advanceCoefficients();
+    numSamples_ = numSamples;
 
-    if (sample_->numChannels == 1)
-    {
-        // Mono - need 4 samples for cubic
-        if (index >= 1 && index < sample_->numSamples - 2)
-        {
-            double y0 = sample_->audioData[index - 1];
-            double y1 = sample_->audioData[index];
-            double y2 = sample_->audioData[index + 1];
-            double y3 = sample_->audioData[index + 2];
-
-            // Cubic interpolation
-            return y1 + 0.5 * frac * (y2 - y0 +
-                   frac * (2.0 * y0 - 5.0 * y1 + 4.0 * y2 - y3 +
-                   frac * (3.0 * (y1 - y2) + y3 - y0)));
-        }
-    }
-    else if (sample_->numChannels == 2)
+    for (int ch = 0; ch < std::min(numChannels, 2); ++ch)
     {
-        // Stereo - left channel
-        index = index * 2;
-
-        if (index >= 2 && index < sample_->numSamples * 2 - 4)
-        {
-            double y0 = sample_->audioData[index - 2];
-            double y1 = sample_->audioData[index];
-            double y2 = sample_->audioData[index + 2];
-            double y3 = sample_->audioData[index + 4];
-
-            // Cubic interpolation
-            return y1 + 0.5 * frac * (y2 - y0 +
-                   frac * (2.0 * y0 - 5.0 * y1 + 4.0 * y2 - y3 +
-                   frac * (3.0 * (y1 - y2) + y3 - y0)));
-        }
+        lanes_[static_cast<size_t>(numLanes_++)] = { &filter, ch, samples[ch] };
+        if (numLanes_ == lanes)
+            flush();
     }
-
-    // Fall back to linear if out of bounds
-    return interpolateLinear(position);
 }
 
-double SamSamplerVoice::processLoopCrossfade(double position, int channel)
+void SvfBank::flush()
 {
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
-
-    // Check if we're near loop end
-    if (isLooping_ && position >= loopEnd_ - loopCrossfade_ * sample_->sampleRate)
-    {
-        double crossfadeSamples = loopCrossfade_ * sample_->sampleRate;
-        double distanceToEnd = loopEnd_ - position;
-        double crossfadeAmount = 1.0 - (distanceToEnd / crossfadeSamples);
-        crossfadeAmount = std::max(0.0, std::min(1.0, crossfadeAmount));
+    if (numLanes_ == 0)
+        return;
 
-        // Get sample from current position
-        double sample1 = (interpolationQuality_ == 1) ?
-                         interpolateCubic(position) :
-                         interpolateLinear(position);
+    // Empty lanes read silence with g = 0, which keeps their state and output at zero
+    if (static_cast<int>(silence_.size()) < numSamples_)
+        silence_.assign(static_cast<size_t>(numSamples_), 0.0f);
 
-        // Get sample from loop start position
-        double loopPosition = loopStart_ + (position - (loopEnd_ - crossfadeSamples));
-        double sample2 = (interpolationQuality_ == 1) ?
-                         interpolateCubic(loopPosition) :
-                         interpolateLinear(loopPosition);
+    alignas(16) float g[lanes], feedback[lanes], h[lanes], z1[lanes], z2[lanes];
+    alignas(16) float masks[4][lanes];
+    float* io[lanes];
+    const uint32_t allBits = 0xFFFFFFFFu;
+    std::memset(masks, 0, sizeof(masks));
 
-        // Crossfade
-        return sample1 * (1.0 - crossfadeAmount) + sample2 * crossfadeAmount;
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const Lane& l = lanes_[static_cast<size_t>(lane)];
+        if (lane >= numLanes_)
+        {
+            g[lane] = feedback[lane] = z1[lane] = z2[lane] = 0.0f;
+            h[lane] = 1.0f;
+            io[lane] = silence_.data();
+            continue;
+        }
+
+        const StateVariableFilter& f = *l.filter;
+        g[lane] = static_cast<float>(f.cachedG);
+        feedback[lane] = static_cast<float>(2.0 * f.cachedR + f.cachedG);
+        h[lane] = static_cast<float>(f.cachedH);
+        z1[lane] = static_cast<float>(f.s1[l.channel]);
+        z2[lane] = static_cast<float>(f.s2[l.channel]);
+        std::memcpy(masks[static_cast<int>(f.type)] + lane, &allBits, sizeof(float));
+        io[lane] = l.samples;
+    }
+
+    static_assert(static_cast<int>(FilterType::Lowpass) == 0 && static_cast<int>(FilterType::Notch) == 3,
+                  "Mask rows follow FilterType");
+
+    SvfLanes svf;
+    svf.g = laneLoad(g);
+    svf.feedback = laneLoad(feedback);
+    svf.h = laneLoad(h);
+    svf.two = laneSplat(2.0f);
+    svf.lowpassMask = laneLoad(masks[0]);
+    svf.bandpassMask = laneLoad(masks[1]);
+    svf.highpassMask = laneLoad(masks[2]);
+    svf.notchMask = laneLoad(masks[3]);
+    svf.z1 = laneLoad(z1);
+    svf.z2 = laneLoad(z2);
+
+    // Four samples of four lanes at a time: transpose so each vector holds
+    // one sample across lanes, run the recursion, transpose back
+    int i = 0;
+    for (; i + 4 <= numSamples_; i += 4)
+    {
+        LaneVector r0 = laneLoad(io[0] + i);
+        LaneVector r1 = laneLoad(io[1] + i);
+        LaneVector r2 = laneLoad(io[2] + i);
+        LaneVector r3 = laneLoad(io[3] + i);
+        laneTranspose(r0, r1, r2, r3);
+
+        r0 = svf.tick(r0);
+        r1 = svf.tick(r1);
+        r2 = svf.tick(r2);
+        r3 = svf.tick(r3);
+
+        laneTranspose(r0, r1, r2, r3);
+        laneStore(io[0] + i, r0);
+        laneStore(io[1] + i, r1);
+        laneStore(io[2] + i, r2);
+        laneStore(io[3] + i, r3);
     }
 
-    // Normal playback
-    return (interpolationQuality_ == 1) ?
-           interpolateCubic(position) :
-           interpolateLinear(position);
+    for (; i < numSamples_; ++i)
+    {
+        alignas(16) float frame[lanes];
+        for (int lane = 0; lane < lanes; ++lane)
+            frame[lane] = io[lane][i];
+        laneStore(frame, svf.tick(laneLoad(frame)));
+        for (int lane = 0; lane < lanes; ++lane)
+            io[lane][i] = frame[lane];
+    }
+
+    laneStore(z1, svf.z1);
+    laneStore(z2, svf.z2);
+    for (int lane = 0; lane < numLanes_; ++lane)
+    {
+        const Lane& l = lanes_[static_cast<size_t>(lane)];
+        l.filter->s1[l.channel] = static_cast<double>(z1[lane]);
+        l.filter->s2[l.channel] = static_cast<double>(z2[lane]);
+    }
+
+    numLanes_ = 0;
 }
 
-void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample)
+//==============================================================================
+// SamSamplerVoice Implementation
+//==============================================================================
+
+SamSamplerVoice::SamSamplerVoice()
 {
-    midiNote_ = midiNote;
-    velocity_ = velocity;
-    frequency_ = midiToFrequency(midiNote);
-    sample_ = sample;
-    isActive_ = true;
+    // Initialize filters
+    filter_.prepare(48000.0);
+    filterRight_.prepare(48000.0);
+}
 
-    // Start envelope
-    envelope_.start();
+void SamSamplerVoice::prepare(double sampleRate, int maxBlockSize)
+{
+    sampleRate_ = sampleRate;
 
-    // Reset filter state
-    filter_.reset();
+    // Only a rate change resets the filters; buffer growth mid-note must not click
+    if (filter_.sampleRate != sampleRate)
+    {
+        filter_.prepare(sampleRate);
+        filterRight_.prepare(sampleRate);
+    }
+
+    size_t delayLength = 1;
+    while (delayLength <= static_cast<size_t>(maxStereoOffsetSeconds * sampleRate))
+        delayLength <<= 1;
+    if (stereoDelayLine_.size() != delayLength)
+    {
+        stereoDelayLine_.assign(delayLength, 0.0f);
+        stereoDelay_ = std::min(stereoDelay_, static_cast<int>(delayLength) - 1);
+        stereoDelayWrite_ = 0;
+    }
+
+    for (auto& buffer : voiceBuffers_)
+        buffer.assign(static_cast<size_t>(std::max(maxBlockSize, 1)), 0.0f);
+    envelopeBuffer_.assign(static_cast<size_t>(std::max(maxBlockSize, 1)), 0.0);
+    envelopeBufferFloat_.assign(static_cast<size_t>(std::max(maxBlockSize, 1)), 0.0f);
+
+    // One filter setting per control period, at the shortest period
+    filterTicks_.assign(static_cast<size_t>(std::max(maxBlockSize, 1) / 16 + 2), FilterTick());
+}
+
+void SamSamplerVoice::setFilterParameters(double cutoff, double resonance, FilterType type)
+{
+    filter_.type = type;
+    filterRight_.type = type;
+    filterCutoff_ = cutoff;
+    filterResonance_ = resonance;
+    filterEnabled_ = true;
+    applyFilterParameters();
+}
+
+void SamSamplerVoice::applyFilterParameters()
+{
+    // Spread pulls the left cutoff down and the right one up (spread 0: both at cutoff)
+    const double spread = filterSpread_ * 0.5;
+    filter_.setParameters(filterCutoff_ * (1.0 - spread), filterResonance_);
+    filterRight_.setParameters(filterCutoff_ * (1.0 + spread), filterResonance_);
+
+    if (filterSettling_)
+    {
+        filter_.settle();
+        filterRight_.settle();
+    }
+}
+
+void SamSamplerVoice::setEnvelopeParameters(double attack, double hold, double decay, double sustain, double release,
+                                            EnvelopeCurve attackCurve, EnvelopeCurve decayCurve, EnvelopeCurve releaseCurve)
+{
+    envelope_.attack = attack;
+    envelope_.hold = hold;
+    envelope_.decay = decay;
+    envelope_.sustain = sustain;
+    envelope_.releaseTime = release;
+    envelope_.attackCurve = attackCurve;
+    envelope_.decayCurve = decayCurve;
+    envelope_.releaseCurve = releaseCurve;
+}
+
+namespace {
+
+//==============================================================================
+// Polyphase windowed-sinc tables
+//==============================================================================
+
+/**
+ * Kaiser-windowed sinc taps for `phases + 1` evenly spaced fractions in
+ * [0, 1]. Row r holds the taps for p[-(Taps/2 - 1)]..p[Taps/2] at fraction
+ * r / phases; each row is normalised to unity DC gain. Rows are 16-byte
+ * aligned for the SIMD dot products.
+ */
+template <int Taps>
+class SincTable
+{
+public:
+    static constexpr int phases = 256;
+
+    // Splitting a 32-bit phase fraction: the top 8 bits pick the row
+    static constexpr int weightBits = 24;
+    static constexpr uint32_t weightMask = (1u << weightBits) - 1;
+    static constexpr double weightScale = 1.0 / (1u << weightBits);
+    static_assert((static_cast<uint64_t>(phases) << weightBits) == (1ull << 32),
+                  "Row and weight bits must split the 32-bit fraction");
+
+    SincTable(double cutoff, double kaiserBeta)
+        : coefficients_(static_cast<size_t>((phases + 1) * Taps))
+    {
+        const double halfWidth = Taps / 2;
+        const double windowNorm = 1.0 / besselI0(kaiserBeta);
+
+        for (int phase = 0; phase <= phases; ++phase)
+        {
+            const double frac = static_cast<double>(phase) / phases;
+            float* taps = coefficients_.data() + phase * Taps;
+            double sum = 0.0;
+
+            for (int k = 0; k < Taps; ++k)
+            {
+                const double x = (k - (Taps / 2 - 1)) - frac;
+                const double r = x / halfWidth;
+                const double window = std::abs(r) >= 1.0 ? 0.0
+                    : besselI0(kaiserBeta * std::sqrt(1.0 - r * r)) * windowNorm;
+                const double arg = M_PI * cutoff * x;
+                const double sinc = std::abs(arg) < 1e-12 ? 1.0 : std::sin(arg) / arg;
+                const double tap = cutoff * sinc * window;
+
+                taps[k] = static_cast<float>(tap);
+                sum += tap;
+            }
+
+            for (int k = 0; k < Taps; ++k)
+                taps[k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+
+    const float* row(int phase) const { return coefficients_.data() + phase * Taps; }
+
+private:
+    static double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    AudioChannelBuffer coefficients_;
+};
+
+/**
+ * One table per rate band, an eighth of an octave apart up to an octave above
+ * unity. A band's cutoff is the unity cutoff divided by the band's highest
+ * rate, so content that would fold past the output Nyquist is filtered out
+ * before it aliases. Higher rates use the octave table; with mip mapping on,
+ * the pyramid keeps rates within the first few bands.
+ */
+template <int Taps>
+class SincTableSet
+{
+public:
+    static constexpr int bandsPerOctave = 8;
+    static constexpr int numBands = bandsPerOctave + 1;
+
+    SincTableSet(double cutoff, double kaiserBeta)
+    {
+        tables_.reserve(numBands);
+        for (int band = 0; band < numBands; ++band)
+            tables_.emplace_back(cutoff * std::exp2(-static_cast<double>(band) / bandsPerOctave), kaiserBeta);
+    }
+
+    const SincTable<Taps>& forRate(double rate) const
+    {
+        if (rate <= 1.0)
+            return tables_[0];
+
+        const double band = std::ceil(std::log2(rate) * bandsPerOctave);
+        return tables_[static_cast<size_t>(std::min(band, static_cast<double>(numBands - 1)))];
+    }
+
+private:
+    std::vector<SincTable<Taps>> tables_;
+};
+
+// Built on first use rather than at static initialization. Cutoffs trade
+// passband for stopband: shorter kernels need a wider transition.
+template <int Taps> const SincTableSet<Taps>& sincTables();
+
+template <> const SincTableSet<8>& sincTables<8>()
+{
+    static const SincTableSet<8> tables(0.78, 5.0);
+    return tables;
+}
+
+template <> const SincTableSet<16>& sincTables<16>()
+{
+    static const SincTableSet<16> tables(0.87, 7.0);
+    return tables;
+}
+
+template <> const SincTableSet<32>& sincTables<32>()
+{
+    static const SincTableSet<32> tables(0.93, 8.6);
+    return tables;
+}
+
+// Dot products of x against two adjacent table rows in one pass; Taps is a
+// multiple of 4 and the rows are aligned, x need not be
+template <int Taps>
+inline void dotProductPair(const float* x, const float* a, const float* b, float& outA, float& outB)
+{
+#if defined(SAMSAMPLER_SSE)
+    __m128 sumA = _mm_setzero_ps();
+    __m128 sumB = _mm_setzero_ps();
+    for (int k = 0; k < Taps; k += 4)
+    {
+        const __m128 v = _mm_loadu_ps(x + k);
+        sumA = _mm_add_ps(sumA, _mm_mul_ps(v, _mm_load_ps(a + k)));
+        sumB = _mm_add_ps(sumB, _mm_mul_ps(v, _mm_load_ps(b + k)));
+    }
+    alignas(16) float lanesA[4];
+    alignas(16) float lanesB[4];
+    _mm_store_ps(lanesA, sumA);
+    _mm_store_ps(lanesB, sumB);
+    outA = (lanesA[0] + lanesA[1]) + (lanesA[2] + lanesA[3]);
+    outB = (lanesB[0] + lanesB[1]) + (lanesB[2] + lanesB[3]);
+#elif defined(SAMSAMPLER_NEON)
+    float32x4_t sumA = vdupq_n_f32(0.0f);
+    float32x4_t sumB = vdupq_n_f32(0.0f);
+    for (int k = 0; k < Taps; k += 4)
+    {
+        const float32x4_t v = vld1q_f32(x + k);
+        sumA = vmlaq_f32(sumA, v, vld1q_f32(a + k));
+        sumB = vmlaq_f32(sumB, v, vld1q_f32(b + k));
+    }
+    float lanesA[4];
+    float lanesB[4];
+    vst1q_f32(lanesA, sumA);
+    vst1q_f32(lanesB, sumB);
+    outA = (lanesA[0] + lanesA[1]) + (lanesA[2] + lanesA[3]);
+    outB = (lanesB[0] + lanesB[1]) + (lanesB[2] + lanesB[3]);
+#else
+    float sumA[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float sumB[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int k = 0; k < Taps; k += 4)
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            sumA[lane] += x[k + lane] * a[k + lane];
+            sumB[lane] += x[k + lane] * b[k + lane];
+        }
+    outA = (sumA[0] + sumA[1]) + (sumA[2] + sumA[3]);
+    outB = (sumB[0] + sumB[1]) + (sumB[2] + sumB[3]);
+#endif
+}
+
+constexpr double fractionBitsScale = 1.0 / 4294967296.0;   // 2^-32
+
+// Interpolation kernels over one planar channel; p points at frame `index`
+// and guard frames make p[-(Sample::guardFrames)]..p[Sample::guardFrames]
+// always readable. Real is the arithmetic type (float or double). readFixed
+// takes the fraction as the low 32 bits of a fixed-point phase.
+struct LinearKernel
+{
+    template <typename Real>
+    static Real read(const float* p, Real frac)
+    {
+        return p[0] * (Real(1) - frac) + p[1] * frac;
+    }
+
+    template <typename Real>
+    static Real readFixed(const float* p, uint32_t fraction)
+    {
+        return read(p, static_cast<Real>(fraction) * static_cast<Real>(fractionBitsScale));
+    }
+};
+
+struct CubicKernel
+{
+    template <typename Real>
+    static Real read(const float* p, Real frac)
+    {
+        Real y0 = p[-1];
+        Real y1 = p[0];
+        Real y2 = p[1];
+        Real y3 = p[2];
+
+        // Cubic interpolation
+        return y1 + Real(0.5) * frac * (y2 - y0 +
+               frac * (Real(2) * y0 - Real(5) * y1 + Real(4) * y2 - y3 +
+               frac * (Real(3) * (y1 - y2) + y3 - y0)));
+    }
+
+    template <typename Real>
+    static Real readFixed(const float* p, uint32_t fraction)
+    {
+        return read(p, static_cast<Real>(fraction) * static_cast<Real>(fractionBitsScale));
+    }
+};
+
+// Taps from the two table rows bracketing the fraction, blended linearly.
+// The table is the one for the span's playback rate.
+template <int Taps>
+struct SincKernel
+{
+    static_assert(Taps / 2 <= Sample::guardFrames, "Sinc reach exceeds the sample guard frames");
+
+    const SincTable<Taps>& table;
+
+    template <typename Real>
+    Real read(const float* p, Real frac) const
+    {
+        const Real position = frac * SincTable<Taps>::phases;
+        const int phase = std::min(static_cast<int>(position), SincTable<Taps>::phases - 1);
+        return blend(p, phase, position - static_cast<Real>(phase));
+    }
+
+    // The top bits of the fraction are the row, the rest the blend weight
+    template <typename Real>
+    Real readFixed(const float* p, uint32_t fraction) const
+    {
+        const int phase = static_cast<int>(fraction >> SincTable<Taps>::weightBits);
+        const Real weight = static_cast<Real>(fraction & SincTable<Taps>::weightMask)
+                          * static_cast<Real>(SincTable<Taps>::weightScale);
+        return blend(p, phase, weight);
+    }
+
+private:
+    template <typename Real>
+    Real blend(const float* p, int phase, Real weight) const
+    {
+        float lower, upper;
+        dotProductPair<Taps>(p - (Taps / 2 - 1), table.row(phase), table.row(phase + 1), lower, upper);
+        return lower + weight * (upper - lower);
+    }
+};
+
+// Unity rate on whole frames: the interpolator would return the frames unchanged
+template <int NumChannels, typename Real>
+void renderFramesCopy(float* const* output, const Real* envelope, int numSamples,
+                      const float* const* frames, int index, Real velocity)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const Real gain = envelope[i] * velocity;
+        for (int ch = 0; ch < NumChannels; ++ch)
+            output[ch][i] = static_cast<float>(frames[ch][index + i] * gain);
+    }
+}
+
+// Calls fn with the kernel for the quality setting and playback rate, so the
+// span loops below are instantiated once per kernel
+template <typename Fn>
+void dispatchKernel(int quality, double rate, Fn&& fn)
+{
+    switch (quality)
+    {
+        case SamSamplerVoice::Linear: fn(LinearKernel()); break;
+        case SamSamplerVoice::Sinc8:  fn(SincKernel<8>{ sincTables<8>().forRate(rate) }); break;
+        case SamSamplerVoice::Sinc16: fn(SincKernel<16>{ sincTables<16>().forRate(rate) }); break;
+        case SamSamplerVoice::Sinc32: fn(SincKernel<32>{ sincTables<32>().forRate(rate) }); break;
+        default:                      fn(CubicKernel()); break;
+    }
+}
+
+// Span loop: index and fraction are computed once per output sample and
+// shared by every channel. Returns the advanced position.
+template <int NumChannels, typename Kernel, typename Real>
+double renderFrames(const Kernel& kernel, float* const* output, const Real* envelope, int numSamples,
+                    const float* const* frames, double position, double rate, Real velocity)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int index = static_cast<int>(position);
+        const Real frac = static_cast<Real>(position - index);
+        const Real gain = envelope[i] * velocity;
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+            output[ch][i] = static_cast<float>(kernel.read(frames[ch] + index, frac) * gain);
+
+        position += rate;
+    }
+    return position;
+}
+
+// Highest rate played from a level before moving down an octave. Above unity
+// linear and cubic let some content fold over, but it lands above ~0.4 of the
+// output rate; the sinc kernels narrow their cutoff instead.
+constexpr double mipRateHeadroom = 1.2;
+
+constexpr double phaseScale = 4294967296.0;        // 2^32
+constexpr double phaseToFraction = 1.0 / 4294967296.0;
+constexpr uint64_t phaseFractionMask = 0xFFFFFFFFull;
+
+inline uint64_t framesToPhase(double frames)
+{
+    return static_cast<uint64_t>(frames * phaseScale);
+}
+
+// Fixed-point span loop: index by shift, fraction by mask, and the kernel
+// works from the fraction bits. Returns the advanced phase.
+template <int NumChannels, typename Kernel, typename Real>
+uint64_t renderFramesFixed(const Kernel& kernel, float* const* output, const Real* envelope, int numSamples,
+                           const float* const* frames, uint64_t phase, uint64_t increment,
+                           Real velocity)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int index = static_cast<int>(phase >> 32);
+        const uint32_t fraction = static_cast<uint32_t>(phase & phaseFractionMask);
+        const Real gain = envelope[i] * velocity;
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+            output[ch][i] = static_cast<float>(kernel.template readFixed<Real>(frames[ch] + index, fraction) * gain);
+
+        phase += increment;
+    }
+    return phase;
+}
+
+} // namespace
+
+void SamSamplerVoice::setInterpolationQuality(int quality)
+{
+    interpolationQuality_ = std::max(static_cast<int>(Linear), std::min(quality, static_cast<int>(Sinc32)));
+
+    // Build the sinc tables now rather than inside the first rendered block
+    dispatchKernel(interpolationQuality_, 1.0, [](auto) {});
+}
+
+double SamSamplerVoice::interpolateLinear(const float* frames, double position) const
+{
+    const int index = static_cast<int>(position);
+    return LinearKernel::read<double>(frames + index, position - index);
+}
+
+double SamSamplerVoice::interpolateCubic(const float* frames, double position) const
+{
+    const int index = static_cast<int>(position);
+    return CubicKernel::read<double>(frames + index, position - index);
+}
+
+int SamSamplerVoice::samplesUntilPosition(double boundary) const
+{
+    if (fixedPointPhase_)
+    {
+        // Exact: the span ends on the first step that lands on or past boundary
+        const uint64_t target = framesToPhase(boundary);
+        if (phase_ >= target)
+            return 0;
+        if (phaseIncrement_ == 0)
+            return INT_MAX;
+
+        const uint64_t steps = (target - phase_ + phaseIncrement_ - 1) / phaseIncrement_;
+        return steps >= static_cast<uint64_t>(INT_MAX) ? INT_MAX : static_cast<int>(steps);
+    }
+
+    if (playPosition_ >= boundary)
+        return 0;
+    if (playbackRate_ <= 0.0)
+        return INT_MAX;
+
+    double steps = std::ceil((boundary - playPosition_) / playbackRate_);
+    return steps >= static_cast<double>(INT_MAX) ? INT_MAX : static_cast<int>(steps);
+}
+
+template <typename Real>
+void SamSamplerVoice::renderSpan(float* const* output, const Real* envelope, int numSamples,
+                                 const float* const* frames, double origin)
+{
+    const Real velocity = static_cast<Real>(velocity_);
+    const double rate = playbackRate_;
+    const bool stereo = sample_->numChannels >= 2;
+
+    if (fixedPointPhase_)
+    {
+        const uint64_t originPhase = framesToPhase(origin);
+        uint64_t phase = phase_ - originPhase;
+        const uint64_t increment = phaseIncrement_;
+
+        if (increment == (1ull << 32) && (phase & phaseFractionMask) == 0)
+        {
+            const int index = static_cast<int>(phase >> 32);
+            stereo ? renderFramesCopy<2>(output, envelope, numSamples, frames, index, velocity)
+                   : renderFramesCopy<1>(output, envelope, numSamples, frames, index, velocity);
+            phase_ += increment * static_cast<uint64_t>(numSamples);
+            playPosition_ = static_cast<double>(phase_) * phaseToFraction;
+            return;
+        }
+
+        dispatchKernel(interpolationQuality_, rate, [&](auto kernel) {
+            using Kernel = decltype(kernel);
+            phase = stereo ? renderFramesFixed<2, Kernel, Real>(kernel, output, envelope, numSamples, frames, phase, increment, velocity)
+                           : renderFramesFixed<1, Kernel, Real>(kernel, output, envelope, numSamples, frames, phase, increment, velocity);
+        });
+
+        phase_ = phase + originPhase;
+        playPosition_ = static_cast<double>(phase_) * phaseToFraction;
+        return;
+    }
+
+    double position = playPosition_ - origin;
+
+    // Root key of a sample at the engine rate: a straight copy
+    if (rate == 1.0 && position == std::floor(position))
+    {
+        const int index = static_cast<int>(position);
+        stereo ? renderFramesCopy<2>(output, envelope, numSamples, frames, index, velocity)
+               : renderFramesCopy<1>(output, envelope, numSamples, frames, index, velocity);
+        playPosition_ = (position + numSamples) + origin;
+        return;
+    }
+
+    // Kernel and channel count chosen once per span; the loop body has no boundary tests
+    dispatchKernel(interpolationQuality_, rate, [&](auto kernel) {
+        using Kernel = decltype(kernel);
+        position = stereo ? renderFrames<2, Kernel, Real>(kernel, output, envelope, numSamples, frames, position, rate, velocity)
+                          : renderFrames<1, Kernel, Real>(kernel, output, envelope, numSamples, frames, position, rate, velocity);
+    });
+
+    playPosition_ = position + origin;
+}
+
+void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample)
+{
+    beginNote(midiNote, velocity, std::move(sample));
 
     // Calculate playback rate based on sample's root note
     if (sample_ && sample_->isValid())
@@ -423,17 +1579,141 @@ void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sa
         playbackRate_ *= SchillingerEcosystem::DSP::LookupTables::getInstance().detuneToRatio(
             static_cast<float>(sample_->pitchCorrection)
         );
+
+        // Samples recorded at another rate step through their frames faster or slower
+        playbackRate_ *= static_cast<double>(sample_->sampleRate) / sampleRate_;
     }
     else
     {
         playbackRate_ = 1.0;
     }
 
+    beginPlayback();
+}
+
+void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample, double pitchCents)
+{
+    beginNote(midiNote, velocity, std::move(sample));
+
+    // Zone tuning replaces the sample's root note and correction
+    playbackRate_ = 1.0;
+    if (sample_ && sample_->isValid())
+        playbackRate_ = std::exp2(pitchCents / 1200.0) * static_cast<double>(sample_->sampleRate) / sampleRate_;
+
+    beginPlayback();
+}
+
+void SamSamplerVoice::beginNote(int midiNote, float velocity, std::shared_ptr<Sample> sample)
+{
+    midiNote_ = midiNote;
+    velocity_ = velocity;
+    frequency_ = midiToFrequency(midiNote);
+    sample_ = std::move(sample);
+    isActive_ = true;
+
+    // Start envelope
+    envelope_.start();
+
+    // Reset filter state; settings made before the first block apply without a glide
+    filter_.reset();
+    filterRight_.reset();
+    filterSettling_ = true;
+
+    // Unmodulated until setModulation()
+    modProgram_ = nullptr;
+    modInputs_ = nullptr;
+    modulated_ = false;
+    modulatesFilter_ = false;
+    modPan_ = 0.0;
+    modNoteOnGain_ = 1.0f;
+    modGain_ = 1.0f;
+}
+
+void SamSamplerVoice::beginPlayback()
+{
+    // Well above unity rate, play a decimated level instead so the interpolator
+    // reads band-limited material; frames of level L are 2^L source frames apart
+    mipLevel_ = 0;
+    if (mipMapping_ && sample_ && playbackRate_ > mipRateHeadroom)
+    {
+        if (auto pyramid = std::atomic_load(&sample_->pyramid))
+        {
+            while (mipLevel_ < static_cast<int>(pyramid->levels.size()) && playbackRate_ > mipRateHeadroom)
+            {
+                playbackRate_ *= 0.5;
+                ++mipLevel_;
+            }
+            if (mipLevel_ > 0)
+                sample_ = pyramid->levels[mipLevel_ - 1];
+        }
+    }
+
     playPosition_ = 0.0;
+    phase_ = 0;
+    phaseIncrement_ = static_cast<uint64_t>(std::llround(playbackRate_ * phaseScale));
+
+    // Capture the seam baked for this sample; later rebuilds don't affect this note
+    loopRegion_ = sample_ ? std::atomic_load(&sample_->loopRegion) : nullptr;
+    isLooping_ = false;
+    loopUntilRelease_ = false;
+}
+
+void SamSamplerVoice::setLooping(bool shouldLoop, bool untilRelease)
+{
+    isLooping_ = shouldLoop && loopRegion_ != nullptr;
+    loopUntilRelease_ = untilRelease;
+    if (isLooping_)
+    {
+        loopStart_ = static_cast<double>(loopRegion_->loopStart);
+        loopEnd_ = static_cast<double>(loopRegion_->loopEnd);
+        loopTailStart_ = static_cast<double>(loopRegion_->tailStart);
+    }
+}
+
+void SamSamplerVoice::setFixedPointPhase(bool enabled)
+{
+    if (enabled == fixedPointPhase_)
+        return;
+
+    // Hand the playhead over to the newly active accumulator
+    if (enabled)
+        phase_ = framesToPhase(playPosition_);
+    else
+        playPosition_ = static_cast<double>(phase_) * phaseToFraction;
+
+    fixedPointPhase_ = enabled;
+}
+
+bool SamSamplerVoice::playheadReached(double boundary) const
+{
+    return fixedPointPhase_ ? phase_ >= framesToPhase(boundary) : playPosition_ >= boundary;
+}
+
+void SamSamplerVoice::wrapPlayhead()
+{
+    if (fixedPointPhase_)
+    {
+        phase_ = framesToPhase(loopStart_) + (phase_ - framesToPhase(loopEnd_));
+        playPosition_ = static_cast<double>(phase_) * phaseToFraction;
+    }
+    else
+    {
+        playPosition_ = loopStart_ + (playPosition_ - loopEnd_);
+    }
 }
 
 void SamSamplerVoice::stopNote(float velocity)
 {
+    // Loop-until-release notes play their tail from wherever the playhead is
+    if (loopUntilRelease_)
+        isLooping_ = false;
+
+    envelope_.release();
+}
+
+void SamSamplerVoice::releaseQuickly(double releaseSeconds)
+{
+    envelope_.releaseTime = std::min(envelope_.releaseTime, releaseSeconds);
     envelope_.release();
 }
 
@@ -446,7 +1726,17 @@ void SamSamplerVoice::reset()
     frequency_ = 440.0;
     playPosition_ = 0.0;
     playbackRate_ = 1.0;
+    phase_ = 0;
+    phaseIncrement_ = 0;
+    isLooping_ = false;
+    loopUntilRelease_ = false;
+    mipLevel_ = 0;
+    loopRegion_.reset();
     sample_.reset();
+    modProgram_ = nullptr;
+    modInputs_ = nullptr;
+    modulated_ = false;
+    modulatesFilter_ = false;
 }
 
 double SamSamplerVoice::midiToFrequency(int midiNote) const
@@ -457,157 +1747,655 @@ double SamSamplerVoice::midiToFrequency(int midiNote) const
     );
 }
 
-void SamSamplerVoice::process(float** outputs, int numChannels, int numSamples, double sampleRate)
+template <typename Real>
+int SamSamplerVoice::renderSpans(float* const* voiceBuffers, int voiceChannels, int numSamples,
+                                 double sampleRate, Real* envelopeLevels)
 {
-    if (!isActive_ || !sample_ || !sample_->isValid())
-        return;
-
-    // Temporary buffer for voice output (for filtering)
-    std::vector<float> voiceBuffer(numSamples);
+    const double sampleEnd = static_cast<double>(sample_->numSamples);
+    const double playEnd = isLooping_ ? std::min(loopTailStart_, sampleEnd) : sampleEnd;
 
-    // Process each sample
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Render in spans that end exactly at the next event (envelope stage change,
+    // loop tail start, loop end or sample end), so the inner loops stay check-free
+    int rendered = 0;
+    while (rendered < numSamples)
     {
-        // Get envelope value
-        double env = envelope_.process(sampleRate, 1);
+        int envelopeSpan = envelope_.samplesUntilStageChange(sampleRate);
+        if (envelopeSpan == 0)
+            envelope_.process(sampleRate, 1); // Release has run out
 
-        // Check if voice is finished
         if (!envelope_.isActive)
         {
             isActive_ = false;
             break;
         }
 
-        // Get interpolated sample with improved quality
-        double output = processLoopCrossfade(playPosition_, 0);
+        // Past the tail start a looping voice reads the baked seam buffer
+        const bool inLoopTail = isLooping_ && playheadReached(loopTailStart_);
+
+        int span = std::min(numSamples - rendered, envelopeSpan);
+        span = std::min(span, samplesUntilPosition(inLoopTail ? loopEnd_ : playEnd));
+        span = std::max(span, 1);
 
-        // Apply envelope and velocity
-        output *= env * static_cast<double>(velocity_);
+        envelope_.processSpan(sampleRate, envelopeLevels + rendered, span);
 
-        // Store in voice buffer
-        voiceBuffer[sample] = static_cast<float>(output);
+        float* spanOutput[2] = { voiceBuffers[0] + rendered, voiceBuffers[1] + rendered };
+        const float* spanFrames[2];
+        for (int ch = 0; ch < voiceChannels; ++ch)
+            spanFrames[ch] = inLoopTail ? loopRegion_->frames(ch) : sample_->frames(ch);
 
-        // Advance playhead
-        playPosition_ += playbackRate_;
+        renderSpan(spanOutput, envelopeLevels + rendered, span, spanFrames,
+                   inLoopTail ? loopTailStart_ : 0.0);
+
+        rendered += span;
 
         // Handle looping
-        if (isLooping_ && playPosition_ >= loopEnd_)
+        if (isLooping_ && playheadReached(loopEnd_))
         {
-            playPosition_ = loopStart_ + (playPosition_ - loopEnd_);
+            wrapPlayhead();
         }
         // Check for end of sample
-        else if (playPosition_ >= sample_->numSamples)
+        else if (playheadReached(sampleEnd))
         {
             isActive_ = false;
             break;
         }
     }
+    return rendered;
+}
+
+void SamSamplerVoice::process(float** outputs, int numChannels, int numSamples, double sampleRate)
+{
+    if (!renderBlock(numSamples, sampleRate))
+        return;
+
+    filterBlock(numSamples);
+    mixBlock(outputs, numChannels, numSamples, sampleRate);
+}
+
+bool SamSamplerVoice::renderBlock(int numSamples, double sampleRate)
+{
+    blockChannels_ = 0;
+    filterSettling_ = false;
+    if (!isActive_ || !sample_ || !sample_->isValid())
+        return false;
+
+    // Hosts may exceed the prepared block size; grow rather than truncate
+    if (static_cast<int>(envelopeBuffer_.size()) < numSamples)
+        prepare(sampleRate, numSamples);
+
+    // Stereo samples render both channels in one pass
+    const int voiceChannels = std::min(sample_->numChannels, 2);
+    float* voiceBuffers[2] = { voiceBuffers_[0].data(), voiceBuffers_[1].data() };
+
+    int rendered;
+    if (modulated_)
+        rendered = renderModulated(voiceBuffers, voiceChannels, numSamples, sampleRate);
+    else if (singlePrecision_)
+        rendered = renderSpans(voiceBuffers, voiceChannels, numSamples, sampleRate, envelopeBufferFloat_.data());
+    else
+        rendered = renderSpans(voiceBuffers, voiceChannels, numSamples, sampleRate, envelopeBuffer_.data());
+
+    // Silence whatever the voice did not reach before finishing
+    if (rendered < numSamples)
+        for (int ch = 0; ch < voiceChannels; ++ch)
+            std::fill(voiceBuffers[ch] + rendered, voiceBuffers[ch] + numSamples, 0.0f);
+
+    blockChannels_ = voiceChannels;
+    if (wantsStereo())
+        renderStereoChannels(numSamples);
+    return true;
+}
+
+void SamSamplerVoice::filterBlock(int numSamples)
+{
+    if (!filterEnabled_ || blockChannels_ == 0)
+        return;
+
+    // Entire buffer, one state per channel; under spread each channel has its own filter
+    float* voiceBuffers[2] = { voiceBuffers_[0].data(), voiceBuffers_[1].data() };
+    if (modulatesFilter_)
+    {
+        filterModulated(voiceBuffers, numSamples);
+        return;
+    }
+
+    const int channels = filterSplit() ? 1 : blockChannels_;
+    if (singlePrecision_)
+    {
+        filter_.processBlock<float>(voiceBuffers, channels, numSamples);
+        if (filterSplit())
+            filterRight_.processBlock<float>(voiceBuffers + 1, 1, numSamples);
+    }
+    else
+    {
+        filter_.process(voiceBuffers, channels, numSamples);
+        if (filterSplit())
+            filterRight_.process(voiceBuffers + 1, 1, numSamples);
+    }
+}
+
+void SamSamplerVoice::addToFilterBank(SvfBank& bank, int numSamples)
+{
+    float* voiceBuffers[2] = { voiceBuffers_[0].data(), voiceBuffers_[1].data() };
+    if (filterSplit())
+    {
+        bank.add(filter_, voiceBuffers, 1, numSamples);
+        bank.add(filterRight_, voiceBuffers + 1, 1, numSamples);
+    }
+    else
+    {
+        bank.add(filter_, voiceBuffers, blockChannels_, numSamples);
+    }
+}
+
+void SamSamplerVoice::mixBlock(float** outputs, int numChannels, int numSamples, double sampleRate)
+{
+    if (blockChannels_ == 0)
+        return;
+
+    const int voiceChannels = blockChannels_;
+    float* voiceBuffers[2] = { voiceBuffers_[0].data(), voiceBuffers_[1].data() };
 
-    // Apply filter if enabled (processes entire buffer)
-    if (filterEnabled_)
+    // Retire the voice once its gain has decayed below audibility (this block
+    // still plays). Quiet sample content alone never retires it: a gap or a
+    // slow attack in the sample is followed by sound the voice must still play
+    if (isActive_ && silenceThreshold_ > 0.0 && envelope_.isPastAttack(sampleRate)
+        && envelope_.currentLevel * velocity_ < silenceThreshold_)
     {
-        float* channelPtr[1] = { voiceBuffer.data() };
-        filter_.process(channelPtr, 1, numSamples);
+        float peak = 0.0f;
+        for (int ch = 0; ch < voiceChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                peak = std::max(peak, std::abs(voiceBuffers[ch][i]));
+
+        if (peak < silenceThreshold_)
+            isActive_ = false;
+    }
+
+    // Gain matrix, applied while accumulating: mono voices feed every output
+    // channel, stereo voices keep left/right (alternating across wider
+    // layouts), each scaled by the pan gain for its side. A single output
+    // takes the unpanned mono sum.
+    if (numChannels == 1)
+    {
+        if (voiceChannels == 1)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                outputs[0][i] += voiceBuffers[0][i] * outputGain_;
+        }
+        else
+        {
+            const float gain = outputGain_ * 0.5f;
+            for (int i = 0; i < numSamples; ++i)
+                outputs[0][i] += (voiceBuffers[0][i] + voiceBuffers[1][i]) * gain;
+        }
+        return;
     }
 
-    // Write to all output channels
     for (int ch = 0; ch < numChannels; ++ch)
     {
+        const float* source = voiceBuffers[voiceChannels == 1 ? 0 : (ch & 1)];
+        const float gain = panGains_[ch & 1];
+        float* destination = outputs[ch];
         for (int i = 0; i < numSamples; ++i)
+            destination[i] += source[i] * gain;
+    }
+}
+
+void SamSamplerVoice::setPan(double pan, double gain)
+{
+    panPosition_ = pan;
+    panGain_ = gain;
+    applyPanGains();
+}
+
+void SamSamplerVoice::applyPanGains()
+{
+    // sin/cos law scaled by sqrt(2): unity at center, L^2 + R^2 constant
+    const double gain = panGain_ * modNoteOnGain_;
+    const double angle = (std::max(-1.0, std::min(1.0, panPosition_ + modPan_)) + 1.0) * (M_PI * 0.25);
+    panGains_[0] = static_cast<float>(std::cos(angle) * M_SQRT2 * gain);
+    panGains_[1] = static_cast<float>(std::sin(angle) * M_SQRT2 * gain);
+    outputGain_ = static_cast<float>(gain);
+}
+
+//==============================================================================
+// SamSamplerVoice SF2 Modulation
+//==============================================================================
+
+void SamSamplerVoice::setModulation(const ModulatorProgram& program, const ModulatorInputs& inputs,
+                                    const float* noteOn, bool modulateFilter)
+{
+    using Program = ModulatorProgram;
+
+    modProgram_ = &program;
+    modInputs_ = &inputs;
+    std::copy(noteOn, noteOn + Program::TargetCount, modNoteOn_.begin());
+
+    // The note-on level and pan live in the pan gains; updates move around them
+    modNoteOnGain_ = static_cast<float>(std::pow(10.0, -noteOn[Program::Attenuation] / 200.0));
+    modPan_ = noteOn[Program::Pan] / 500.0;
+
+    lfoActive_ = noteOn[Program::VibLfoToPitch] != 0.0f || noteOn[Program::ModLfoToPitch] != 0.0f
+              || noteOn[Program::ModLfoToFilterCutoff] != 0.0f || noteOn[Program::ModLfoToVolume] != 0.0f
+              || program.isDynamic(Program::VibLfoToPitch) || program.isDynamic(Program::ModLfoToPitch)
+              || program.isDynamic(Program::ModLfoToFilterCutoff) || program.isDynamic(Program::ModLfoToVolume);
+    modulatesFilter_ = modulateFilter && filterEnabled_
+                    && (noteOn[Program::ModLfoToFilterCutoff] != 0.0f || program.isDynamic(Program::FilterCutoff)
+                        || program.isDynamic(Program::FilterQ) || program.isDynamic(Program::ModLfoToFilterCutoff));
+    modulated_ = program.hasDynamicOps() || lfoActive_;
+
+    modTime_ = 0.0;
+    modRate_ = playbackRate_;
+    modGain_ = 1.0f;
+    modCutoff_ = filterCutoff_;
+    modResonance_ = filterResonance_;
+
+    // Settle on the current inputs, so the first period starts where the note does
+    if (modulated_)
+    {
+        modInputsVersion_ = inputs.version + 1;
+        updateModulation(0);
+    }
+    applyPanGains();
+}
+
+void SamSamplerVoice::updateModulation(int numSamples)
+{
+    using Program = ModulatorProgram;
+
+    const double time = modTime_;
+    modTime_ += numSamples / sampleRate_;
+
+    // Without LFOs nothing moves until an input does
+    if (!lfoActive_ && modInputs_->version == modInputsVersion_)
+        return;
+    modInputsVersion_ = modInputs_->version;
+
+    // Control-rate ops: pitch, level, cutoff and pan as offsets from note-on,
+    // Q and the LFO depths on top of their note-on values
+    std::array<float, Program::TargetCount> targets = modNoteOn_;
+    targets[Program::Pitch] = targets[Program::Attenuation] = 0.0f;
+    targets[Program::FilterCutoff] = targets[Program::Pan] = 0.0f;
+    modProgram_->run(*modInputs_, midiNote_, velocity_, modProgram_->numStatic,
+                     static_cast<int>(modProgram_->ops.size()), targets.data());
+
+    const float vibLfo = lfoActive_ ? modProgram_->vibLfo.valueAt(time) : 0.0f;
+    const float modLfo = lfoActive_ ? modProgram_->modLfo.valueAt(time) : 0.0f;
+
+    const double cents = targets[Program::Pitch] + vibLfo * targets[Program::VibLfoToPitch]
+                       + modLfo * targets[Program::ModLfoToPitch];
+    playbackRate_ = modRate_ * std::exp2(cents / 1200.0);
+    phaseIncrement_ = static_cast<uint64_t>(std::llround(playbackRate_ * phaseScale));
+
+    // At most +12 dB over the note-on level
+    const double attenuation = targets[Program::Attenuation] - modLfo * targets[Program::ModLfoToVolume];
+    modGain_ = static_cast<float>(std::pow(10.0, -std::max(attenuation, -120.0) / 200.0));
+
+    if (modulatesFilter_)
+    {
+        const double filterCents = targets[Program::FilterCutoff] + modLfo * targets[Program::ModLfoToFilterCutoff];
+        modCutoff_ = filterCutoff_ * std::exp2(filterCents / 1200.0);
+        if (modProgram_->isDynamic(Program::FilterQ))
+            modResonance_ = Program::resonanceForQ(targets[Program::FilterQ]);
+    }
+
+    // Pan reaches the mix once per block
+    if (modProgram_->isDynamic(Program::Pan))
+    {
+        modPan_ = (modNoteOn_[Program::Pan] + targets[Program::Pan]) / 500.0;
+        applyPanGains();
+    }
+}
+
+int SamSamplerVoice::renderModulated(float* const* voiceBuffers, int voiceChannels, int numSamples,
+                                     double sampleRate)
+{
+    numFilterTicks_ = 0;
+
+    int rendered = 0;
+    while (rendered < numSamples)
+    {
+        const int period = std::min(controlPeriod_, numSamples - rendered);
+        const float startGain = modGain_;
+        updateModulation(period);
+        if (modulatesFilter_)
+            filterTicks_[static_cast<size_t>(numFilterTicks_++)] = { static_cast<float>(modCutoff_),
+                                                                     static_cast<float>(modResonance_) };
+
+        float* periodBuffers[2] = { voiceBuffers[0] + rendered, voiceBuffers[1] + rendered };
+        const int periodRendered = singlePrecision_
+            ? renderSpans(periodBuffers, voiceChannels, period, sampleRate, envelopeBufferFloat_.data() + rendered)
+            : renderSpans(periodBuffers, voiceChannels, period, sampleRate, envelopeBuffer_.data() + rendered);
+
+        // The level glides from the last update to this one across the period
+        if (startGain != 1.0f || modGain_ != 1.0f)
+        {
+            const float step = (modGain_ - startGain) / static_cast<float>(period);
+            for (int ch = 0; ch < voiceChannels; ++ch)
+            {
+                float gain = startGain;
+                for (int i = 0; i < periodRendered; ++i)
+                {
+                    gain += step;
+                    periodBuffers[ch][i] *= gain;
+                }
+            }
+        }
+
+        rendered += periodRendered;
+        if (periodRendered < period)
+            break;
+    }
+    return rendered;
+}
+
+void SamSamplerVoice::filterModulated(float* const* voiceBuffers, int numSamples)
+{
+    // Each control period jumps to its own setting; the update steps are the smoothing
+    const int channels = filterSplit() ? 1 : blockChannels_;
+    const double spread = filterSpread_ * 0.5;
+
+    int offset = 0;
+    for (int tick = 0; tick < numFilterTicks_ && offset < numSamples; ++tick)
+    {
+        const FilterTick& setting = filterTicks_[static_cast<size_t>(tick)];
+        const int period = std::min(controlPeriod_, numSamples - offset);
+        float* periodBuffers[2] = { voiceBuffers[0] + offset, voiceBuffers[1] + offset };
+
+        filter_.setParameters(setting.cutoff * (1.0 - spread), setting.resonance);
+        filter_.settle();
+        if (singlePrecision_)
+            filter_.processBlock<float>(periodBuffers, channels, period);
+        else
+            filter_.process(periodBuffers, channels, period);
+
+        if (filterSplit())
         {
-            outputs[ch][i] += voiceBuffer[i];
+            filterRight_.setParameters(setting.cutoff * (1.0 + spread), setting.resonance);
+            filterRight_.settle();
+            if (singlePrecision_)
+                filterRight_.processBlock<float>(periodBuffers + 1, 1, period);
+            else
+                filterRight_.process(periodBuffers + 1, 1, period);
         }
+
+        offset += period;
     }
 }
 
+
+
+//==============================================================================
+// ScopedFlushDenormals Implementation
+//==============================================================================
+
+namespace {
+
+#if defined(SAMSAMPLER_SSE)
+constexpr unsigned int mxcsrFlushToZero = 0x8000;
+constexpr unsigned int mxcsrDenormalsAreZero = 0x0040;
+#elif (defined(__aarch64__) || defined(__arm__)) && (defined(__GNUC__) || defined(__clang__))
+constexpr uint64_t armFlushToZero = 1ull << 24;   // FPCR.FZ / FPSCR.FZ
+#endif
+
+} // namespace
+
+ScopedFlushDenormals::ScopedFlushDenormals()
+{
+#if defined(SAMSAMPLER_SSE)
+    const unsigned int state = _mm_getcsr();
+    previousState_ = state;
+    _mm_setcsr(state | mxcsrFlushToZero | mxcsrDenormalsAreZero);
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    uint64_t state;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(state));
+    previousState_ = state;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(state | armFlushToZero));
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+    uint32_t state;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(state));
+    previousState_ = state;
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(static_cast<uint32_t>(state | armFlushToZero)));
+#endif
+}
+
+ScopedFlushDenormals::~ScopedFlushDenormals()
+{
+#if defined(SAMSAMPLER_SSE)
+    _mm_setcsr(static_cast<unsigned int>(previousState_));
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(previousState_));
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(static_cast<uint32_t>(previousState_)));
+#endif
+}
+
 //==============================================================================
-// SF2Reader Implementation (Simplified for Phase 0)
+// RealtimeWorkerPool Implementation
 //==============================================================================
 
-bool SF2Reader::loadFile(const char* filePath)
+namespace {
+
+constexpr int workerSpinIterations = 4000;   // ~tens of microseconds before sleeping
+
+inline uint64_t packWork(uint32_t generation, int numTasks, int next)
+{
+    return (static_cast<uint64_t>(generation) << 32)
+         | (static_cast<uint64_t>(numTasks) << 16)
+         | static_cast<uint64_t>(next);
+}
+
+inline uint32_t workGeneration(uint64_t work) { return static_cast<uint32_t>(work >> 32); }
+inline int workTaskCount(uint64_t work) { return static_cast<int>((work >> 16) & 0xFFFF); }
+inline int workNext(uint64_t work) { return static_cast<int>(work & 0xFFFF); }
+
+inline void spinPause()
 {
-    // For Phase 0, create a simple implementation that loads basic SF2 files
-    // Full SF2 parsing would be implemented here
-    // For now, we'll create dummy samples to test the architecture
+#if defined(SAMSAMPLER_SSE)
+    _mm_pause();
+#elif defined(SAMSAMPLER_NEON) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+} // namespace
+
+void RealtimeWorkerPool::start(int numWorkers)
+{
+    stop();
+    exit_.store(false);
+
+    const int numCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    numWorkers = std::max(0, numWorkers);
+    workers_.reserve(static_cast<size_t>(numWorkers));
 
-    // TODO: Implement full RIFF parsing
-    // For now, return true to indicate "loaded"
-    // In production, this would parse the actual SF2 file format
+#if defined(__APPLE__)
+    if (numWorkers > 0)
+        sleepSemaphore_ = dispatch_semaphore_create(0);
+#endif
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+
+#if defined(__linux__)
+        // One core per worker, leaving core 0 to the host; best effort, the
+        // pool still works unpinned and at normal priority
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET((i + 1) % numCores, &cores);
+        pthread_setaffinity_np(workers_.back().native_handle(), sizeof(cores), &cores);
+
+        sched_param priority {};
+        priority.sched_priority = std::max(1, sched_get_priority_max(SCHED_FIFO) - 10);
+        pthread_setschedparam(workers_.back().native_handle(), SCHED_FIFO, &priority);
+#elif defined(__APPLE__)
+        // Time-constraint policy is the band CoreAudio's IO thread runs in;
+        // aperiodic, since the block size is not known here. Best effort, and
+        // there is no core pinning on Apple platforms.
+        (void)numCores;
+        mach_timebase_info_data_t timebase {};
+        mach_timebase_info(&timebase);
+        const double ticksPerMs = 1.0e6 * timebase.denom / timebase.numer;
+
+        thread_time_constraint_policy_data_t policy {};
+        policy.period = 0;
+        policy.computation = static_cast<uint32_t>(0.5 * ticksPerMs);
+        policy.constraint = static_cast<uint32_t>(2.0 * ticksPerMs);
+        policy.preemptible = 1;
+        thread_policy_set(pthread_mach_thread_np(workers_.back().native_handle()), THREAD_TIME_CONSTRAINT_POLICY,
+                          reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+#else
+        (void)numCores;
+#endif
+    }
+}
+
+void RealtimeWorkerPool::stop()
+{
+    if (workers_.empty())
+        return;
 
-    romName_ = "Default ROM";
-    romVersion_ = "1.0";
+    {
+#if !defined(__APPLE__)
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+#endif
+        exit_.store(true);
+        generation_.fetch_add(1);
+    }
+    wakeWorkers();
 
-    // Create a default instrument
-    Instrument defaultInst;
-    defaultInst.name = "Default Instrument";
-    defaultInst.presetNumber = 0;
-    defaultInst.bank = 0;
+    for (auto& worker : workers_)
+        worker.join();
+    workers_.clear();
 
-    // Create a default zone covering full MIDI range
-    Zone defaultZone;
-    defaultZone.keyRangeLow = 0;
-    defaultZone.keyRangeHigh = 127;
-    defaultZone.velocityRangeLow = 0;
-    defaultZone.velocityRangeHigh = 127;
-    defaultZone.rootKey = 60;
+#if defined(__APPLE__)
+    // Every waiter has returned, so the count is back at or above zero
+    dispatch_release(sleepSemaphore_);
+    sleepSemaphore_ = nullptr;
+#endif
+}
 
-    // Create a simple sine wave sample for testing
-    auto testSample = std::make_unique<Sample>();
-    int testSampleRate = 44100;
-    int duration = testSampleRate; // 1 second
-    testSample->numSamples = duration;
-    testSample->numChannels = 1;
-    testSample->sampleRate = testSampleRate;
-    testSample->rootNote = 60;
-    testSample->audioData.resize(duration);
+void RealtimeWorkerPool::run(int numTasks, Task task, void* context)
+{
+    numTasks = std::min(numTasks, maxTasks);
+    if (numTasks <= 0)
+        return;
 
-    // Generate sine wave using LookupTables
-    for (int i = 0; i < duration; ++i)
+    if (workers_.empty() || numTasks == 1)
     {
-        double t = static_cast<double>(i) / testSampleRate;
-        float phase = static_cast<float>(2.0 * M_PI * 440.0 * t);
-        testSample->audioData[i] = SchillingerEcosystem::DSP::fastSineLookup(phase);
+        for (int i = 0; i < numTasks; ++i)
+            task(context, i);
+        return;
     }
 
-    samples_.push_back(std::move(testSample));
-    defaultZone.sampleIndex = 0;
-    defaultInst.zones.push_back(defaultZone);
-    instruments_.push_back(defaultInst);
+    // Publish: the batch fields are written before the generation that makes
+    // them claimable, and only one batch is live at a time
+    const uint32_t generation = generation_.load(std::memory_order_relaxed) + 1;
+    task_ = task;
+    context_ = context;
+    remaining_.store(numTasks, std::memory_order_relaxed);
+    work_.store(packWork(generation, numTasks, 0), std::memory_order_release);
 
-    return true;
+    generation_.store(generation);
+    if (sleepers_.load() > 0)
+        wakeWorkers();
+
+    runTasks(generation);
+
+    // Tasks still in flight are running on workers; wait them out
+    while (remaining_.load(std::memory_order_acquire) > 0)
+        spinPause();
 }
 
-const SF2Reader::Instrument* SF2Reader::getInstrument(int index) const
+void RealtimeWorkerPool::runTasks(uint32_t generation)
 {
-    if (index >= 0 && index < static_cast<int>(instruments_.size()))
-        return &instruments_[index];
-    return nullptr;
+    uint64_t work = work_.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        // A stale generation or an exhausted batch ends the claim loop
+        if (workGeneration(work) != generation || workNext(work) >= workTaskCount(work))
+            return;
+
+        if (work_.compare_exchange_weak(work, work + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            task_(context_, workNext(work));
+            remaining_.fetch_sub(1, std::memory_order_release);
+            work = work_.load(std::memory_order_acquire);
+        }
+    }
 }
 
-const Sample* SF2Reader::getSample(int index) const
+void RealtimeWorkerPool::workerLoop(int workerIndex)
 {
-    if (index >= 0 && index < static_cast<int>(samples_.size()))
-        return samples_[index].get();
-    return nullptr;
+    (void)workerIndex;
+
+    // Workers only run audio tasks: keep denormals flushed for their lifetime
+    ScopedFlushDenormals noDenormals;
+    uint32_t seen = generation_.load();
+
+    while (!exit_.load())
+    {
+        seen = waitForWork(seen);
+        if (exit_.load())
+            break;
+
+        runTasks(seen);
+    }
 }
 
-const Sample* SF2Reader::findSample(int instrumentIndex, int midiNote, float velocity) const
+uint32_t RealtimeWorkerPool::waitForWork(uint32_t seenGeneration)
 {
-    const Instrument* inst = getInstrument(instrumentIndex);
-    if (!inst)
-        return nullptr;
+    for (int spin = 0; spin < workerSpinIterations; ++spin)
+    {
+        const uint32_t generation = generation_.load(std::memory_order_acquire);
+        if (generation != seenGeneration)
+            return generation;
+        spinPause();
+    }
+
+    // Announce the sleep before the final check, so run() either sees a
+    // sleeper or this thread sees the new generation
+    sleepers_.fetch_add(1);
 
-    // Find zone matching MIDI note and velocity
-    for (const auto& zone : inst->zones)
+#if defined(__linux__)
+    while (generation_.load() == seenGeneration)
     {
-        if (midiNote >= zone.keyRangeLow && midiNote <= zone.keyRangeHigh &&
-            velocity >= zone.velocityRangeLow && velocity <= zone.velocityRangeHigh)
-        {
-            return getSample(zone.sampleIndex);
-        }
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&generation_), FUTEX_WAIT_PRIVATE,
+                seenGeneration, nullptr, nullptr, 0);
+    }
+#elif defined(__APPLE__)
+    // Leftover signals from sleepers that saw the generation first only cost
+    // an extra pass through this loop
+    while (generation_.load() == seenGeneration)
+        dispatch_semaphore_wait(sleepSemaphore_, DISPATCH_TIME_FOREVER);
+#else
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepWake_.wait(lock, [&] { return generation_.load() != seenGeneration; });
     }
+#endif
 
-    return nullptr;
+    sleepers_.fetch_sub(1);
+    return generation_.load(std::memory_order_acquire);
+}
+
+void RealtimeWorkerPool::wakeWorkers()
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&generation_), FUTEX_WAKE_PRIVATE,
+            INT_MAX, nullptr, nullptr, 0);
+#elif defined(__APPLE__)
+    // One signal per announced sleeper; signalling takes no lock, and only
+    // enters the kernel when a thread is actually waiting
+    for (int sleepers = sleepers_.load(); sleepers > 0; --sleepers)
+        dispatch_semaphore_signal(sleepSemaphore_);
+#else
+    // Taking the lock orders this wake after a sleeper's predicate check
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    sleepWake_.notify_all();
+#endif
 }
 
 //==============================================================================
@@ -628,6 +2416,8 @@ SamSamplerDSP::SamSamplerDSP()
 
 SamSamplerDSP::~SamSamplerDSP()
 {
+    renderPool_.stop();
+    stopSampleBuildThread();
     // Voices and SF2 reader automatically cleaned up
 }
 
@@ -636,6 +2426,8 @@ bool SamSamplerDSP::prepare(double sampleRate, int blockSize)
     sampleRate_ = sampleRate;
     blockSize_ = blockSize;
 
+    std::unique_lock<std::mutex> lock(sampleBuildMutex_);
+
     // Load a test sample if no samples are cached
     if (sampleCache_.empty() && sf2Reader_ && !sf2Reader_->isLoaded())
     {
@@ -650,26 +2442,41 @@ bool SamSamplerDSP::prepare(double sampleRate, int blockSize)
             const Sample* sample = sf2Reader_->getSample(0);
             if (sample)
             {
-                // Create a shared copy of the sample
-                auto sampleCopy = std::make_shared<Sample>();
-                sampleCopy->audioData = sample->audioData;
-                sampleCopy->numChannels = sample->numChannels;
-                sampleCopy->sampleRate = sample->sampleRate;
-                sampleCopy->numSamples = sample->numSamples;
-                sampleCopy->rootNote = sample->rootNote;
-                sampleCopy->pitchCorrection = sample->pitchCorrection;
-                sampleCache_.push_back(sampleCopy);
+                // Create a shared copy of the sample (guard frames included)
+                nativeSamples_.push_back(std::make_shared<const Sample>(*sample));
+                sampleCache_.push_back(std::make_shared<Sample>(*sample));
             }
         }
     }
 
+    // Convert to the new engine rate (only samples not already there), then
+    // bake loop seams and mip levels; later edits are rebuilt on the build thread
+    requestedSampleRate_.store(static_cast<int>(std::lround(sampleRate)));
+    resampleDirty_.store(false);
+    resampleSamplesLocked();
+    rebuildSamplePyramidsLocked();
+    rebuildLoopRegionsLocked();
+    lock.unlock();
+    startSampleBuildThread();
+
+    // Filter bank scratch and render workers for parallel voice rendering
+    filterBank_.prepare(blockSize);
+
+    if (renderPool_.getNumWorkers() != params_.renderThreads)
+    {
+        if (params_.renderThreads > 0)
+            renderPool_.start(params_.renderThreads);
+        else
+            renderPool_.stop();
+    }
+
     // Reset all voices to inactive state and prepare filters
     for (auto& voice : voices_)
     {
         if (voice) {
             voice->reset();
             // Note: Filter is prepared in voice constructor with default sample rate
-            // Could add voice->prepare(sampleRate) if needed
+            voice->prepare(sampleRate, blockSize);
         }
     }
 
@@ -687,10 +2494,17 @@ void SamSamplerDSP::reset()
     }
 
     pitchBend_ = 0.0;
+    for (auto& part : parts_)
+        part.inputs.resetControllers();
 }
 
 void SamSamplerDSP::process(float** outputs, int numChannels, int numSamples)
 {
+    // Hosts without their own denormal guard (AUv3 bridge, headless) call straight in
+    ScopedFlushDenormals noDenormals;
+
+    const auto renderStart = params_.cpuGovernor ? std::chrono::steady_clock::now()
+                                                 : std::chrono::steady_clock::time_point();
     // Clear output buffers
     for (int ch = 0; ch < numChannels; ++ch)
     {
@@ -698,28 +2512,481 @@ void SamSamplerDSP::process(float** outputs, int numChannels, int numSamples)
     }
 
     // Process all active voices
-    int activeCount = 0;
+    const int activeCount = getActiveVoiceCount();
+    if (activeCount > 0)
+        renderVoices(outputs, numChannels, numSamples);
+
+    // Aux buses follow the main bus; width applies per stereo pair, effects to the main bus only
+    const int auxOutputs = auxOutputCount(numChannels);
+    const int mainChannels = numChannels - 2 * auxOutputs;
+
+    // With no voice playing the block is already silent
+    if (activeCount > 0)
+    {
+        applyStereoWidth(outputs, mainChannels, numSamples);
+        for (int bus = 0; bus < auxOutputs; ++bus)
+            applyStereoWidth(outputs + mainChannels + 2 * bus, 2, numSamples);
+
+        // Apply master volume
+        float masterVol = static_cast<float>(params_.masterVolume);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputs[ch][i] *= masterVol;
+            }
+        }
+    }
+
+    // Apply effects (Phase 2)
+    // applyEffects(outputs, mainChannels, numSamples);
+
+    if (params_.cpuGovernor)
+    {
+        const std::chrono::duration<double> renderTime = std::chrono::steady_clock::now() - renderStart;
+        updateGovernor(renderTime.count(), numSamples);
+    }
+}
+
+//==============================================================================
+// CPU Governor
+//==============================================================================
+
+void SamSamplerDSP::updateGovernor(double renderSeconds, int numSamples)
+{
+    const double blockSeconds = static_cast<double>(std::max(numSamples, 1)) / sampleRate_;
+    governorLoad_ = renderSeconds / blockSeconds;
+
+    // Step down at once under pressure; step up only after ~250 ms of headroom,
+    // at half the budget, so the governor doesn't oscillate around the limit
+    if (governorLoad_ > params_.cpuBudget)
+    {
+        governorHeadroomBlocks_ = 0;
+        if (governorLevel_ < GovernorPolyphony)
+        {
+            ++governorLevel_;
+            applyGovernorLevel();
+        }
+
+        if (governorLevel_ == GovernorPolyphony)
+            releaseQuietestVoice();
+    }
+    else if (governorLoad_ < params_.cpuBudget * 0.5 && governorLevel_ > GovernorFull)
+    {
+        const int restoreBlocks = static_cast<int>(std::ceil(0.25 / blockSeconds));
+        if (++governorHeadroomBlocks_ >= restoreBlocks)
+        {
+            governorHeadroomBlocks_ = 0;
+            --governorLevel_;
+            applyGovernorLevel();
+        }
+    }
+    else
+    {
+        governorHeadroomBlocks_ = 0;
+    }
+}
+
+void SamSamplerDSP::applyGovernorLevel()
+{
+    int quality = params_.interpolationQuality;
+    if (governorLevel_ >= GovernorLinear)
+        quality = SamSamplerVoice::Linear;
+    else if (governorLevel_ >= GovernorCubic)
+        quality = std::min(quality, static_cast<int>(SamSamplerVoice::Cubic));
+
+    const int filterInterval = governorLevel_ >= GovernorFilterRate ? 4 : 1;
+
     for (auto& voice : voices_)
     {
-        if (voice && voice->isActive())
+        voice->setInterpolationQuality(quality);
+        voice->setFilterUpdateInterval(filterInterval);
+    }
+
+    if (governorLevel_ >= GovernorPolyphony)
+    {
+        // Hold polyphony where it is; new notes steal rather than add load
+        governorVoiceLimit_ = std::min(governorVoiceLimit_, std::max(1, getActiveVoiceCount()));
+    }
+    else
+    {
+        governorVoiceLimit_ = maxVoices_;
+    }
+}
+
+void SamSamplerDSP::releaseQuietestVoice()
+{
+    SamSamplerVoice* quietest = nullptr;
+    for (auto& voice : voices_)
+    {
+        if (voice->isActive() && !voice->isReleasing()
+            && (!quietest || voice->getCurrentGain() < quietest->getCurrentGain()))
+            quietest = voice.get();
+    }
+
+    if (quietest)
+    {
+        quietest->releaseQuickly(0.01);
+        governorVoiceLimit_ = std::max(1, governorVoiceLimit_ - 1);
+    }
+}
+
+void SamSamplerDSP::renderVoices(float** outputs, int numChannels, int numSamples)
+{
+    int numActive = 0;
+    for (int v = 0; v < maxVoices_; ++v)
+    {
+        if (voices_[static_cast<size_t>(v)]->isActive())
+            activeVoiceIndices_[static_cast<size_t>(numActive++)] = v;
+    }
+
+    renderSamples_ = numSamples;
+    if (!renderVoicesParallel(numActive, numSamples))
+    {
+        for (int n = 0; n < numActive; ++n)
+            renderVoiceTask(this, n);
+    }
+
+    // Single-precision filters run side by side, four channels per pass
+    if (params_.filterBank)
+    {
+        for (int n = 0; n < numActive; ++n)
         {
-            voice->process(outputs, numChannels, numSamples, sampleRate_);
-            activeCount++;
+            auto& voice = voices_[static_cast<size_t>(activeVoiceIndices_[static_cast<size_t>(n)])];
+            if (voice->wantsFilterBank())
+                voice->addToFilterBank(filterBank_, numSamples);
         }
+        filterBank_.flush();
     }
 
-    // Apply master volume
-    float masterVol = static_cast<float>(params_.masterVolume);
-    for (int ch = 0; ch < numChannels; ++ch)
+    // Ordered summation: the same additions, in the same order, however the
+    // rendering was split. Each voice accumulates straight into its own bus.
+    const int auxOutputs = auxOutputCount(numChannels);
+    const int mainChannels = numChannels - 2 * auxOutputs;
+    for (int n = 0; n < numActive; ++n)
     {
-        for (int i = 0; i < numSamples; ++i)
+        auto& voice = voices_[static_cast<size_t>(activeVoiceIndices_[static_cast<size_t>(n)])];
+        const int bus = voice->getOutputBus();
+        if (bus > 0 && bus <= auxOutputs)
+            voice->mixBlock(outputs + mainChannels + 2 * (bus - 1), 2, numSamples, sampleRate_);
+        else
+            voice->mixBlock(outputs, mainChannels, numSamples, sampleRate_);
+    }
+}
+
+int SamSamplerDSP::auxOutputCount(int numChannels) const
+{
+    // The main bus keeps at least one channel
+    return std::max(0, std::min(params_.auxOutputs, (numChannels - 1) / 2));
+}
+
+void SamSamplerDSP::setOutputGroup(int lowKey, int highKey, int bus)
+{
+    lowKey = std::max(0, lowKey);
+    highKey = std::min(127, highKey);
+    bus = std::max(0, std::min(maxAuxOutputs, bus));
+
+    for (int key = lowKey; key <= highKey; ++key)
+        outputGroups_[static_cast<size_t>(key)] = static_cast<std::uint8_t>(bus);
+}
+
+void SamSamplerDSP::clearOutputGroups()
+{
+    outputGroups_.fill(0);
+}
+
+int SamSamplerDSP::getOutputGroup(int midiNote) const
+{
+    if (midiNote < 0 || midiNote > 127)
+        return 0;
+    return outputGroups_[static_cast<size_t>(midiNote)];
+}
+
+//==============================================================================
+// Multi-Timbral Parts
+//==============================================================================
+
+void SamSamplerDSP::noteOn(int midiNote, float velocity, int midiChannel)
+{
+    startVoice(midiNote, velocity, partForChannel(midiChannel));
+}
+
+void SamSamplerDSP::noteOff(int midiNote, float velocity, int midiChannel)
+{
+    SamSamplerVoice* voice = findVoiceForNote(midiNote, partForChannel(midiChannel));
+    if (voice)
+        voice->stopNote(velocity);
+}
+
+void SamSamplerDSP::controlChange(int controller, float value, int midiChannel)
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return;
+
+    // Every controller is a modulator source for the part's voices
+    ModulatorInputs& inputs = parts_[static_cast<size_t>(partForChannel(midiChannel))].inputs;
+    if (controller == 121)
+    {
+        inputs.resetControllers();
+    }
+    else if (controller >= 0 && controller < 128)
+    {
+        inputs.controllers[static_cast<size_t>(controller)] = clamp(value, 0.0f, 1.0f);
+        ++inputs.version;
+    }
+
+    // GM: CC 7 is a squared (40 log10) volume curve, CC 10 centers at 64
+    if (controller == 7)
+        setPartVolume(midiChannel, value * value);
+    else if (controller == 10)
+        setPartPan(midiChannel, (value * 127.0f - 64.0f) / 63.0f);
+}
+
+void SamSamplerDSP::pitchBend(float value, int midiChannel)
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return;
+
+    ModulatorInputs& inputs = parts_[static_cast<size_t>(partForChannel(midiChannel))].inputs;
+    inputs.pitchWheel = (clamp(value, -1.0f, 1.0f) + 1.0f) * 0.5f;
+    ++inputs.version;
+}
+
+void SamSamplerDSP::channelPressure(float pressure, int midiChannel)
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return;
+
+    ModulatorInputs& inputs = parts_[static_cast<size_t>(partForChannel(midiChannel))].inputs;
+    inputs.channelPressure = clamp(pressure, 0.0f, 1.0f);
+    ++inputs.version;
+}
+
+void SamSamplerDSP::applyPitchBendRange()
+{
+    // The default pitch wheel modulator scales by the sensitivity source
+    for (auto& part : parts_)
+    {
+        part.inputs.pitchWheelSensitivity = static_cast<float>(params_.pitchBendRange / 127.0);
+        ++part.inputs.version;
+    }
+}
+
+bool SamSamplerDSP::setPartInstrument(int midiChannel, int instrumentIndex)
+{
+    if (midiChannel < 1 || midiChannel > numParts || instrumentIndex < 0
+        || (sf2Reader_ && instrumentIndex >= sf2Reader_->getInstrumentCount()))
+        return false;
+
+    // Sounding notes keep their samples; the next note-on plays the new instrument
+    parts_[static_cast<size_t>(midiChannel - 1)].instrument = instrumentIndex;
+    return true;
+}
+
+void SamSamplerDSP::setPartVolume(int midiChannel, float volume)
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return;
+
+    parts_[static_cast<size_t>(midiChannel - 1)].volume = clamp(volume, 0.0f, 1.0f);
+    updatePartVoices(midiChannel - 1);
+}
+
+void SamSamplerDSP::setPartPan(int midiChannel, float pan)
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return;
+
+    parts_[static_cast<size_t>(midiChannel - 1)].pan = clamp(pan, -1.0f, 1.0f);
+    updatePartVoices(midiChannel - 1);
+}
+
+int SamSamplerDSP::getPartInstrument(int midiChannel) const
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return 0;
+    return parts_[static_cast<size_t>(midiChannel - 1)].instrument;
+}
+
+float SamSamplerDSP::getPartVolume(int midiChannel) const
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return 0.0f;
+    return static_cast<float>(parts_[static_cast<size_t>(midiChannel - 1)].volume);
+}
+
+float SamSamplerDSP::getPartPan(int midiChannel) const
+{
+    if (midiChannel < 1 || midiChannel > numParts)
+        return 0.0f;
+    return static_cast<float>(parts_[static_cast<size_t>(midiChannel - 1)].pan);
+}
+
+int SamSamplerDSP::partForChannel(int midiChannel) const
+{
+    if (!params_.multiTimbral || midiChannel < 1 || midiChannel > numParts)
+        return 0;
+    return midiChannel - 1;
+}
+
+int SamSamplerDSP::partInstrument(int part) const
+{
+    return params_.multiTimbral ? parts_[static_cast<size_t>(part)].instrument : currentSoundFontInstrument_;
+}
+
+double SamSamplerDSP::partVolume(int part) const
+{
+    return params_.multiTimbral ? parts_[static_cast<size_t>(part)].volume : 1.0;
+}
+
+void SamSamplerDSP::startVoice(int midiNote, float velocity, int part)
+{
+    // The zone's flattened record picks the sample; a loaded SoundFont with
+    // no zone for this key and velocity plays nothing
+    const SF2Reader::Zone* zone = nullptr;
+    if (sf2Reader_ && sf2Reader_->isLoaded())
+    {
+        zone = sf2Reader_->findZone(partInstrument(part), midiNote, velocity * 127.0f);
+        if (!zone)
+            return;
+    }
+
+    SamSamplerVoice* voice = findFreeVoice();
+    if (voice)
+    {
+        const size_t sampleIndex = zone ? static_cast<size_t>(zone->sampleIndex) : 0;
+        std::shared_ptr<Sample> samplePtr;
+        if (sampleIndex < sampleCache_.size())
+        {
+            samplePtr = std::atomic_load(&sampleCache_[sampleIndex]);
+        }
+
+        // SoundFont zones bring their own tuning, level, envelope and filter
+        const bool zoneParameters = zone && zone->hasGenerators;
+
+        // Their modulators' note-on ops run once here; the voice runs the rest
+        using Program = ModulatorProgram;
+        ModulatorInputs& inputs = parts_[static_cast<size_t>(part)].inputs;
+        std::array<float, Program::TargetCount> modTargets {};
+        if (zoneParameters)
+        {
+            modTargets = zone->modulators.initial;
+            zone->modulators.run(inputs, midiNote, velocity, 0, zone->modulators.numStatic, modTargets.data());
+
+            // Total attenuation stays at or above 0 dB
+            modTargets[Program::Attenuation] = std::max(modTargets[Program::Attenuation], -10.0f * zone->attenuation);
+        }
+
+        voice->setMipMapping(params_.mipMapping);
+        if (zoneParameters)
+            voice->startNote(midiNote, velocity, samplePtr, zone->pitchCents(midiNote) + modTargets[Program::Pitch]);
+        else
+            voice->startNote(midiNote, velocity, samplePtr);
+        if (zoneParameters)
+            voice->setLooping(zone->sampleMode != 0, zone->sampleMode == 3);
+        else
+            voice->setLooping(params_.loopEnabled);
+        voice->setFixedPointPhase(params_.fixedPointPhase);
+        voice->setSinglePrecision(params_.singlePrecision);
+        voice->setStereoEnhancement(params_.stereoPositionOffset * SamSamplerVoice::maxStereoOffsetSeconds,
+                                    params_.stereoFilterSpread);
+        voice->setPan(voicePan(midiNote, velocity, part), voiceGain(zone, part));
+        voice->setPart(part);
+        voice->setOutputBus(getOutputGroup(midiNote));
+        voice->setSilenceThreshold(params_.silenceThreshold <= -160.0
+                                   ? 0.0 : std::pow(10.0, params_.silenceThreshold / 20.0));
+
+        // Apply filter settings if enabled (the engine filter overrides the zone's)
+        if (params_.filterEnabled)
+        {
+            FilterType type = static_cast<FilterType>(params_.filterType);
+            voice->setFilterParameters(params_.filterCutoff, params_.filterResonance, type);
+        }
+        else if (zoneParameters)
+        {
+            const Program& program = zone->modulators;
+            const double cutoff = std::min(20000.0, zone->filterCutoff * std::exp2(modTargets[Program::FilterCutoff] / 1200.0));
+            const bool filterMoves = modTargets[Program::ModLfoToFilterCutoff] != 0.0f
+                || program.isDynamic(Program::FilterCutoff) || program.isDynamic(Program::FilterQ)
+                || program.isDynamic(Program::ModLfoToFilterCutoff);
+            if (cutoff < SF2Reader::Zone::filterOpenHz || filterMoves)
+                voice->setFilterParameters(cutoff, Program::resonanceForQ(modTargets[Program::FilterQ]), FilterType::Lowpass);
+            else
+                voice->clearFilter();
+        }
+        else
+        {
+            voice->clearFilter();
+        }
+
+        // Apply envelope settings
+        if (zoneParameters)
         {
-            outputs[ch][i] *= masterVol;
+            // SF2 attacks are linear in amplitude, decay and release linear in dB
+            const double keyOffset = 60.0 - midiNote;
+            voice->setEnvelopeParameters(zone->envAttack,
+                                         zone->envHold * std::exp2(keyOffset * zone->envHoldKeyScale / 1200.0),
+                                         zone->envDecay * std::exp2(keyOffset * zone->envDecayKeyScale / 1200.0),
+                                         zone->envSustain, zone->envRelease,
+                                         EnvelopeCurve::Linear, EnvelopeCurve::Exponential,
+                                         EnvelopeCurve::Exponential);
+
+            // After the pan, filter and playback rate it modulates
+            voice->setControlPeriod(params_.controlPeriod);
+            voice->setModulation(zone->modulators, inputs, modTargets.data(), !params_.filterEnabled);
         }
+        else
+        {
+            EnvelopeCurve attackCurve = static_cast<EnvelopeCurve>(params_.envAttackCurve);
+            EnvelopeCurve decayCurve = static_cast<EnvelopeCurve>(params_.envDecayCurve);
+            EnvelopeCurve releaseCurve = static_cast<EnvelopeCurve>(params_.envReleaseCurve);
+            voice->setEnvelopeParameters(params_.envAttack, params_.envHold, params_.envDecay,
+                                         params_.envSustain, params_.envRelease,
+                                         attackCurve, decayCurve, releaseCurve);
+        }
+    }
+}
+
+double SamSamplerDSP::voiceGain(const SF2Reader::Zone* zone, int part) const
+{
+    const double gain = partVolume(part);
+    if (zone && zone->hasGenerators && zone->attenuation > 0.0f)
+        return gain * std::pow(10.0, -zone->attenuation / 20.0);
+    return gain;
+}
+
+void SamSamplerDSP::updatePartVoices(int part)
+{
+    // Volume and pan live in the voice's output gains, so a change is one gain update per voice
+    for (auto& voice : voices_)
+    {
+        if (!voice->isActive() || voice->getPart() != part)
+            continue;
+
+        const SF2Reader::Zone* zone = sf2Reader_ ? sf2Reader_->findZone(partInstrument(part), voice->getMidiNote(),
+                                                                         voice->getVelocity() * 127.0f) : nullptr;
+        voice->setPan(voicePan(voice->getMidiNote(), voice->getVelocity(), part), voiceGain(zone, part));
     }
+}
 
-    // Apply effects (Phase 2)
-    // applyEffects(outputs, numChannels, numSamples);
+void SamSamplerDSP::renderVoiceTask(void* context, int index)
+{
+    auto* self = static_cast<SamSamplerDSP*>(context);
+    auto& voice = self->voices_[static_cast<size_t>(self->activeVoiceIndices_[static_cast<size_t>(index)])];
+
+    if (voice->renderBlock(self->renderSamples_, self->sampleRate_)
+        && !(self->params_.filterBank && voice->wantsFilterBank()))
+        voice->filterBlock(self->renderSamples_);
+}
+
+bool SamSamplerDSP::renderVoicesParallel(int numActive, int numSamples)
+{
+    // Oversized blocks would grow voice scratch on a worker; keep them serial
+    if (renderPool_.getNumWorkers() == 0 || numActive < 2 || numSamples > blockSize_)
+        return false;
+
+    renderPool_.run(numActive, &SamSamplerDSP::renderVoiceTask, this);
+    return true;
 }
 
 void SamSamplerDSP::handleEvent(const ScheduledEvent& event)
@@ -728,33 +2995,7 @@ void SamSamplerDSP::handleEvent(const ScheduledEvent& event)
     {
         case ScheduledEvent::NOTE_ON:
         {
-            SamSamplerVoice* voice = findFreeVoice();
-            if (voice)
-            {
-                // Get sample from cache (for now, just use the first cached sample)
-                std::shared_ptr<Sample> samplePtr;
-                if (!sampleCache_.empty())
-                {
-                    samplePtr = sampleCache_[0];
-                }
-
-                voice->startNote(event.data.note.midiNote, event.data.note.velocity, samplePtr);
-
-                // Apply filter settings if enabled
-                if (params_.filterEnabled)
-                {
-                    FilterType type = static_cast<FilterType>(params_.filterType);
-                    voice->setFilterParameters(params_.filterCutoff, params_.filterResonance, type);
-                }
-
-                // Apply envelope settings
-                EnvelopeCurve attackCurve = static_cast<EnvelopeCurve>(params_.envAttackCurve);
-                EnvelopeCurve decayCurve = static_cast<EnvelopeCurve>(params_.envDecayCurve);
-                EnvelopeCurve releaseCurve = static_cast<EnvelopeCurve>(params_.envReleaseCurve);
-                voice->setEnvelopeParameters(params_.envAttack, params_.envHold, params_.envDecay,
-                                             params_.envSustain, params_.envRelease,
-                                             attackCurve, decayCurve, releaseCurve);
-            }
+            startVoice(event.data.note.midiNote, event.data.note.velocity, 0);
             break;
         }
 
@@ -768,17 +3009,23 @@ void SamSamplerDSP::handleEvent(const ScheduledEvent& event)
             break;
         }
 
+        case ScheduledEvent::CONTROL_CHANGE:
+        {
+            controlChange(event.data.controlChange.controllerNumber, event.data.controlChange.value);
+            break;
+        }
+
         case ScheduledEvent::PITCH_BEND:
         {
+            // Voices follow through their modulators at the next control period
             pitchBend_ = event.data.pitchBend.bendValue;
-            // Update active voices
-            for (auto& voice : voices_)
-            {
-                if (voice && voice->isActive())
-                {
-                    // Voice will use pitchBend_ in next process call
-                }
-            }
+            pitchBend(event.data.pitchBend.bendValue);
+            break;
+        }
+
+        case ScheduledEvent::CHANNEL_PRESSURE:
+        {
+            channelPressure(event.data.channelPressure.pressure);
             break;
         }
 
@@ -804,6 +3051,79 @@ float SamSamplerDSP::getParameter(const char* paramId) const
     if (std::strcmp(paramId, "basePitch") == 0)
         return static_cast<float>(params_.basePitch);
 
+    if (std::strcmp(paramId, "fixedPointPhase") == 0)
+        return params_.fixedPointPhase ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "singlePrecision") == 0)
+        return params_.singlePrecision ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "filterBank") == 0)
+        return params_.filterBank ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "stereoWidth") == 0)
+        return static_cast<float>(params_.stereoWidth);
+
+    if (std::strcmp(paramId, "stereoPositionOffset") == 0)
+        return static_cast<float>(params_.stereoPositionOffset);
+
+    if (std::strcmp(paramId, "stereoFilterSpread") == 0)
+        return static_cast<float>(params_.stereoFilterSpread);
+
+    if (std::strcmp(paramId, "pan") == 0)
+        return static_cast<float>(params_.pan);
+
+    if (std::strcmp(paramId, "panKeySpread") == 0)
+        return static_cast<float>(params_.panKeySpread);
+
+    if (std::strcmp(paramId, "auxOutputs") == 0)
+        return static_cast<float>(params_.auxOutputs);
+
+    if (std::strcmp(paramId, "multiTimbral") == 0)
+        return params_.multiTimbral ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "controlPeriod") == 0)
+        return static_cast<float>(params_.controlPeriod);
+
+    if (std::strcmp(paramId, "interpolationQuality") == 0)
+        return static_cast<float>(params_.interpolationQuality);
+
+    if (std::strcmp(paramId, "mipMapping") == 0)
+        return params_.mipMapping ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "resampleOnLoad") == 0)
+        return params_.resampleOnLoad ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "renderThreads") == 0)
+        return static_cast<float>(params_.renderThreads);
+
+    if (std::strcmp(paramId, "silenceThreshold") == 0)
+        return static_cast<float>(params_.silenceThreshold);
+
+    if (std::strcmp(paramId, "cpuGovernor") == 0)
+        return params_.cpuGovernor ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "cpuBudget") == 0)
+        return static_cast<float>(params_.cpuBudget);
+
+    // Read-only governor meters
+    if (std::strcmp(paramId, "cpuLoad") == 0)
+        return static_cast<float>(governorLoad_);
+
+    if (std::strcmp(paramId, "governorLevel") == 0)
+        return static_cast<float>(governorLevel_);
+
+    if (std::strcmp(paramId, "loopEnabled") == 0)
+        return params_.loopEnabled ? 1.0f : 0.0f;
+
+    if (std::strcmp(paramId, "loopStart") == 0)
+        return static_cast<float>(params_.loopStart);
+
+    if (std::strcmp(paramId, "loopEnd") == 0)
+        return static_cast<float>(params_.loopEnd);
+
+    if (std::strcmp(paramId, "crossfade") == 0)
+        return static_cast<float>(params_.crossfade);
+
     if (std::strcmp(paramId, "envAttack") == 0)
         return static_cast<float>(params_.envAttack);
 
@@ -858,6 +3178,7 @@ void SamSamplerDSP::setParameter(const char* paramId, float value)
     if (std::strcmp(paramId, "pitchBendRange") == 0)
     {
         params_.pitchBendRange = clamp(value, 0.0f, 24.0f);
+        applyPitchBendRange();
         LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
         return;
     }
@@ -869,6 +3190,198 @@ void SamSamplerDSP::setParameter(const char* paramId, float value)
         return;
     }
 
+    if (std::strcmp(paramId, "fixedPointPhase") == 0)
+    {
+        params_.fixedPointPhase = (value > 0.5f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "singlePrecision") == 0)
+    {
+        // Applied to voices at note-on
+        params_.singlePrecision = (value > 0.5f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "filterBank") == 0)
+    {
+        params_.filterBank = (value > 0.5f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "stereoWidth") == 0)
+    {
+        params_.stereoWidth = clamp(value, 0.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "stereoPositionOffset") == 0)
+    {
+        // Applied to voices at note-on
+        params_.stereoPositionOffset = clamp(value, 0.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "stereoFilterSpread") == 0)
+    {
+        // Applied to voices at note-on
+        params_.stereoFilterSpread = clamp(value, 0.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "pan") == 0)
+    {
+        // Applied to voices at note-on
+        params_.pan = clamp(value, -1.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "panKeySpread") == 0)
+    {
+        // Applied to voices at note-on
+        params_.panKeySpread = clamp(value, 0.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "auxOutputs") == 0)
+    {
+        // Channel layout of process(); set by the host wrapper from its enabled buses
+        params_.auxOutputs = static_cast<int>(clamp(value, 0.0f, static_cast<float>(maxAuxOutputs)));
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "multiTimbral") == 0)
+    {
+        // Applied to voices at note-on
+        params_.multiTimbral = value > 0.5f;
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "controlPeriod") == 0)
+    {
+        // Applied to voices at note-on
+        params_.controlPeriod = clamp(static_cast<int>(std::lround(value)), 16, 64);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "silenceThreshold") == 0)
+    {
+        // Applied to voices at note-on
+        params_.silenceThreshold = clamp(value, -160.0f, -40.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "cpuGovernor") == 0)
+    {
+        bool enabled = (value > 0.5f);
+        if (enabled != params_.cpuGovernor)
+        {
+            params_.cpuGovernor = enabled;
+            governorLevel_ = GovernorFull;
+            governorHeadroomBlocks_ = 0;
+            applyGovernorLevel();
+        }
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "cpuBudget") == 0)
+    {
+        params_.cpuBudget = clamp(value, 0.0f, 1.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "renderThreads") == 0)
+    {
+        // Threads are started and stopped by prepare(), never here
+        params_.renderThreads = clamp(static_cast<int>(std::lround(value)), 0, 15);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "resampleOnLoad") == 0)
+    {
+        bool enabled = (value > 0.5f);
+        if (enabled != params_.resampleOnLoad)
+        {
+            params_.resampleOnLoad = enabled;
+            requestedResampling_.store(enabled);
+            resampleDirty_.store(true);
+        }
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "mipMapping") == 0)
+    {
+        bool enabled = (value > 0.5f);
+        if (enabled != params_.mipMapping)
+        {
+            params_.mipMapping = enabled;
+            requestedMipMapping_.store(enabled);
+            pyramidsDirty_.store(true);
+        }
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "interpolationQuality") == 0)
+    {
+        int quality = clamp(static_cast<int>(std::lround(value)),
+                            static_cast<int>(SamSamplerVoice::Linear), static_cast<int>(SamSamplerVoice::Sinc32));
+        if (quality != params_.interpolationQuality)
+        {
+            params_.interpolationQuality = quality;
+            applyGovernorLevel();   // The governor may be capping quality
+        }
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "loopEnabled") == 0)
+    {
+        params_.loopEnabled = (value > 0.5f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "loopStart") == 0)
+    {
+        params_.loopStart = clamp(value, 0.0f, 1.0f);
+        requestLoopRebuild();
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "loopEnd") == 0)
+    {
+        params_.loopEnd = clamp(value, 0.0f, 1.0f);
+        requestLoopRebuild();
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
+    if (std::strcmp(paramId, "crossfade") == 0)
+    {
+        params_.crossfade = clamp(value, 0.0f, 0.5f);
+        requestLoopRebuild();
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
     if (std::strcmp(paramId, "envAttack") == 0)
     {
         params_.envAttack = clamp(value, 0.001f, 5.0f);
@@ -1044,7 +3557,10 @@ bool SamSamplerDSP::loadPreset(const char* jsonData)
         params_.masterVolume = value;
 
     if (parseJsonParameter(jsonData, "pitchBendRange", value))
+    {
         params_.pitchBendRange = value;
+        applyPitchBendRange();
+    }
 
     if (parseJsonParameter(jsonData, "envAttack", value))
         params_.envAttack = value;
@@ -1081,7 +3597,29 @@ bool SamSamplerDSP::loadSoundFont(const char* filePath)
     if (!sf2Reader_)
         sf2Reader_ = std::make_unique<SF2Reader>();
 
-    return sf2Reader_->loadFile(filePath);
+    // Voices point into the zones being replaced
+    for (auto& voice : voices_)
+        voice->reset();
+
+    if (!sf2Reader_->loadFile(filePath))
+        return false;
+
+    // Zone sample indices address the cache, so it mirrors the reader's samples
+    std::lock_guard<std::mutex> lock(sampleBuildMutex_);
+    nativeSamples_.clear();
+    sampleCache_.clear();
+    for (int i = 0; i < sf2Reader_->getSampleCount(); ++i)
+    {
+        const Sample* sample = sf2Reader_->getSample(i);
+        nativeSamples_.push_back(sample ? std::make_shared<const Sample>(*sample) : nullptr);
+        sampleCache_.push_back(sample ? std::make_shared<Sample>(*sample) : nullptr);
+    }
+
+    currentSoundFontInstrument_ = 0;
+    resampleSamplesLocked();
+    rebuildSamplePyramidsLocked();
+    rebuildLoopRegionsLocked();
+    return true;
 }
 
 int SamSamplerDSP::getSoundFontInstrumentCount() const
@@ -1112,12 +3650,277 @@ bool SamSamplerDSP::selectSoundFontInstrument(int index)
     return false;
 }
 
+void SamSamplerDSP::rebuildLoopRegions()
+{
+    std::lock_guard<std::mutex> lock(sampleBuildMutex_);
+    rebuildLoopRegionsLocked();
+}
+
+void SamSamplerDSP::resampleSamples()
+{
+    std::lock_guard<std::mutex> lock(sampleBuildMutex_);
+    resampleSamplesLocked();
+}
+
+void SamSamplerDSP::rebuildSamplePyramids()
+{
+    std::lock_guard<std::mutex> lock(sampleBuildMutex_);
+    rebuildSamplePyramidsLocked();
+    rebuildLoopRegionsLocked();
+}
+
+//==============================================================================
+// Sample Build Thread
+//==============================================================================
+
+void SamSamplerDSP::startSampleBuildThread()
+{
+    if (sampleBuildThread_.joinable())
+        return;
+
+    sampleBuildExit_.store(false);
+    sampleBuildThread_ = std::thread([this] { sampleBuildLoop(); });
+}
+
+void SamSamplerDSP::stopSampleBuildThread()
+{
+    if (!sampleBuildThread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(sampleBuildMutex_);
+        sampleBuildExit_.store(true);
+    }
+    sampleBuildWake_.notify_all();
+    sampleBuildThread_.join();
+}
+
+void SamSamplerDSP::sampleBuildLoop()
+{
+    std::unique_lock<std::mutex> lock(sampleBuildMutex_);
+
+    while (!sampleBuildExit_.load())
+    {
+        // The audio thread never notifies (that could block), so poll for requests
+        sampleBuildWake_.wait_for(lock, std::chrono::milliseconds(20));
+
+        // Converted samples arrive with their seams and levels already built
+        if (resampleDirty_.exchange(false))
+            resampleSamplesLocked();
+
+        // New levels need seams too, so pyramids go first
+        const bool pyramidsChanged = pyramidsDirty_.exchange(false);
+        if (pyramidsChanged)
+            rebuildSamplePyramidsLocked();
+
+        if (loopRegionsDirty_.exchange(false) || pyramidsChanged)
+            rebuildLoopRegionsLocked();
+    }
+}
+
+void SamSamplerDSP::requestLoopRebuild()
+{
+    const float start = static_cast<float>(params_.loopStart);
+    const float end = static_cast<float>(params_.loopEnd);
+    const float crossfade = static_cast<float>(params_.crossfade);
+
+    // Hosts push every parameter every block; only real edits trigger a rebake
+    if (start == requestedLoopStart_.load() && end == requestedLoopEnd_.load()
+        && crossfade == requestedCrossfade_.load())
+        return;
+
+    requestedLoopStart_.store(start);
+    requestedLoopEnd_.store(end);
+    requestedCrossfade_.store(crossfade);
+    loopRegionsDirty_.store(true);
+}
+
+void SamSamplerDSP::rebuildLoopRegionsLocked()
+{
+    for (auto& sample : sampleCache_)
+    {
+        if (sample && sample->isValid())
+            bakeLoopRegion(*sample);
+    }
+}
+
+void SamSamplerDSP::bakeLoopRegion(Sample& sample) const
+{
+    const double start = requestedLoopStart_.load();
+    const double end = requestedLoopEnd_.load();
+    const double crossfade = requestedCrossfade_.load();
+
+    auto bake = [&](Sample& target) {
+        // SoundFont loops are hard loops at their own points, baked once
+        if (target.ownLoop)
+        {
+            if (!std::atomic_load(&target.loopRegion))
+                std::atomic_store(&target.loopRegion, LoopRegion::create(target, target.loopStart, target.loopEnd, 0));
+            return;
+        }
+
+        const int loopStart = static_cast<int>(start * target.numSamples);
+        const int loopEnd = static_cast<int>(end * target.numSamples);
+        const int crossfadeFrames = static_cast<int>(crossfade * target.sampleRate);
+
+        // Voices holding the previous region keep it alive until they finish
+        std::atomic_store(&target.loopRegion, LoopRegion::create(target, loopStart, loopEnd, crossfadeFrames));
+    };
+
+    bake(sample);
+
+    // Each mip level loops over the same normalised window at its own rate
+    if (auto pyramid = std::atomic_load(&sample.pyramid))
+        for (auto& level : pyramid->levels)
+            bake(*level);
+}
+
+namespace {
+
+// Runs job(0..numJobs-1) across the hardware threads and returns when all are done
+void runOnWorkerPool(int numJobs, const std::function<void(int)>& job)
+{
+    const int numWorkers = std::max(1, std::min(numJobs, static_cast<int>(std::thread::hardware_concurrency())));
+    std::atomic<int> nextJob{0};
+
+    auto work = [&] {
+        for (int index = nextJob++; index < numJobs; index = nextJob++)
+            job(index);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(numWorkers - 1));
+    for (int i = 1; i < numWorkers; ++i)
+        workers.emplace_back(work);
+
+    work();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+} // namespace
+
+void SamSamplerDSP::resampleSamplesLocked()
+{
+    const int engineRate = requestedSampleRate_.load();
+    const bool enabled = requestedResampling_.load();
+    constexpr int framesPerJob = 16384;
+
+    struct Job
+    {
+        const Sample* source;
+        Sample* target;
+        int channel;
+        int begin;
+        int end;
+    };
+
+    std::vector<std::pair<size_t, std::shared_ptr<Sample>>> replacements;
+    std::vector<Job> jobs;
+
+    for (size_t i = 0; i < sampleCache_.size() && i < nativeSamples_.size(); ++i)
+    {
+        const auto& native = nativeSamples_[i];
+        if (!native || !native->isValid())
+            continue;
+
+        // Incremental: samples already at the wanted rate are left alone
+        const int wantedRate = enabled ? engineRate : native->sampleRate;
+        const auto current = std::atomic_load(&sampleCache_[i]);
+        if (current && current->sampleRate == wantedRate)
+            continue;
+
+        // Always convert from the native data so rate changes never compound
+        std::shared_ptr<Sample> replacement;
+        if (wantedRate == native->sampleRate)
+        {
+            replacement = std::make_shared<Sample>(*native);
+        }
+        else
+        {
+            replacement = native->resampledLayout(wantedRate);
+            if (!replacement)
+                continue;
+
+            for (int ch = 0; ch < replacement->numChannels; ++ch)
+                for (int begin = 0; begin < replacement->numSamples; begin += framesPerJob)
+                    jobs.push_back({ native.get(), replacement.get(), ch, begin,
+                                     std::min(begin + framesPerJob, replacement->numSamples) });
+        }
+
+        replacements.emplace_back(i, std::move(replacement));
+    }
+
+    runOnWorkerPool(static_cast<int>(jobs.size()), [&jobs](int index) {
+        const Job& job = jobs[static_cast<size_t>(index)];
+        job.source->renderResampled(*job.target, job.channel, job.begin, job.end);
+    });
+
+    // Publish each sample complete with guard frames, levels and seams
+    for (auto& entry : replacements)
+    {
+        Sample& sample = *entry.second;
+        sample.addGuardFrames();
+        if (!sample.ownLoop)
+            std::atomic_store(&sample.loopRegion, std::shared_ptr<const LoopRegion>());
+        std::atomic_store(&sample.pyramid, requestedMipMapping_.load() ? nativePyramid(entry.first, sample)
+                                                                      : std::shared_ptr<const SamplePyramid>());
+        bakeLoopRegion(sample);
+        std::atomic_store(&sampleCache_[entry.first], entry.second);
+    }
+}
+
+void SamSamplerDSP::rebuildSamplePyramidsLocked()
+{
+    const bool enabled = requestedMipMapping_.load();
+
+    for (size_t i = 0; i < sampleCache_.size(); ++i)
+    {
+        const auto& sample = sampleCache_[i];
+        if (!sample || !sample->isValid())
+            continue;
+
+        // Disabling releases the memory once the last voice playing a level lets go
+        if (!enabled)
+            std::atomic_store(&sample->pyramid, std::shared_ptr<const SamplePyramid>());
+        else if (!std::atomic_load(&sample->pyramid))
+            std::atomic_store(&sample->pyramid, nativePyramid(i, *sample));
+    }
+}
+
+std::shared_ptr<const SamplePyramid> SamSamplerDSP::nativePyramid(size_t index, const Sample& sample) const
+{
+    // Levels that came with the sample (a packed instrument's) fit while its rate is unchanged
+    if (index < nativeSamples_.size() && nativeSamples_[index] && nativeSamples_[index]->sampleRate == sample.sampleRate)
+    {
+        if (auto pyramid = std::atomic_load(&nativeSamples_[index]->pyramid))
+            return pyramid;
+    }
+    return SamplePyramid::create(sample);
+}
+
 //==============================================================================
 // Private Methods
 //==============================================================================
 
 SamSamplerVoice* SamSamplerDSP::findFreeVoice()
 {
+    // While the governor holds polyphony down, the new note takes the quietest
+    // voice's place: that voice fades out over a few milliseconds (restarting
+    // it in place would click) while the note starts on a free voice
+    if (governorVoiceLimit_ < maxVoices_ && getActiveVoiceCount() >= governorVoiceLimit_)
+    {
+        SamSamplerVoice* quietest = nullptr;
+        for (auto& voice : voices_)
+        {
+            if (voice->isActive() && !voice->isReleasing()
+                && (!quietest || voice->getCurrentGain() < quietest->getCurrentGain()))
+                quietest = voice.get();
+        }
+        if (quietest)
+            quietest->releaseQuickly(0.005);
+    }
+
     // First, try to find a completely inactive voice
     for (auto& voice : voices_)
     {
@@ -1132,11 +3935,11 @@ SamSamplerVoice* SamSamplerDSP::findFreeVoice()
     return nullptr;
 }
 
-SamSamplerVoice* SamSamplerDSP::findVoiceForNote(int midiNote)
+SamSamplerVoice* SamSamplerDSP::findVoiceForNote(int midiNote, int part)
 {
     for (auto& voice : voices_)
     {
-        if (voice && voice->isActive() && voice->getMidiNote() == midiNote)
+        if (voice && voice->isActive() && voice->getMidiNote() == midiNote && voice->getPart() == part)
             return voice.get();
     }
     return nullptr;
@@ -0,0 +1,922 @@
+/*
+  ==============================================================================
+
+    SamSamplerPacked.cpp
+    Packed instruments for Sam Sampler
+    A native file holding the reader's zone records, key index and
+    guard-padded PCM (with loop seams and mip levels), mapped and played
+    in place; SF2 index caches are the same file without the PCM
+
+  ==============================================================================
+*/
+
+#include "dsp/SamSamplerDSP.h"
+#include "SamSamplerByteOrder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// Packed Layout
+//==============================================================================
+
+namespace {
+
+/*
+    Native byte order and float format; every section starts on a 64-byte
+    boundary, and so does each channel of PCM:
+
+      PackedHeader
+      PackedInstrument[instrumentCount]
+      PackedZone[zoneCount]
+      PackedOp[opCount]              Modulator ops, by zone
+      int32_t[keyZoneCount]          Key index entries, by instrument
+      PackedSample[sampleCount]      The reader's samples, then their mip levels
+      PCM                            Guard-padded channels and loop seams
+
+    An SF2 index cache has no PCM section: its samples name their first
+    frame in the SoundFont's smpl chunk, which is decoded on load.
+*/
+
+constexpr char packedMagic[8] = { 'S', 'A', 'M', 'P', 'A', 'C', 'K', '\0' };
+constexpr uint32_t packedVersion = 2;
+constexpr uint32_t packedByteOrder = 0x01020304;
+constexpr uint64_t packedAlignment = 64;
+
+struct PackedHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+
+    // Record sizes, so a build with another layout rejects the file
+    uint32_t instrumentSize;
+    uint32_t zoneSize;
+    uint32_t opSize;
+    uint32_t sampleSize;
+
+    uint32_t instrumentCount;
+    uint32_t zoneCount;
+    uint32_t opCount;
+    uint32_t keyZoneCount;
+    uint32_t sampleCount;           // Including mip levels
+    uint32_t readerSampleCount;     // Zone sampleIndex values index these
+
+    uint64_t instrumentOffset;
+    uint64_t zoneOffset;
+    uint64_t opOffset;
+    uint64_t keyZoneOffset;
+    uint64_t sampleOffset;
+    uint64_t fileSize;
+
+    // Index caches: the SoundFont the tables were read from
+    uint32_t indexCache;            // 1: PCM is the SoundFont's, not this file's
+    uint32_t reserved;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint64_t sourceHash;
+
+    char romName[64];
+    char romVersion[16];
+};
+
+struct PackedInstrument
+{
+    char name[64];
+    int32_t presetNumber;
+    int32_t bank;
+    uint32_t firstZone;
+    uint32_t zoneCount;
+    uint32_t firstKeyZone;
+    uint32_t keyZoneStart[129];     // Relative to firstKeyZone
+};
+
+struct PackedZone
+{
+    int32_t keyRangeLow;
+    int32_t keyRangeHigh;
+    int32_t velocityRangeLow;
+    int32_t velocityRangeHigh;
+    int32_t sampleIndex;
+    int32_t rootKey;
+    int32_t pan;
+    int32_t hasGenerators;
+    int32_t sampleMode;
+    int32_t loopStart;
+    int32_t loopEnd;
+    int32_t numStaticOps;
+    double tuning;
+    float scaleTuning;
+    float attenuation;
+    float envAttack;
+    float envHold;
+    float envDecay;
+    float envSustain;
+    float envRelease;
+    float envHoldKeyScale;
+    float envDecayKeyScale;
+    float filterCutoff;
+    float filterResonance;
+    float filterQ;
+    float initial[ModulatorProgram::TargetCount];
+    float vibLfoDelay;
+    float vibLfoFrequency;
+    float modLfoDelay;
+    float modLfoFrequency;
+    uint32_t dynamicTargets;
+    uint32_t firstOp;
+    uint32_t opCount;
+};
+
+struct PackedOp
+{
+    uint8_t source;
+    uint8_t sourceShape;
+    uint8_t amountSource;
+    uint8_t amountShape;
+    uint8_t target;
+    uint8_t absolute;
+    uint8_t reserved[2];
+    float amount;
+};
+
+struct PackedSample
+{
+    int32_t numChannels;            // 0: no sample at this index
+    int32_t numSamples;
+    int32_t sampleRate;
+    int32_t loopStart;
+    int32_t loopEnd;
+    int32_t ownLoop;
+    double rootNote;
+    double pitchCorrection;
+    uint64_t pcmOffset;             // Channel c: padded frames at pcmOffset + c * channelBytes
+    uint64_t channelBytes;
+    uint64_t soundFontFrame[2];     // Index caches: each channel's first frame in smpl
+    uint32_t firstLevel;            // Mip levels, as indices into the sample table
+    uint32_t levelCount;
+
+    // Loop seam (LoopRegion); seamFrames is 0 when there is none
+    int32_t seamLoopStart;
+    int32_t seamLoopEnd;
+    int32_t seamCrossfade;
+    int32_t seamTailStart;
+    int32_t seamFrames;             // Padded frames per channel
+    int32_t reserved;
+    uint64_t seamOffset;
+    uint64_t seamChannelBytes;
+};
+
+static_assert(std::is_trivially_copyable<PackedHeader>::value && std::is_trivially_copyable<PackedZone>::value
+              && std::is_trivially_copyable<PackedSample>::value, "Packed records are copied as bytes");
+
+inline uint64_t alignPacked(uint64_t offset) { return (offset + packedAlignment - 1) & ~(packedAlignment - 1); }
+
+inline uint64_t paddedChannelBytes(int numFrames)
+{
+    return alignPacked(static_cast<uint64_t>(numFrames + 2 * Sample::guardFrames) * sizeof(float));
+}
+
+template <typename Record>
+Record readRecord(const uint8_t* data, uint64_t offset, size_t index)
+{
+    Record record;
+    std::memcpy(&record, data + offset + index * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+void copyName(char* target, size_t size, const std::string& name)
+{
+    std::memset(target, 0, size);
+    std::memcpy(target, name.data(), std::min(size - 1, name.size()));
+}
+
+std::string readName(const char* name, size_t size)
+{
+    return std::string(name, strnlen(name, size));
+}
+
+// A sample as it is written: PCM at the packed rate, its seam, and where it goes
+struct PackedSource
+{
+    std::shared_ptr<const Sample> sample;
+    std::shared_ptr<const LoopRegion> seam;
+    PackedSample record {};
+};
+
+struct PackedTables
+{
+    std::vector<PackedInstrument> instruments;
+    std::vector<PackedZone> zones;
+    std::vector<PackedOp> ops;
+    std::vector<int32_t> keyZones;
+};
+
+PackedHeader makeHeader(const std::string& romName, const std::string& romVersion)
+{
+    PackedHeader header {};
+    std::memcpy(header.magic, packedMagic, sizeof(packedMagic));
+    header.version = packedVersion;
+    header.byteOrder = packedByteOrder;
+    header.instrumentSize = sizeof(PackedInstrument);
+    header.zoneSize = sizeof(PackedZone);
+    header.opSize = sizeof(PackedOp);
+    header.sampleSize = sizeof(PackedSample);
+    copyName(header.romName, sizeof(header.romName), romName);
+    copyName(header.romVersion, sizeof(header.romVersion), romVersion);
+    return header;
+}
+
+// Zone records and key index as the reader holds them (loops in the reader's frames)
+PackedTables packInstruments(const std::vector<SF2Reader::Instrument>& instruments)
+{
+    PackedTables tables;
+
+    for (const auto& instrument : instruments)
+    {
+        PackedInstrument packed {};
+        copyName(packed.name, sizeof(packed.name), instrument.name);
+        packed.presetNumber = instrument.presetNumber;
+        packed.bank = instrument.bank;
+        packed.firstZone = static_cast<uint32_t>(tables.zones.size());
+        packed.zoneCount = static_cast<uint32_t>(instrument.zones.size());
+        packed.firstKeyZone = static_cast<uint32_t>(tables.keyZones.size());
+        for (size_t key = 0; key < 129 && key < instrument.keyZoneStart.size(); ++key)
+            packed.keyZoneStart[key] = static_cast<uint32_t>(instrument.keyZoneStart[key]);
+        tables.keyZones.insert(tables.keyZones.end(), instrument.keyZones.begin(), instrument.keyZones.end());
+
+        for (const auto& zone : instrument.zones)
+        {
+            PackedZone record {};
+            record.keyRangeLow = zone.keyRangeLow;
+            record.keyRangeHigh = zone.keyRangeHigh;
+            record.velocityRangeLow = zone.velocityRangeLow;
+            record.velocityRangeHigh = zone.velocityRangeHigh;
+            record.sampleIndex = zone.sampleIndex;
+            record.rootKey = zone.rootKey;
+            record.pan = zone.pan;
+            record.hasGenerators = zone.hasGenerators ? 1 : 0;
+            record.sampleMode = zone.sampleMode;
+            record.loopStart = zone.loopStart;
+            record.loopEnd = zone.loopEnd;
+            record.tuning = zone.tuning;
+            record.scaleTuning = zone.scaleTuning;
+            record.attenuation = zone.attenuation;
+            record.envAttack = zone.envAttack;
+            record.envHold = zone.envHold;
+            record.envDecay = zone.envDecay;
+            record.envSustain = zone.envSustain;
+            record.envRelease = zone.envRelease;
+            record.envHoldKeyScale = zone.envHoldKeyScale;
+            record.envDecayKeyScale = zone.envDecayKeyScale;
+            record.filterCutoff = zone.filterCutoff;
+            record.filterResonance = zone.filterResonance;
+            record.filterQ = zone.filterQ;
+
+            const ModulatorProgram& program = zone.modulators;
+            record.numStaticOps = program.numStatic;
+            record.dynamicTargets = program.dynamicTargets;
+            std::copy(program.initial.begin(), program.initial.end(), record.initial);
+            record.vibLfoDelay = program.vibLfo.delay;
+            record.vibLfoFrequency = program.vibLfo.frequency;
+            record.modLfoDelay = program.modLfo.delay;
+            record.modLfoFrequency = program.modLfo.frequency;
+            record.firstOp = static_cast<uint32_t>(tables.ops.size());
+            record.opCount = static_cast<uint32_t>(program.ops.size());
+            for (const auto& op : program.ops)
+            {
+                PackedOp packedOp {};
+                packedOp.source = op.source;
+                packedOp.sourceShape = op.sourceShape;
+                packedOp.amountSource = op.amountSource;
+                packedOp.amountShape = op.amountShape;
+                packedOp.target = op.target;
+                packedOp.absolute = op.absolute ? 1 : 0;
+                packedOp.amount = op.amount;
+                tables.ops.push_back(packedOp);
+            }
+
+            tables.zones.push_back(record);
+        }
+
+        tables.instruments.push_back(packed);
+    }
+
+    return tables;
+}
+
+// Lays out the tables and any PCM the sources carry, then writes the file
+// beside its final path and renames it into place
+bool writePacked(const char* filePath, PackedHeader& header, const PackedTables& tables,
+                 std::vector<PackedSource>& sources)
+{
+    header.instrumentCount = static_cast<uint32_t>(tables.instruments.size());
+    header.zoneCount = static_cast<uint32_t>(tables.zones.size());
+    header.opCount = static_cast<uint32_t>(tables.ops.size());
+    header.keyZoneCount = static_cast<uint32_t>(tables.keyZones.size());
+    header.sampleCount = static_cast<uint32_t>(sources.size());
+
+    // Section offsets, then each channel's place in the PCM
+    uint64_t offset = alignPacked(sizeof(PackedHeader));
+    auto section = [&offset](uint64_t& sectionOffset, uint64_t bytes) {
+        sectionOffset = offset;
+        offset = alignPacked(offset + bytes);
+    };
+    section(header.instrumentOffset, tables.instruments.size() * sizeof(PackedInstrument));
+    section(header.zoneOffset, tables.zones.size() * sizeof(PackedZone));
+    section(header.opOffset, tables.ops.size() * sizeof(PackedOp));
+    section(header.keyZoneOffset, tables.keyZones.size() * sizeof(int32_t));
+    section(header.sampleOffset, sources.size() * sizeof(PackedSample));
+
+    for (auto& source : sources)
+    {
+        if (!source.sample)
+            continue;
+
+        const Sample& sample = *source.sample;
+        PackedSample& record = source.record;
+        record.numChannels = std::min(sample.numChannels, 2);
+        record.numSamples = sample.numSamples;
+        record.sampleRate = sample.sampleRate;
+        record.loopStart = sample.loopStart;
+        record.loopEnd = sample.loopEnd;
+        record.ownLoop = sample.ownLoop ? 1 : 0;
+        record.rootNote = sample.rootNote;
+        record.pitchCorrection = sample.pitchCorrection;
+        record.channelBytes = paddedChannelBytes(sample.numSamples);
+        section(record.pcmOffset, record.channelBytes * static_cast<uint64_t>(record.numChannels));
+
+        if (source.seam)
+        {
+            const LoopRegion& seam = *source.seam;
+            record.seamLoopStart = seam.loopStart;
+            record.seamLoopEnd = seam.loopEnd;
+            record.seamCrossfade = seam.crossfadeFrames;
+            record.seamTailStart = seam.tailStart;
+            record.seamFrames = static_cast<int32_t>(seam.channels[0].size());
+            record.seamChannelBytes = alignPacked(static_cast<uint64_t>(record.seamFrames) * sizeof(float));
+            section(record.seamOffset, record.seamChannelBytes * static_cast<uint64_t>(record.numChannels));
+        }
+    }
+    header.fileSize = offset;
+
+    // Write in offset order, zero-padding up to each section
+    const std::string writePath = std::string(filePath) + ".tmp";
+    std::ofstream file(writePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    uint64_t written = 0;
+    auto write = [&](uint64_t at, const void* data, uint64_t bytes) {
+        static const char zeros[packedAlignment] = {};
+        while (written < at)
+        {
+            const uint64_t padding = std::min<uint64_t>(packedAlignment, at - written);
+            file.write(zeros, static_cast<std::streamsize>(padding));
+            written += padding;
+        }
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written += bytes;
+    };
+
+    write(0, &header, sizeof(header));
+    write(header.instrumentOffset, tables.instruments.data(), tables.instruments.size() * sizeof(PackedInstrument));
+    write(header.zoneOffset, tables.zones.data(), tables.zones.size() * sizeof(PackedZone));
+    write(header.opOffset, tables.ops.data(), tables.ops.size() * sizeof(PackedOp));
+    write(header.keyZoneOffset, tables.keyZones.data(), tables.keyZones.size() * sizeof(int32_t));
+    for (size_t i = 0; i < sources.size(); ++i)
+        write(header.sampleOffset + i * sizeof(PackedSample), &sources[i].record, sizeof(PackedSample));
+
+    for (const auto& source : sources)
+    {
+        if (!source.sample)
+            continue;
+
+        const PackedSample& record = source.record;
+        const uint64_t paddedFrames = static_cast<uint64_t>(record.numSamples + 2 * Sample::guardFrames);
+        for (int ch = 0; ch < record.numChannels; ++ch)
+            write(record.pcmOffset + ch * record.channelBytes, source.sample->frames(ch) - Sample::guardFrames,
+                  paddedFrames * sizeof(float));
+        for (int ch = 0; source.seam && ch < record.numChannels; ++ch)
+            write(record.seamOffset + ch * record.seamChannelBytes, source.seam->channels[static_cast<size_t>(ch)].data(),
+                  static_cast<uint64_t>(record.seamFrames) * sizeof(float));
+    }
+    write(header.fileSize, nullptr, 0);
+
+    file.close();
+    std::error_code error;
+    if (!file)
+    {
+        std::filesystem::remove(writePath, error);
+        return false;
+    }
+    std::filesystem::rename(writePath, filePath, error);
+    if (error)
+        std::filesystem::remove(writePath, error);
+    return !error;
+}
+
+inline bool fitsPacked(uint64_t fileSize, uint64_t offset, uint64_t count, uint64_t recordSize)
+{
+    return offset % packedAlignment == 0 && offset <= fileSize
+        && count <= (fileSize - offset) / std::max<uint64_t>(1, recordSize);
+}
+
+// The header, checked against the mapping: this build's layout, every table in bounds
+bool readPackedHeader(const MappedFile& file, PackedHeader& header)
+{
+    if (file.size() < sizeof(PackedHeader))
+        return false;
+
+    header = readRecord<PackedHeader>(file.data(), 0, 0);
+    const uint64_t size = file.size();
+    return std::memcmp(header.magic, packedMagic, sizeof(packedMagic)) == 0 && header.version == packedVersion
+        && header.byteOrder == packedByteOrder && header.fileSize == size
+        && header.instrumentSize == sizeof(PackedInstrument) && header.zoneSize == sizeof(PackedZone)
+        && header.opSize == sizeof(PackedOp) && header.sampleSize == sizeof(PackedSample)
+        && header.readerSampleCount <= header.sampleCount
+        && fitsPacked(size, header.instrumentOffset, header.instrumentCount, sizeof(PackedInstrument))
+        && fitsPacked(size, header.zoneOffset, header.zoneCount, sizeof(PackedZone))
+        && fitsPacked(size, header.opOffset, header.opCount, sizeof(PackedOp))
+        && fitsPacked(size, header.keyZoneOffset, header.keyZoneCount, sizeof(int32_t))
+        && fitsPacked(size, header.sampleOffset, header.sampleCount, sizeof(PackedSample));
+}
+
+// Zone records and key index, copied as they are; zones must play a loaded sample
+bool unpackInstruments(const uint8_t* data, const PackedHeader& header,
+                       const std::vector<std::unique_ptr<Sample>>& samples,
+                       std::vector<SF2Reader::Instrument>& instruments)
+{
+    for (size_t p = 0; p < header.instrumentCount; ++p)
+    {
+        const auto packed = readRecord<PackedInstrument>(data, header.instrumentOffset, p);
+        if (packed.firstZone > header.zoneCount || packed.zoneCount > header.zoneCount - packed.firstZone
+            || packed.keyZoneStart[0] != 0 || packed.firstKeyZone > header.keyZoneCount
+            || packed.keyZoneStart[128] > header.keyZoneCount - packed.firstKeyZone)
+            return false;
+
+        SF2Reader::Instrument instrument;
+        instrument.name = readName(packed.name, sizeof(packed.name));
+        instrument.presetNumber = packed.presetNumber;
+        instrument.bank = packed.bank;
+        instrument.zones.resize(packed.zoneCount);
+
+        for (uint32_t z = 0; z < packed.zoneCount; ++z)
+        {
+            const auto record = readRecord<PackedZone>(data, header.zoneOffset, packed.firstZone + z);
+            if (record.sampleIndex < 0 || static_cast<size_t>(record.sampleIndex) >= samples.size()
+                || !samples[static_cast<size_t>(record.sampleIndex)] || record.firstOp > header.opCount
+                || record.opCount > header.opCount - record.firstOp || record.numStaticOps < 0
+                || static_cast<uint32_t>(record.numStaticOps) > record.opCount)
+                return false;
+
+            SF2Reader::Zone& zone = instrument.zones[z];
+            zone.keyRangeLow = record.keyRangeLow;
+            zone.keyRangeHigh = record.keyRangeHigh;
+            zone.velocityRangeLow = record.velocityRangeLow;
+            zone.velocityRangeHigh = record.velocityRangeHigh;
+            zone.sampleIndex = record.sampleIndex;
+            zone.rootKey = record.rootKey;
+            zone.tuning = record.tuning;
+            zone.pan = record.pan;
+            zone.hasGenerators = record.hasGenerators != 0;
+            zone.scaleTuning = record.scaleTuning;
+            zone.attenuation = record.attenuation;
+            zone.envAttack = record.envAttack;
+            zone.envHold = record.envHold;
+            zone.envDecay = record.envDecay;
+            zone.envSustain = record.envSustain;
+            zone.envRelease = record.envRelease;
+            zone.envHoldKeyScale = record.envHoldKeyScale;
+            zone.envDecayKeyScale = record.envDecayKeyScale;
+            zone.filterCutoff = record.filterCutoff;
+            zone.filterResonance = record.filterResonance;
+            zone.filterQ = record.filterQ;
+            zone.sampleMode = record.sampleMode;
+            zone.loopStart = record.loopStart;
+            zone.loopEnd = record.loopEnd;
+
+            ModulatorProgram& program = zone.modulators;
+            program.numStatic = record.numStaticOps;
+            program.dynamicTargets = record.dynamicTargets;
+            std::copy(std::begin(record.initial), std::end(record.initial), program.initial.begin());
+            program.vibLfo.delay = record.vibLfoDelay;
+            program.vibLfo.frequency = record.vibLfoFrequency;
+            program.modLfo.delay = record.modLfoDelay;
+            program.modLfo.frequency = record.modLfoFrequency;
+            program.ops.resize(record.opCount);
+            for (uint32_t i = 0; i < record.opCount; ++i)
+            {
+                const auto packedOp = readRecord<PackedOp>(data, header.opOffset, record.firstOp + i);
+                ModulatorProgram::Op& op = program.ops[i];
+                op.source = packedOp.source;
+                op.sourceShape = packedOp.sourceShape;
+                op.amountSource = packedOp.amountSource;
+                op.amountShape = packedOp.amountShape;
+                op.target = std::min<uint8_t>(packedOp.target, ModulatorProgram::TargetCount - 1);
+                op.absolute = packedOp.absolute != 0;
+                op.amount = packedOp.amount;
+            }
+        }
+
+        instrument.keyZoneStart.assign(std::begin(packed.keyZoneStart), std::end(packed.keyZoneStart));
+        instrument.keyZones.resize(packed.keyZoneStart[128]);
+        for (size_t key = 0; key < 128; ++key)
+            if (instrument.keyZoneStart[key] > instrument.keyZoneStart[key + 1])
+                return false;
+        for (size_t i = 0; i < instrument.keyZones.size(); ++i)
+        {
+            const int32_t zone = readRecord<int32_t>(data, header.keyZoneOffset, packed.firstKeyZone + i);
+            if (zone < 0 || static_cast<uint32_t>(zone) >= packed.zoneCount)
+                return false;
+            instrument.keyZones[i] = zone;
+        }
+
+        instruments.push_back(std::move(instrument));
+    }
+
+    return !instruments.empty();
+}
+
+//==============================================================================
+// SoundFont Keys
+//==============================================================================
+
+struct SoundFontLayout
+{
+    const uint8_t* smpl = nullptr;
+    size_t smplSize = 0;
+    const uint8_t* sm24 = nullptr;
+    size_t sm24Size = 0;
+    uint64_t hash = 0;
+};
+
+// Finds the sample chunks and hashes (FNV-1a) everything except the sdta
+// sample payload: the RIFF header, INFO, pdta and the sdta chunk headers, so
+// the hash covers the tables an index cache stands for and where the sample
+// data sits. Hashing the PCM would page in the whole file, which the cache
+// exists to avoid. The trade-off: an in-place edit of sample data that keeps
+// the file size and mtime still matches the cache.
+bool locateSoundFont(const MappedFile& file, SoundFontLayout& layout)
+{
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "sfbk", 4) != 0)
+        return false;
+
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const uint8_t* bytes, size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+    };
+
+    const size_t riffEnd = std::min(size, static_cast<size_t>(readU32(data + 4)) + 8);
+    mix(data, 12);
+    for (size_t list = 12; list + 12 <= riffEnd;)
+    {
+        const size_t listSize = readU32(data + list + 4);
+        const size_t listEnd = std::min(riffEnd, list + 8 + listSize);
+
+        if (std::memcmp(data + list, "LIST", 4) == 0 && std::memcmp(data + list + 8, "sdta", 4) == 0)
+        {
+            mix(data + list, 12);
+            for (size_t chunk = list + 12; chunk + 8 <= listEnd;)
+            {
+                const size_t chunkSize = std::min<size_t>(readU32(data + chunk + 4), listEnd - chunk - 8);
+                mix(data + chunk, 8);
+                if (std::memcmp(data + chunk, "smpl", 4) == 0)
+                {
+                    layout.smpl = data + chunk + 8;
+                    layout.smplSize = chunkSize;
+                }
+                else if (std::memcmp(data + chunk, "sm24", 4) == 0)
+                {
+                    layout.sm24 = data + chunk + 8;
+                    layout.sm24Size = chunkSize;
+                }
+                chunk += 8 + chunkSize + (chunkSize & 1);
+            }
+        }
+        else
+        {
+            mix(data + list, listEnd - list);
+        }
+
+        list = listEnd + (listSize & 1);
+    }
+
+    layout.hash = hash;
+    return layout.smpl != nullptr;
+}
+
+int64_t modificationTime(const char* path)
+{
+    std::error_code error;
+    const auto time = std::filesystem::last_write_time(path, error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+} // namespace
+
+//==============================================================================
+// Packed Instruments
+//==============================================================================
+
+bool SF2Reader::savePacked(const char* filePath, int sampleRate, bool mipLevels) const
+{
+    if (filePath == nullptr || !isLoaded())
+        return false;
+
+    // Samples at the packed rate, then every sample's levels. Seams are the
+    // ones the engine bakes: hard loops at the sample's own loop points
+    std::vector<PackedSource> sources(samples_.size());
+    std::vector<std::shared_ptr<const SamplePyramid>> pyramids(samples_.size());
+    auto prepare = [](PackedSource& source, std::shared_ptr<const Sample> sample) {
+        source.sample = std::move(sample);
+        if (source.sample->ownLoop)
+            source.seam = LoopRegion::create(*source.sample, source.sample->loopStart, source.sample->loopEnd, 0);
+    };
+
+    for (size_t i = 0; i < samples_.size(); ++i)
+    {
+        const Sample* native = samples_[i].get();
+        if (!native || !native->isValid())
+            continue;
+
+        std::shared_ptr<const Sample> sample;
+        if (sampleRate > 0 && sampleRate != native->sampleRate)
+        {
+            auto resampled = native->resampledLayout(sampleRate);
+            for (int ch = 0; ch < resampled->numChannels; ++ch)
+                native->renderResampled(*resampled, ch, 0, resampled->numSamples);
+            resampled->addGuardFrames();
+            sample = std::move(resampled);
+        }
+        else
+        {
+            sample = std::make_shared<Sample>(*native);
+        }
+
+        if (mipLevels)
+            pyramids[i] = SamplePyramid::create(*sample);
+        prepare(sources[i], std::move(sample));
+    }
+
+    for (size_t i = 0; i < pyramids.size(); ++i)
+    {
+        if (!pyramids[i])
+            continue;
+
+        sources[i].record.firstLevel = static_cast<uint32_t>(sources.size());
+        sources[i].record.levelCount = static_cast<uint32_t>(pyramids[i]->levels.size());
+        for (const auto& level : pyramids[i]->levels)
+        {
+            sources.emplace_back();
+            prepare(sources.back(), level);
+        }
+    }
+
+    // Loop points follow their sample to the packed rate
+    PackedTables tables = packInstruments(instruments_);
+    for (auto& record : tables.zones)
+    {
+        const size_t sampleIndex = static_cast<size_t>(record.sampleIndex);
+        if (sampleIndex >= samples_.size() || !samples_[sampleIndex] || !sources[sampleIndex].sample)
+            continue;
+
+        const Sample& native = *samples_[sampleIndex];
+        const Sample& packedSample = *sources[sampleIndex].sample;
+        const double ratio = static_cast<double>(packedSample.sampleRate) / native.sampleRate;
+        record.loopEnd = record.loopEnd == native.numSamples ? packedSample.numSamples
+                                                             : static_cast<int32_t>(std::lround(record.loopEnd * ratio));
+        record.loopStart = static_cast<int32_t>(std::lround(record.loopStart * ratio));
+    }
+
+    PackedHeader header = makeHeader(romName_, romVersion_);
+    header.readerSampleCount = static_cast<uint32_t>(samples_.size());
+    return writePacked(filePath, header, tables, sources);
+}
+
+bool SF2Reader::loadPacked(const char* filePath)
+{
+    auto file = std::make_shared<MappedFile>();
+    PackedHeader header;
+    if (!file->open(filePath) || !readPackedHeader(*file, header) || header.indexCache != 0)
+        return false;
+
+    const uint8_t* data = file->data();
+    const uint64_t size = file->size();
+
+    // Samples, seams and levels read their frames in place
+    auto mapSample = [&](const PackedSample& record) -> std::shared_ptr<Sample> {
+        const uint64_t paddedFrames = static_cast<uint64_t>(record.numSamples) + 2 * Sample::guardFrames;
+        if (record.numChannels < 1 || record.numChannels > 2 || record.numSamples <= 0 || record.sampleRate <= 0
+            || record.channelBytes < paddedFrames * sizeof(float)
+            || !fitsPacked(size, record.pcmOffset, static_cast<uint64_t>(record.numChannels), record.channelBytes))
+            return nullptr;
+
+        auto sample = std::make_shared<Sample>();
+        sample->numChannels = record.numChannels;
+        sample->numSamples = record.numSamples;
+        sample->sampleRate = record.sampleRate;
+        sample->rootNote = record.rootNote;
+        sample->pitchCorrection = record.pitchCorrection;
+        sample->loopStart = record.loopStart;
+        sample->loopEnd = record.loopEnd;
+        sample->ownLoop = record.ownLoop != 0;
+        sample->guarded = true;
+        sample->mapping = file;
+        for (int ch = 0; ch < record.numChannels; ++ch)
+            sample->mappedChannels[static_cast<size_t>(ch)] = reinterpret_cast<const float*>(
+                data + record.pcmOffset + ch * record.channelBytes);
+
+        const uint64_t seamFrames = static_cast<uint64_t>(std::max(0, record.seamFrames));
+        if (seamFrames > 0 && record.seamChannelBytes >= seamFrames * sizeof(float)
+            && fitsPacked(size, record.seamOffset, static_cast<uint64_t>(record.numChannels), record.seamChannelBytes)
+            && record.seamTailStart >= 0 && record.seamLoopEnd <= record.numSamples
+            && seamFrames >= static_cast<uint64_t>(record.seamLoopEnd - record.seamTailStart) + 2 * Sample::guardFrames)
+        {
+            auto seam = std::make_shared<LoopRegion>();
+            seam->loopStart = record.seamLoopStart;
+            seam->loopEnd = record.seamLoopEnd;
+            seam->crossfadeFrames = record.seamCrossfade;
+            seam->tailStart = record.seamTailStart;
+            seam->numChannels = record.numChannels;
+            seam->mapping = file;
+            for (int ch = 0; ch < record.numChannels; ++ch)
+                seam->mappedChannels[static_cast<size_t>(ch)] = reinterpret_cast<const float*>(
+                    data + record.seamOffset + ch * record.seamChannelBytes);
+            sample->loopRegion = std::move(seam);
+        }
+        return sample;
+    };
+
+    samples_.resize(header.readerSampleCount);
+    sampleHeaders_.resize(header.readerSampleCount);
+    for (size_t i = 0; i < header.readerSampleCount; ++i)
+    {
+        const auto record = readRecord<PackedSample>(data, header.sampleOffset, i);
+        if (record.numChannels == 0)
+            continue;
+
+        std::shared_ptr<Sample> sample = mapSample(record);
+        if (!sample)
+            return false;
+
+        if (record.levelCount > 0)
+        {
+            if (record.firstLevel < header.readerSampleCount || record.firstLevel > header.sampleCount
+                || record.levelCount > header.sampleCount - record.firstLevel)
+                return false;
+
+            auto pyramid = std::make_shared<SamplePyramid>();
+            for (uint32_t level = 0; level < record.levelCount; ++level)
+            {
+                auto levelSample = mapSample(readRecord<PackedSample>(data, header.sampleOffset, record.firstLevel + level));
+                if (!levelSample)
+                    return false;
+                pyramid->levels.push_back(std::move(levelSample));
+            }
+            sample->pyramid = std::move(pyramid);
+        }
+
+        sampleHeaders_[i].sampleRate = static_cast<uint32_t>(record.sampleRate);
+        sampleHeaders_[i].end = static_cast<uint32_t>(record.numSamples);
+        sampleHeaders_[i].loopStart = static_cast<uint32_t>(std::max(0, record.loopStart));
+        sampleHeaders_[i].loopEnd = static_cast<uint32_t>(std::max(0, record.loopEnd));
+        samples_[i] = std::make_unique<Sample>(*sample);
+    }
+
+    if (!unpackInstruments(data, header, samples_, instruments_))
+        return false;
+
+    romName_ = readName(header.romName, sizeof(header.romName));
+    romVersion_ = readName(header.romVersion, sizeof(header.romVersion));
+    return true;
+}
+
+//==============================================================================
+// SF2 Index Caches
+//==============================================================================
+
+std::string SF2Reader::indexCachePath(const char* soundFontPath)
+{
+    return std::string(soundFontPath) + ".samcache";
+}
+
+bool SF2Reader::saveIndexCache(const char* soundFontPath, const MappedFile& soundFont) const
+{
+    SoundFontLayout layout;
+    if (!isLoaded() || !locateSoundFont(soundFont, layout))
+        return false;
+
+    PackedHeader header = makeHeader(romName_, romVersion_);
+    header.indexCache = 1;
+    header.sourceSize = soundFont.size();
+    header.sourceModified = modificationTime(soundFontPath);
+    header.sourceHash = layout.hash;
+    header.readerSampleCount = static_cast<uint32_t>(samples_.size());
+
+    // Each sample as the frames it decodes from: a stereo sample reads its
+    // right channel from the linked sample, a looped copy its source's frames
+    std::vector<PackedSource> sources(samples_.size());
+    for (size_t i = 0; i < samples_.size(); ++i)
+    {
+        const Sample* sample = samples_[i].get();
+        if (!sample || !sample->isValid() || sample->numChannels > 2)
+            continue;
+
+        PackedSample& record = sources[i].record;
+        record.numChannels = sample->numChannels;
+        record.numSamples = sample->numSamples;
+        record.sampleRate = sample->sampleRate;
+        record.loopStart = sample->loopStart;
+        record.loopEnd = sample->loopEnd;
+        record.ownLoop = sample->ownLoop ? 1 : 0;
+        record.rootNote = sample->rootNote;
+        record.pitchCorrection = sample->pitchCorrection;
+        record.soundFontFrame[0] = sampleHeaders_[i].start;
+        if (sample->numChannels == 2)
+        {
+            const size_t link = static_cast<size_t>(sampleHeaders_[i].sampleLink);
+            if (link >= sampleHeaders_.size())
+                return false;
+            record.soundFontFrame[1] = sampleHeaders_[link].start;
+        }
+    }
+
+    return writePacked(indexCachePath(soundFontPath).c_str(), header, packInstruments(instruments_), sources);
+}
+
+bool SF2Reader::loadIndexCache(const char* soundFontPath, const MappedFile& soundFont)
+{
+    MappedFile file;
+    PackedHeader header;
+    if (!file.open(indexCachePath(soundFontPath).c_str()) || !readPackedHeader(file, header)
+        || header.indexCache != 1 || header.sourceSize != soundFont.size()
+        || header.sourceModified != modificationTime(soundFontPath))
+        return false;
+
+    SoundFontLayout layout;
+    if (!locateSoundFont(soundFont, layout) || layout.hash != header.sourceHash)
+        return false;
+
+    // Decode each sample straight from the mapped smpl (and sm24) chunk
+    const uint8_t* data = file.data();
+    const size_t totalFrames = layout.smplSize / 2;
+    const uint8_t* low = layout.sm24Size >= totalFrames ? layout.sm24 : nullptr;
+
+    samples_.resize(header.readerSampleCount);
+    sampleHeaders_.resize(header.readerSampleCount);
+    for (size_t i = 0; i < header.readerSampleCount; ++i)
+    {
+        const auto record = readRecord<PackedSample>(data, header.sampleOffset, i);
+        if (record.numChannels == 0)
+            continue;
+        if (record.numChannels > 2 || record.numSamples <= 0 || record.sampleRate <= 0)
+            return false;
+
+        auto sample = std::make_unique<Sample>();
+        sample->numChannels = record.numChannels;
+        sample->numSamples = record.numSamples;
+        sample->sampleRate = record.sampleRate;
+        sample->rootNote = record.rootNote;
+        sample->pitchCorrection = record.pitchCorrection;
+        sample->loopStart = record.loopStart;
+        sample->loopEnd = record.loopEnd;
+        sample->ownLoop = record.ownLoop != 0;
+        sample->channels.assign(static_cast<size_t>(record.numChannels),
+                                AudioChannelBuffer(static_cast<size_t>(record.numSamples)));
+        for (int ch = 0; ch < record.numChannels; ++ch)
+        {
+            const uint64_t first = record.soundFontFrame[ch];
+            if (first > totalFrames || static_cast<uint64_t>(record.numSamples) > totalFrames - first)
+                return false;
+            decodeFrames(layout.smpl, low, static_cast<size_t>(first), record.numSamples,
+                         sample->channels[static_cast<size_t>(ch)].data());
+        }
+        sample->addGuardFrames();
+
+        sampleHeaders_[i].start = static_cast<uint32_t>(record.soundFontFrame[0]);
+        sampleHeaders_[i].end = static_cast<uint32_t>(record.soundFontFrame[0] + record.numSamples);
+        sampleHeaders_[i].sampleRate = static_cast<uint32_t>(record.sampleRate);
+        samples_[i] = std::move(sample);
+    }
+
+    if (!unpackInstruments(data, header, samples_, instruments_))
+        return false;
+
+    romName_ = readName(header.romName, sizeof(header.romName));
+    romVersion_ = readName(header.romVersion, sizeof(header.romVersion));
+    loadedFromIndexCache_ = true;
+    return true;
+}
+
+} // namespace DSP
@@ -0,0 +1,1051 @@
+/*
+  ==============================================================================
+
+    SamSamplerSF2.cpp
+    SoundFont 2 reader for Sam Sampler
+    RIFF parsing, load-time flattening of the generator hierarchy and
+    modulator compilation
+
+  ==============================================================================
+*/
+
+#include "dsp/SamSamplerDSP.h"
+#include "SamSamplerByteOrder.h"
+#include "../../../../include/dsp/LookupTables.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// SF2 Records
+//==============================================================================
+
+namespace {
+
+// Generator operators (SoundFont 2.04, section 8.1.2)
+enum Generator
+{
+    GenStartLoopOffset = 2,
+    GenEndLoopOffset = 3,
+    GenModLfoToPitch = 5,
+    GenVibLfoToPitch = 6,
+    GenInitialFilterFc = 8,
+    GenInitialFilterQ = 9,
+    GenModLfoToFilterFc = 10,
+    GenModLfoToVolume = 13,
+    GenPan = 17,
+    GenDelayModLfo = 21,
+    GenFreqModLfo = 22,
+    GenDelayVibLfo = 23,
+    GenFreqVibLfo = 24,
+    GenAttackVolEnv = 34,
+    GenHoldVolEnv = 35,
+    GenDecayVolEnv = 36,
+    GenSustainVolEnv = 37,
+    GenReleaseVolEnv = 38,
+    GenKeynumToVolEnvHold = 39,
+    GenKeynumToVolEnvDecay = 40,
+    GenInstrument = 41,
+    GenKeyRange = 43,
+    GenVelRange = 44,
+    GenStartLoopCoarseOffset = 45,
+    GenInitialAttenuation = 48,
+    GenEndLoopCoarseOffset = 50,
+    GenCoarseTune = 51,
+    GenFineTune = 52,
+    GenSampleID = 53,
+    GenSampleModes = 54,
+    GenScaleTuning = 56,
+    GenOverridingRootKey = 58,
+    GenInitialPitch = 59,       // Modulator destination only (default pitch wheel modulator)
+    GenCount = 61
+};
+
+// Modulator source indices (section 8.2.1); bit 7 of a source selects a MIDI CC
+enum ModulatorSource
+{
+    SourceNone = 0,
+    SourceVelocity = 2,
+    SourceKey = 3,
+    SourcePolyPressure = 10,
+    SourceChannelPressure = 13,
+    SourcePitchWheel = 14,
+    SourcePitchWheelSensitivity = 16,
+    SourceLink = 127
+};
+
+constexpr uint16_t sourceIsController = 0x80;
+constexpr uint16_t linkedDestination = 0x8000;
+constexpr uint16_t transformAbsolute = 2;
+
+// Sample types (shdr sfSampleType)
+constexpr int sampleTypeRight = 2;
+constexpr int sampleTypeLeft = 4;
+constexpr int sampleTypeRom = 0x8000;
+
+inline bool chunkIs(const uint8_t* p, const char* id) { return std::memcmp(p, id, 4) == 0; }
+
+// Fixed-width names are NUL-padded, not always NUL-terminated
+std::string readName(const uint8_t* p, size_t size)
+{
+    size_t length = 0;
+    while (length < size && p[length] != 0)
+        ++length;
+    return std::string(reinterpret_cast<const char*>(p), length);
+}
+
+// Case-insensitive file extension test (extension includes the dot)
+bool hasExtension(const char* path, const char* extension)
+{
+    const size_t pathLength = std::strlen(path);
+    const size_t extensionLength = std::strlen(extension);
+    if (pathLength < extensionLength)
+        return false;
+
+    for (size_t i = 0; i < extensionLength; ++i)
+        if (std::tolower(static_cast<unsigned char>(path[pathLength - extensionLength + i]))
+            != std::tolower(static_cast<unsigned char>(extension[i])))
+            return false;
+    return true;
+}
+
+// A view of one pdta sub-chunk as fixed-size records
+struct RecordTable
+{
+    const uint8_t* data = nullptr;
+    size_t recordSize = 0;
+    size_t count = 0;
+
+    const uint8_t* operator[](size_t index) const { return data + index * recordSize; }
+};
+
+// One modulator record (pmod/imod)
+struct Modulator
+{
+    uint16_t source = 0;
+    uint16_t destination = 0;
+    int16_t amount = 0;
+    uint16_t amountSource = 0;
+    uint16_t transform = 0;
+
+    // Identical modulators (all but the amount equal) replace each other (section 9.5.1)
+    bool sameAs(const Modulator& other) const
+    {
+        return source == other.source && destination == other.destination
+            && amountSource == other.amountSource && transform == other.transform;
+    }
+};
+
+// SF2 default modulators (section 8.4), which instrument modulators override.
+// CC 7 and CC 10 are left out: they already set the part's volume and pan.
+const Modulator defaultModulators[] = {
+    { 0x0502, GenInitialAttenuation, 960, 0, 0 },  // Velocity, concave
+    { 0x0102, GenInitialFilterFc, -2400, 0, 0 },   // Velocity, linear
+    { 0x000D, GenVibLfoToPitch, 50, 0, 0 },        // Channel pressure
+    { 0x0081, GenVibLfoToPitch, 50, 0, 0 },        // CC 1 mod wheel
+    { 0x058B, GenInitialAttenuation, 960, 0, 0 },  // CC 11 expression, concave
+    { 0x020E, GenInitialPitch, 12700, 0x0010, 0 }  // Pitch wheel, scaled by its sensitivity
+};
+
+// Generator values for one zone level; set marks the ones given explicitly
+struct GeneratorSet
+{
+    int16_t value[GenCount] = {};
+    bool set[GenCount] = {};
+    std::vector<Modulator> modulators;
+
+    void apply(const uint8_t* gen)
+    {
+        const uint16_t oper = readU16(gen);
+        if (oper < GenCount)
+        {
+            value[oper] = readS16(gen + 2);
+            set[oper] = true;
+        }
+    }
+
+    void addModulator(const uint8_t* mod)
+    {
+        modulators.push_back({ readU16(mod), readU16(mod + 2), readS16(mod + 4), readU16(mod + 6), readU16(mod + 8) });
+    }
+
+    void overrideWith(const GeneratorSet& other)
+    {
+        for (int g = 0; g < GenCount; ++g)
+        {
+            if (other.set[g])
+            {
+                value[g] = other.value[g];
+                set[g] = true;
+            }
+        }
+
+        for (const Modulator& mod : other.modulators)
+        {
+            auto same = std::find_if(modulators.begin(), modulators.end(),
+                                     [&](const Modulator& m) { return m.sameAs(mod); });
+            if (same != modulators.end())
+                *same = mod;
+            else
+                modulators.push_back(mod);
+        }
+    }
+
+    // Range generators pack lo/hi bytes into the amount
+    int rangeLow(int gen) const { return set[gen] ? (static_cast<uint16_t>(value[gen]) & 0xFF) : 0; }
+    int rangeHigh(int gen) const { return set[gen] ? (static_cast<uint16_t>(value[gen]) >> 8) : 127; }
+};
+
+// Instrument-level defaults (section 8.1.3) for the generators we use
+GeneratorSet instrumentDefaults()
+{
+    GeneratorSet defaults;
+    defaults.value[GenInitialFilterFc] = 13500;
+    defaults.value[GenDelayModLfo] = -12000;
+    defaults.value[GenDelayVibLfo] = -12000;
+    defaults.value[GenAttackVolEnv] = -12000;
+    defaults.value[GenHoldVolEnv] = -12000;
+    defaults.value[GenDecayVolEnv] = -12000;
+    defaults.value[GenReleaseVolEnv] = -12000;
+    defaults.value[GenScaleTuning] = 100;
+    defaults.value[GenOverridingRootKey] = -1;
+    defaults.modulators.assign(std::begin(defaultModulators), std::end(defaultModulators));
+    return defaults;
+}
+
+// Preset generators add to the instrument's, except these (section 8.5)
+bool isPresetAdditive(int gen)
+{
+    switch (gen)
+    {
+        case 0: case 1: case GenStartLoopOffset: case GenEndLoopOffset: case 4: case 12:
+        case GenStartLoopCoarseOffset: case GenEndLoopCoarseOffset:
+        case GenInstrument: case GenKeyRange: case GenVelRange: case 46: case 47:
+        case GenSampleID: case GenSampleModes: case 57: case GenOverridingRootKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
+inline double timecentsToSeconds(int timecents)
+{
+    return std::exp2(timecents / 1200.0);
+}
+
+inline int clampGenerator(int value, int low, int high)
+{
+    return std::max(low, std::min(high, value));
+}
+
+// Target for a generator destination and the factor its amount takes there;
+// false for destinations the engine has nothing to modulate with
+bool modulatorTarget(int destination, ModulatorProgram::Target& target, float& scale)
+{
+    scale = 1.0f;
+    switch (destination)
+    {
+        case GenCoarseTune: target = ModulatorProgram::Pitch; scale = 100.0f; return true;
+        case GenFineTune:
+        case GenInitialPitch: target = ModulatorProgram::Pitch; return true;
+        case GenInitialAttenuation: target = ModulatorProgram::Attenuation; return true;
+        case GenInitialFilterFc: target = ModulatorProgram::FilterCutoff; return true;
+        case GenInitialFilterQ: target = ModulatorProgram::FilterQ; return true;
+        case GenPan: target = ModulatorProgram::Pan; return true;
+        case GenVibLfoToPitch: target = ModulatorProgram::VibLfoToPitch; return true;
+        case GenModLfoToPitch: target = ModulatorProgram::ModLfoToPitch; return true;
+        case GenModLfoToFilterFc: target = ModulatorProgram::ModLfoToFilterCutoff; return true;
+        case GenModLfoToVolume: target = ModulatorProgram::ModLfoToVolume; return true;
+        default: return false;
+    }
+}
+
+bool isSupportedSource(uint16_t source)
+{
+    if (source & sourceIsController)
+        return true;
+
+    switch (source & 0x7F)
+    {
+        case SourceNone: case SourceVelocity: case SourceKey: case SourceChannelPressure:
+        case SourcePitchWheel: case SourcePitchWheelSensitivity:
+            return true;
+        default:
+            return false;   // Poly pressure and modulator links
+    }
+}
+
+// Sources that cannot change during a note
+bool isNoteOnSource(uint16_t source)
+{
+    const int index = source & 0x7F;
+    return !(source & sourceIsController)
+        && (index == SourceNone || index == SourceVelocity || index == SourceKey);
+}
+
+// Compile the zone's merged instrument modulators and the preset's (which add
+// to them) into ops, note-on ops first
+void compileModulators(const std::vector<Modulator>& instrumentModulators,
+                       const std::vector<Modulator>& presetModulators, ModulatorProgram& program)
+{
+    program.ops.clear();
+    for (const auto* list : { &instrumentModulators, &presetModulators })
+    {
+        for (const Modulator& mod : *list)
+        {
+            ModulatorProgram::Target target;
+            float scale;
+            // A modulator without a source contributes nothing (section 8.2.1)
+            if ((mod.destination & linkedDestination) || (mod.source & 0xFF) == SourceNone || mod.amount == 0
+                || !isSupportedSource(mod.source) || !isSupportedSource(mod.amountSource)
+                || !modulatorTarget(mod.destination, target, scale))
+                continue;
+
+            ModulatorProgram::Op op;
+            op.source = static_cast<uint8_t>(mod.source & 0xFF);
+            op.sourceShape = static_cast<uint8_t>(mod.source >> 8);
+            op.amountSource = static_cast<uint8_t>(mod.amountSource & 0xFF);
+            op.amountShape = static_cast<uint8_t>(mod.amountSource >> 8);
+            op.target = static_cast<uint8_t>(target);
+            op.absolute = mod.transform == transformAbsolute;
+            op.amount = mod.amount * scale;
+            program.ops.push_back(op);
+        }
+    }
+
+    program.partition();
+}
+
+// Normalized source value (section 8.2.1), before its curve
+inline float sourceValue(const ModulatorInputs& inputs, int key, float velocity, uint8_t source)
+{
+    if (source & sourceIsController)
+        return inputs.controllers[source & 0x7F];
+
+    switch (source)
+    {
+        case SourceNone: return 1.0f;
+        case SourceVelocity: return velocity;
+        case SourceKey: return key / 127.0f;
+        case SourceChannelPressure: return inputs.channelPressure;
+        case SourcePitchWheel: return inputs.pitchWheel;
+        case SourcePitchWheelSensitivity: return inputs.pitchWheelSensitivity;
+        default: return 0.0f;
+    }
+}
+
+// Concave curve: the SF2 amplitude-to-attenuation law, 0 at 0 and 1 at 1
+inline float concave(float x)
+{
+    return x >= 0.999f ? 1.0f : std::min(1.0f, static_cast<float>(-(5.0 / 12.0) * std::log10(1.0 - x)));
+}
+
+// Source flags: bit 0 direction (max to min), bit 1 polarity (bipolar),
+// bits 2-7 curve type (linear, concave, convex, switch)
+inline float shapeSource(float x, uint8_t shape)
+{
+    if (shape & 1)
+        x = 1.0f - x;
+
+    const int curve = shape >> 2;
+    if (curve == 3)
+        return x >= 0.5f ? 1.0f : ((shape & 2) ? -1.0f : 0.0f);
+
+    auto apply = [curve](float v) {
+        if (curve == 1)
+            return concave(v);
+        if (curve == 2)
+            return 1.0f - concave(1.0f - v);
+        return v;
+    };
+
+    // Bipolar curves are mirrored about the center
+    if (shape & 2)
+    {
+        const float centered = 2.0f * x - 1.0f;
+        return centered < 0.0f ? -apply(-centered) : apply(centered);
+    }
+    return apply(x);
+}
+
+// Zone generators and modulators (bags) in the range [firstBag, endBag); the
+// first zone is global when it lacks the terminal generator (instrument or sampleID)
+template <typename Visit>
+void forEachZone(const RecordTable& bags, const RecordTable& gens, const RecordTable& mods,
+                 uint16_t firstBag, uint16_t endBag, int terminalGen, Visit visit)
+{
+    GeneratorSet global;
+    for (uint16_t bag = firstBag; bag < endBag && bag + 1u < bags.count; ++bag)
+    {
+        const uint16_t genBegin = readU16(bags[bag]);
+        const uint16_t genEnd = std::min<size_t>(readU16(bags[bag + 1u]), gens.count);
+
+        GeneratorSet zone;
+        int terminal = -1;
+        for (uint16_t g = genBegin; g < genEnd; ++g)
+        {
+            zone.apply(gens[g]);
+            if (readU16(gens[g]) == terminalGen)
+                terminal = static_cast<uint16_t>(readS16(gens[g] + 2));
+        }
+
+        // The terminal modulator record is not part of any zone
+        const uint16_t modBegin = readU16(bags[bag] + 2);
+        const uint16_t modEnd = std::min<size_t>(readU16(bags[bag + 1u] + 2), mods.count > 0 ? mods.count - 1 : 0);
+        for (uint16_t m = modBegin; m < modEnd; ++m)
+            zone.addModulator(mods[m]);
+
+        if (terminal >= 0)
+            visit(global, zone, terminal);
+        else if (bag == firstBag)
+            global = zone;
+    }
+}
+
+} // namespace
+
+//==============================================================================
+// Modulators
+//==============================================================================
+
+ModulatorInputs::ModulatorInputs()
+{
+    controllers[7] = 100.0f / 127.0f;
+    controllers[10] = 64.0f / 127.0f;
+    resetControllers();
+}
+
+void ModulatorInputs::resetControllers()
+{
+    const float volume = controllers[7];
+    const float pan = controllers[10];
+    controllers.fill(0.0f);
+    controllers[7] = volume;
+    controllers[10] = pan;
+    controllers[11] = 1.0f;
+    channelPressure = 0.0f;
+    pitchWheel = 0.5f;
+    ++version;
+}
+
+float ModulatorProgram::Lfo::valueAt(double seconds) const
+{
+    if (seconds < delay)
+        return 0.0f;
+
+    // Triangle rising from zero: 0 -> 1 -> -1 -> 0 over one period
+    const double phase = (seconds - delay) * frequency;
+    const float position = static_cast<float>(phase - std::floor(phase));
+    if (position < 0.25f)
+        return 4.0f * position;
+    if (position < 0.75f)
+        return 2.0f - 4.0f * position;
+    return 4.0f * position - 4.0f;
+}
+
+void ModulatorProgram::partition()
+{
+    auto isStatic = [](const Op& op) {
+        return isNoteOnSource(op.source) && isNoteOnSource(op.amountSource);
+    };
+    const auto dynamicBegin = std::stable_partition(ops.begin(), ops.end(), isStatic);
+    numStatic = static_cast<int>(dynamicBegin - ops.begin());
+
+    dynamicTargets = 0;
+    for (auto op = dynamicBegin; op != ops.end(); ++op)
+        dynamicTargets |= 1u << op->target;
+}
+
+void ModulatorProgram::run(const ModulatorInputs& inputs, int key, float velocity, int begin, int end,
+                           float* targets) const
+{
+    for (int i = begin; i < end; ++i)
+    {
+        const Op& op = ops[static_cast<size_t>(i)];
+        float value = op.amount * shapeSource(sourceValue(inputs, key, velocity, op.source), op.sourceShape)
+                    * shapeSource(sourceValue(inputs, key, velocity, op.amountSource), op.amountShape);
+        if (op.absolute)
+            value = std::abs(value);
+        targets[op.target] += value;
+    }
+}
+
+double ModulatorProgram::resonanceForQ(double centibels)
+{
+    // Q in centibels of resonant peak, matched to the SVF's peak gain Q = 1 / (2R)
+    const double q = std::pow(10.0, std::max(0.0, std::min(960.0, centibels)) / 200.0);
+    const double damping = std::min(1.0, 1.0 / (2.0 * std::max(q, M_SQRT1_2)));
+    return std::max(0.0, std::min(1.0, (1.0 - damping) / 0.99));
+}
+
+//==============================================================================
+// SF2Reader Implementation
+//==============================================================================
+
+bool SF2Reader::loadFile(const char* filePath)
+{
+    clear();
+
+    if (filePath == nullptr || filePath[0] == '\0')
+    {
+        createTestInstrument();
+        return true;
+    }
+
+    if (hasExtension(filePath, ".sfz") || hasExtension(filePath, ".sampack"))
+    {
+        if (hasExtension(filePath, ".sfz") ? loadSFZ(filePath) : loadPacked(filePath))
+            return true;
+        clear();
+        return false;
+    }
+
+    // Only the sample data is read through the mapping when the index cache is current
+    MappedFile file;
+    if (!file.open(filePath) || file.size() < 12)
+        return false;
+
+    if (indexCacheEnabled_)
+    {
+        if (loadIndexCache(filePath, file))
+            return true;
+        clear();
+    }
+
+    if (!parseRIFF(file.data(), file.size()))
+    {
+        clear();
+        return false;
+    }
+
+    if (indexCacheEnabled_)
+        saveIndexCache(filePath, file);
+
+    return true;
+}
+
+void SF2Reader::clear()
+{
+    romName_.clear();
+    romVersion_.clear();
+    samples_.clear();
+    sampleHeaders_.clear();
+    instruments_.clear();
+    loadedFromIndexCache_ = false;
+}
+
+void SF2Reader::createTestInstrument()
+{
+    romName_ = "Default ROM";
+    romVersion_ = "1.0";
+
+    // Create a default instrument
+    Instrument defaultInst;
+    defaultInst.name = "Default Instrument";
+    defaultInst.presetNumber = 0;
+    defaultInst.bank = 0;
+
+    // Create a default zone covering full MIDI range
+    Zone defaultZone;
+    defaultZone.keyRangeLow = 0;
+    defaultZone.keyRangeHigh = 127;
+    defaultZone.velocityRangeLow = 0;
+    defaultZone.velocityRangeHigh = 127;
+    defaultZone.rootKey = 60;
+
+    // Create a simple sine wave sample for testing
+    auto testSample = std::make_unique<Sample>();
+    int testSampleRate = 44100;
+    int duration = testSampleRate; // 1 second
+    testSample->numSamples = duration;
+    testSample->numChannels = 1;
+    testSample->sampleRate = testSampleRate;
+    testSample->rootNote = 60;
+    testSample->channels.assign(1, AudioChannelBuffer(static_cast<size_t>(duration)));
+
+    // Generate sine wave using LookupTables
+    for (int i = 0; i < duration; ++i)
+    {
+        double t = static_cast<double>(i) / testSampleRate;
+        float phase = static_cast<float>(2.0 * M_PI * 440.0 * t);
+        testSample->channels[0][i] = SchillingerEcosystem::DSP::fastSineLookup(phase);
+    }
+
+    testSample->addGuardFrames();
+
+    samples_.push_back(std::move(testSample));
+    sampleHeaders_.emplace_back();
+    defaultZone.sampleIndex = 0;
+    defaultInst.zones.push_back(defaultZone);
+    indexZones(defaultInst);
+    instruments_.push_back(defaultInst);
+}
+
+bool SF2Reader::parseRIFF(const uint8_t* file, size_t fileSize)
+{
+    if (!chunkIs(file, "RIFF") || !chunkIs(file + 8, "sfbk"))
+        return false;
+
+    const size_t riffEnd = std::min(fileSize, static_cast<size_t>(readU32(file + 4)) + 8);
+
+    size_t smplOffset = 0, smplSize = 0, sm24Offset = 0, sm24Size = 0;
+    RecordTable phdr, pbag, pmod, pgen, inst, ibag, imod, igen, shdr;
+
+    // Top level: LIST INFO, LIST sdta, LIST pdta
+    for (size_t list = 12; list + 12 <= riffEnd;)
+    {
+        const size_t listSize = readU32(file + list + 4);
+        const size_t listEnd = std::min(riffEnd, list + 8 + listSize);
+
+        if (chunkIs(file + list, "LIST"))
+        {
+            const uint8_t* listType = file + list + 8;
+            for (size_t chunk = list + 12; chunk + 8 <= listEnd;)
+            {
+                const uint8_t* id = file + chunk;
+                const size_t size = std::min<size_t>(readU32(id + 4), listEnd - chunk - 8);
+                const uint8_t* body = id + 8;
+
+                if (chunkIs(listType, "INFO"))
+                {
+                    if (chunkIs(id, "INAM"))
+                        romName_ = readName(body, size);
+                    else if (chunkIs(id, "ifil") && size >= 4)
+                        romVersion_ = std::to_string(readU16(body)) + "." + std::to_string(readU16(body + 2));
+                }
+                else if (chunkIs(listType, "sdta"))
+                {
+                    if (chunkIs(id, "smpl"))
+                    {
+                        smplOffset = chunk + 8;
+                        smplSize = size;
+                    }
+                    else if (chunkIs(id, "sm24"))
+                    {
+                        sm24Offset = chunk + 8;
+                        sm24Size = size;
+                    }
+                }
+                else if (chunkIs(listType, "pdta"))
+                {
+                    auto table = [&](RecordTable& target, size_t recordSize) {
+                        target = { body, recordSize, size / recordSize };
+                    };
+
+                    if (chunkIs(id, "phdr")) table(phdr, 38);
+                    else if (chunkIs(id, "pbag")) table(pbag, 4);
+                    else if (chunkIs(id, "pmod")) table(pmod, 10);
+                    else if (chunkIs(id, "pgen")) table(pgen, 4);
+                    else if (chunkIs(id, "inst")) table(inst, 22);
+                    else if (chunkIs(id, "ibag")) table(ibag, 4);
+                    else if (chunkIs(id, "imod")) table(imod, 10);
+                    else if (chunkIs(id, "igen")) table(igen, 4);
+                    else if (chunkIs(id, "shdr")) table(shdr, 46);
+                }
+
+                chunk += 8 + size + (size & 1);
+            }
+        }
+
+        list = listEnd + (listSize & 1);
+    }
+
+    // Every table ends with a terminal record
+    if (phdr.count < 2 || inst.count < 2 || shdr.count < 2 || smplSize == 0)
+        return false;
+
+    for (size_t i = 0; i + 1 < shdr.count; ++i)
+    {
+        const uint8_t* record = shdr[i];
+        SampleHeader header;
+        header.name = readName(record, 20);
+        header.start = readU32(record + 20);
+        header.end = readU32(record + 24);
+        header.loopStart = readU32(record + 28);
+        header.loopEnd = readU32(record + 32);
+        header.sampleRate = readU32(record + 36);
+        header.originalPitch = record[40];
+        header.pitchCorrection = static_cast<int8_t>(record[41]);
+        header.sampleLink = readU16(record + 42);
+        header.sampleType = readU16(record + 44);
+        sampleHeaders_.push_back(header);
+    }
+
+    if (!loadSampleData(file, smplOffset, smplSize, sm24Offset, sm24Size))
+        return false;
+
+    // Flatten: one zone per (preset zone, instrument zone) pair with
+    // overlapping ranges, generators resolved down to engine units
+    const GeneratorSet defaults = instrumentDefaults();
+    std::vector<int> stereoSampleForLeft(sampleHeaders_.size(), -1);
+
+    for (size_t p = 0; p + 1 < phdr.count; ++p)
+    {
+        Instrument preset;
+        preset.name = readName(phdr[p], 20);
+        preset.presetNumber = readU16(phdr[p] + 20);
+        preset.bank = readU16(phdr[p] + 22);
+
+        forEachZone(pbag, pgen, pmod, readU16(phdr[p] + 24), readU16(phdr[p + 1] + 24), GenInstrument,
+                    [&](const GeneratorSet& presetGlobal, const GeneratorSet& presetZone, int instrument) {
+            if (instrument + 1 >= static_cast<int>(inst.count))
+                return;
+
+            GeneratorSet presetGens = presetGlobal;
+            presetGens.overrideWith(presetZone);
+
+            forEachZone(ibag, igen, imod, readU16(inst[instrument] + 20), readU16(inst[instrument + 1] + 20), GenSampleID,
+                        [&](const GeneratorSet& instrumentGlobal, const GeneratorSet& instrumentZone, int sampleId) {
+                if (sampleId >= static_cast<int>(sampleHeaders_.size()) || !samples_[static_cast<size_t>(sampleId)])
+                    return;
+
+                GeneratorSet gens = defaults;
+                gens.overrideWith(instrumentGlobal);
+                gens.overrideWith(instrumentZone);
+
+                Zone zone;
+                zone.keyRangeLow = std::max(gens.rangeLow(GenKeyRange), presetGens.rangeLow(GenKeyRange));
+                zone.keyRangeHigh = std::min(gens.rangeHigh(GenKeyRange), presetGens.rangeHigh(GenKeyRange));
+                zone.velocityRangeLow = std::max(gens.rangeLow(GenVelRange), presetGens.rangeLow(GenVelRange));
+                zone.velocityRangeHigh = std::min(gens.rangeHigh(GenVelRange), presetGens.rangeHigh(GenVelRange));
+                if (zone.keyRangeLow > zone.keyRangeHigh || zone.velocityRangeLow > zone.velocityRangeHigh)
+                    return;
+
+                int value[GenCount];
+                for (int g = 0; g < GenCount; ++g)
+                    value[g] = gens.value[g] + (isPresetAdditive(g) && presetGens.set[g] ? presetGens.value[g] : 0);
+
+                const SampleHeader& header = sampleHeaders_[static_cast<size_t>(sampleId)];
+                const int numFrames = samples_[static_cast<size_t>(sampleId)]->numSamples;
+
+                zone.hasGenerators = true;
+                zone.sampleIndex = sampleId;
+                zone.rootKey = value[GenOverridingRootKey] >= 0 ? value[GenOverridingRootKey]
+                             : (header.originalPitch <= 127 ? header.originalPitch : 60);
+                zone.tuning = value[GenCoarseTune] * 100.0 + value[GenFineTune] + header.pitchCorrection;
+                zone.scaleTuning = static_cast<float>(value[GenScaleTuning]);
+                zone.pan = std::max(-500, std::min(500, value[GenPan]));
+                zone.attenuation = static_cast<float>(std::max(0, std::min(1440, value[GenInitialAttenuation])) / 10.0);
+
+                zone.envAttack = static_cast<float>(timecentsToSeconds(std::max(-12000, std::min(8000, value[GenAttackVolEnv]))));
+                zone.envHold = static_cast<float>(timecentsToSeconds(std::max(-12000, std::min(5000, value[GenHoldVolEnv]))));
+                zone.envDecay = static_cast<float>(timecentsToSeconds(std::max(-12000, std::min(8000, value[GenDecayVolEnv]))));
+                zone.envRelease = static_cast<float>(timecentsToSeconds(std::max(-12000, std::min(8000, value[GenReleaseVolEnv]))));
+                zone.envSustain = static_cast<float>(std::pow(10.0, -std::max(0, std::min(1440, value[GenSustainVolEnv])) / 200.0));
+                zone.envHoldKeyScale = static_cast<float>(value[GenKeynumToVolEnvHold]);
+                zone.envDecayKeyScale = static_cast<float>(value[GenKeynumToVolEnvDecay]);
+
+                // Cutoff in absolute cents above 8.176 Hz; Q in centibels of resonant peak
+                const int cutoffCents = std::max(1500, std::min(13500, value[GenInitialFilterFc]));
+                zone.filterCutoff = static_cast<float>(std::min(20000.0, 8.176 * std::exp2(cutoffCents / 1200.0)));
+                zone.filterQ = static_cast<float>(clampGenerator(value[GenInitialFilterQ], 0, 960));
+                zone.filterResonance = static_cast<float>(ModulatorProgram::resonanceForQ(zone.filterQ));
+
+                // Modulators: defaults overridden by the instrument's, plus the preset's
+                ModulatorProgram& program = zone.modulators;
+                compileModulators(gens.modulators, presetGens.modulators, program);
+                program.initial[ModulatorProgram::FilterQ] = zone.filterQ;
+                program.initial[ModulatorProgram::VibLfoToPitch] = static_cast<float>(clampGenerator(value[GenVibLfoToPitch], -12000, 12000));
+                program.initial[ModulatorProgram::ModLfoToPitch] = static_cast<float>(clampGenerator(value[GenModLfoToPitch], -12000, 12000));
+                program.initial[ModulatorProgram::ModLfoToFilterCutoff] = static_cast<float>(clampGenerator(value[GenModLfoToFilterFc], -12000, 12000));
+                program.initial[ModulatorProgram::ModLfoToVolume] = static_cast<float>(clampGenerator(value[GenModLfoToVolume], -960, 960));
+                program.vibLfo.delay = static_cast<float>(timecentsToSeconds(clampGenerator(value[GenDelayVibLfo], -12000, 5000)));
+                program.vibLfo.frequency = static_cast<float>(8.176 * std::exp2(clampGenerator(value[GenFreqVibLfo], -16000, 4500) / 1200.0));
+                program.modLfo.delay = static_cast<float>(timecentsToSeconds(clampGenerator(value[GenDelayModLfo], -12000, 5000)));
+                program.modLfo.frequency = static_cast<float>(8.176 * std::exp2(clampGenerator(value[GenFreqModLfo], -16000, 4500) / 1200.0));
+
+                zone.sampleMode = value[GenSampleModes] & 3;
+                if (zone.sampleMode == 2)
+                    zone.sampleMode = 0;
+                zone.loopStart = static_cast<int>(header.loopStart) - static_cast<int>(header.start)
+                               + value[GenStartLoopOffset] + 32768 * value[GenStartLoopCoarseOffset];
+                zone.loopEnd = static_cast<int>(header.loopEnd) - static_cast<int>(header.start)
+                             + value[GenEndLoopOffset] + 32768 * value[GenEndLoopCoarseOffset];
+                zone.loopStart = std::max(0, std::min(numFrames, zone.loopStart));
+                zone.loopEnd = std::max(zone.loopStart, std::min(numFrames, zone.loopEnd));
+
+                preset.zones.push_back(zone);
+            });
+        });
+
+        mergeStereoZones(preset, stereoSampleForLeft);
+        indexZones(preset);
+        instruments_.push_back(std::move(preset));
+    }
+
+    assignZoneLoops();
+
+    // Mono halves merged into stereo samples are no longer played
+    std::vector<bool> used(samples_.size(), false);
+    for (const auto& preset : instruments_)
+        for (const auto& zone : preset.zones)
+            used[static_cast<size_t>(zone.sampleIndex)] = true;
+    for (size_t i = 0; i < samples_.size(); ++i)
+        if (!used[i])
+            samples_[i].reset();
+
+    if (romVersion_.empty())
+        romVersion_ = "2.0";
+
+    return !instruments_.empty();
+}
+
+bool SF2Reader::loadSampleData(const uint8_t* file, size_t smplOffset, size_t smplSize,
+                               size_t sm24Offset, size_t sm24Size)
+{
+    const size_t totalFrames = smplSize / 2;
+    const uint8_t* pcm = file + smplOffset;
+    const uint8_t* low = sm24Size >= totalFrames ? file + sm24Offset : nullptr;
+
+    samples_.clear();
+    samples_.resize(sampleHeaders_.size());
+
+    for (size_t i = 0; i < sampleHeaders_.size(); ++i)
+    {
+        const SampleHeader& header = sampleHeaders_[i];
+
+        // ROM samples live in hardware we don't have
+        if ((header.sampleType & sampleTypeRom) || header.end <= header.start || header.end > totalFrames
+            || header.sampleRate == 0)
+            continue;
+
+        auto sample = std::make_unique<Sample>();
+        sample->numSamples = static_cast<int>(header.end - header.start);
+        sample->numChannels = 1;
+        sample->sampleRate = static_cast<int>(header.sampleRate);
+        sample->rootNote = header.originalPitch <= 127 ? header.originalPitch : 60;
+        sample->pitchCorrection = header.pitchCorrection;
+        sample->ownLoop = true;
+        if (header.loopEnd > header.loopStart && header.loopStart >= header.start && header.loopEnd <= header.end)
+        {
+            sample->loopStart = static_cast<int>(header.loopStart - header.start);
+            sample->loopEnd = static_cast<int>(header.loopEnd - header.start);
+        }
+
+        sample->channels.assign(1, AudioChannelBuffer(static_cast<size_t>(sample->numSamples)));
+        decodeFrames(pcm, low, header.start, sample->numSamples, sample->channels[0].data());
+
+        sample->addGuardFrames();
+        samples_[i] = std::move(sample);
+    }
+
+    return true;
+}
+
+void SF2Reader::decodeFrames(const uint8_t* smpl, const uint8_t* sm24, size_t firstFrame, int numFrames, float* frames)
+{
+    // 16-bit words, extended to 24 bits by sm24 when present
+    for (int n = 0; n < numFrames; ++n)
+    {
+        const size_t frame = firstFrame + static_cast<size_t>(n);
+        if (sm24)
+            frames[n] = static_cast<float>((readS16(smpl + 2 * frame) * 256 + sm24[frame]) / 8388608.0);
+        else
+            frames[n] = static_cast<float>(readS16(smpl + 2 * frame) / 32768.0);
+    }
+}
+
+void SF2Reader::mergeStereoZones(Instrument& instrument, std::vector<int>& stereoSampleForLeft)
+{
+    auto& zones = instrument.zones;
+    std::vector<bool> merged(zones.size(), false);
+
+    for (size_t a = 0; a < zones.size(); ++a)
+    {
+        const int typeA = sampleHeaders_[static_cast<size_t>(zones[a].sampleIndex)].sampleType;
+        if (merged[a] || (typeA != sampleTypeLeft && typeA != sampleTypeRight))
+            continue;
+
+        // The partner zone plays the linked sample over the same ranges
+        const int link = sampleHeaders_[static_cast<size_t>(zones[a].sampleIndex)].sampleLink;
+        for (size_t b = a + 1; b < zones.size(); ++b)
+        {
+            const Zone& other = zones[b];
+            if (merged[b] || other.sampleIndex != link
+                || other.keyRangeLow != zones[a].keyRangeLow || other.keyRangeHigh != zones[a].keyRangeHigh
+                || other.velocityRangeLow != zones[a].velocityRangeLow
+                || other.velocityRangeHigh != zones[a].velocityRangeHigh)
+                continue;
+
+            const bool aIsLeft = typeA == sampleTypeLeft;
+            const int leftIndex = aIsLeft ? zones[a].sampleIndex : other.sampleIndex;
+            const int rightIndex = aIsLeft ? other.sampleIndex : zones[a].sampleIndex;
+
+            // One stereo sample per pair, shared by every preset that plays it
+            int stereoIndex = stereoSampleForLeft[static_cast<size_t>(leftIndex)];
+            if (stereoIndex < 0)
+            {
+                const Sample& left = *samples_[static_cast<size_t>(leftIndex)];
+                const Sample& right = *samples_[static_cast<size_t>(rightIndex)];
+
+                auto stereo = std::make_unique<Sample>();
+                stereo->numSamples = std::min(left.numSamples, right.numSamples);
+                stereo->numChannels = 2;
+                stereo->sampleRate = left.sampleRate;
+                stereo->rootNote = left.rootNote;
+                stereo->pitchCorrection = left.pitchCorrection;
+                stereo->loopStart = std::min(left.loopStart, stereo->numSamples);
+                stereo->loopEnd = std::min(left.loopEnd, stereo->numSamples);
+                stereo->ownLoop = true;
+                stereo->channels.assign(2, AudioChannelBuffer(static_cast<size_t>(stereo->numSamples)));
+                std::copy(left.frames(0), left.frames(0) + stereo->numSamples, stereo->channels[0].data());
+                std::copy(right.frames(0), right.frames(0) + stereo->numSamples, stereo->channels[1].data());
+                stereo->addGuardFrames();
+
+                SampleHeader header = sampleHeaders_[static_cast<size_t>(leftIndex)];
+                header.sampleType = 1;
+
+                stereoIndex = static_cast<int>(samples_.size());
+                samples_.push_back(std::move(stereo));
+                sampleHeaders_.push_back(header);
+                stereoSampleForLeft[static_cast<size_t>(leftIndex)] = stereoIndex;
+                stereoSampleForLeft.push_back(-1);
+            }
+
+            // The halves' opposite hard pans become the stereo image; any offset stays
+            Zone& zone = aIsLeft ? zones[a] : zones[b];
+            zone.pan = (zones[a].pan + other.pan) / 2;
+            zone.sampleIndex = stereoIndex;
+            zone.loopEnd = std::min(zone.loopEnd, samples_[static_cast<size_t>(stereoIndex)]->numSamples);
+            zone.loopStart = std::min(zone.loopStart, zone.loopEnd);
+            merged[aIsLeft ? b : a] = true;
+            break;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t z = 0; z < zones.size(); ++z)
+        if (!merged[z])
+            zones[kept++] = zones[z];
+    zones.resize(kept);
+}
+
+void SF2Reader::assignZoneLoops()
+{
+    // A sample loops at one place, so zones whose loop offsets move the loop
+    // play a copy of the sample looping there (shared by identical zones)
+    struct LoopedCopy
+    {
+        int source;
+        int loopStart;
+        int loopEnd;
+        int index;
+    };
+    std::vector<LoopedCopy> copies;
+
+    for (auto& preset : instruments_)
+    {
+        for (auto& zone : preset.zones)
+        {
+            const Sample& source = *samples_[static_cast<size_t>(zone.sampleIndex)];
+            if (zone.sampleMode == 0 || (zone.loopStart == source.loopStart && zone.loopEnd == source.loopEnd))
+                continue;
+
+            auto copy = std::find_if(copies.begin(), copies.end(), [&](const LoopedCopy& c) {
+                return c.source == zone.sampleIndex && c.loopStart == zone.loopStart && c.loopEnd == zone.loopEnd;
+            });
+
+            if (copy == copies.end())
+            {
+                // Guard frames follow the loop, so pad the copy afresh
+                auto looped = std::make_unique<Sample>(source);
+                for (int ch = 0; ch < source.numChannels; ++ch)
+                    looped->channels[static_cast<size_t>(ch)].assign(source.frames(ch), source.frames(ch) + source.numSamples);
+                looped->guarded = false;
+                looped->loopStart = zone.loopStart;
+                looped->loopEnd = zone.loopEnd;
+                looped->addGuardFrames();
+
+                copies.push_back({ zone.sampleIndex, zone.loopStart, zone.loopEnd, static_cast<int>(samples_.size()) });
+                sampleHeaders_.push_back(sampleHeaders_[static_cast<size_t>(zone.sampleIndex)]);
+                samples_.push_back(std::move(looped));
+                copy = copies.end() - 1;
+            }
+
+            zone.sampleIndex = copy->index;
+        }
+    }
+}
+
+void SF2Reader::indexZones(Instrument& instrument)
+{
+    // Counting sort of (key, zone) pairs: count per key, then fill in zone order
+    instrument.keyZoneStart.assign(129, 0);
+    for (const auto& zone : instrument.zones)
+        for (int key = std::max(0, zone.keyRangeLow); key <= std::min(127, zone.keyRangeHigh); ++key)
+            ++instrument.keyZoneStart[static_cast<size_t>(key) + 1];
+    for (size_t key = 0; key < 128; ++key)
+        instrument.keyZoneStart[key + 1] += instrument.keyZoneStart[key];
+
+    instrument.keyZones.resize(static_cast<size_t>(instrument.keyZoneStart[128]));
+    std::vector<int> fill(instrument.keyZoneStart.begin(), instrument.keyZoneStart.end() - 1);
+    for (size_t z = 0; z < instrument.zones.size(); ++z)
+    {
+        const Zone& zone = instrument.zones[z];
+        for (int key = std::max(0, zone.keyRangeLow); key <= std::min(127, zone.keyRangeHigh); ++key)
+            instrument.keyZones[static_cast<size_t>(fill[static_cast<size_t>(key)]++)] = static_cast<int>(z);
+    }
+}
+
+const SF2Reader::Instrument* SF2Reader::getInstrument(int index) const
+{
+    if (index >= 0 && index < static_cast<int>(instruments_.size()))
+        return &instruments_[index];
+    return nullptr;
+}
+
+const Sample* SF2Reader::getSample(int index) const
+{
+    if (index >= 0 && index < static_cast<int>(samples_.size()))
+        return samples_[index].get();
+    return nullptr;
+}
+
+const Sample* SF2Reader::findSample(int instrumentIndex, int midiNote, float velocity) const
+{
+    const Zone* zone = findZone(instrumentIndex, midiNote, velocity);
+    return zone ? getSample(zone->sampleIndex) : nullptr;
+}
+
+const SF2Reader::Zone* SF2Reader::findZone(int instrumentIndex, int midiNote, float velocity) const
+{
+    const Instrument* inst = getInstrument(instrumentIndex);
+    if (!inst)
+        return nullptr;
+
+    // Only the zones covering the key are candidates
+    if (inst->keyZoneStart.size() == 129)
+    {
+        if (midiNote < 0 || midiNote > 127)
+            return nullptr;
+
+        const int* candidate = inst->keyZones.data() + inst->keyZoneStart[static_cast<size_t>(midiNote)];
+        const int* end = inst->keyZones.data() + inst->keyZoneStart[static_cast<size_t>(midiNote) + 1];
+        for (; candidate != end; ++candidate)
+        {
+            const Zone& zone = inst->zones[static_cast<size_t>(*candidate)];
+            if (velocity >= zone.velocityRangeLow && velocity <= zone.velocityRangeHigh)
+                return &zone;
+        }
+        return nullptr;
+    }
+
+    // Find zone matching MIDI note and velocity
+    for (const auto& zone : inst->zones)
+    {
+        if (midiNote >= zone.keyRangeLow && midiNote <= zone.keyRangeHigh &&
+            velocity >= zone.velocityRangeLow && velocity <= zone.velocityRangeHigh)
+        {
+            return &zone;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace DSP
@@ -0,0 +1,843 @@
+/*
+  ==============================================================================
+
+    SamSamplerSFZ.cpp
+    SFZ reader for Sam Sampler
+    WAV decoding, SFZ text parsing and compilation of regions into the
+    reader's flat zone records
+
+  ==============================================================================
+*/
+
+#include "dsp/SamSamplerDSP.h"
+#include "SamSamplerByteOrder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DSP {
+
+namespace {
+
+//==============================================================================
+// WAV Decoding
+//==============================================================================
+
+constexpr int wavFormatPcm = 1;
+constexpr int wavFormatFloat = 3;
+constexpr int wavFormatExtensible = 0xFFFE;
+
+// A WAV file's format and where its frames sit in the mapping
+struct WavInfo
+{
+    int format = 0;                 // wavFormatPcm or wavFormatFloat
+    int numChannels = 0;
+    int sampleRate = 0;
+    int bytesPerSample = 0;
+    size_t blockAlign = 0;
+    const uint8_t* frames = nullptr;
+    size_t numFrames = 0;
+
+    // smpl chunk: the first loop (end exclusive) and the unity note
+    bool hasLoop = false;
+    size_t loopStart = 0;
+    size_t loopEnd = 0;
+    int unityNote = -1;
+};
+
+bool parseWav(const uint8_t* data, size_t size, WavInfo& wav)
+{
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+        return false;
+
+    bool hasFormat = false;
+    for (size_t chunk = 12; chunk + 8 <= size;)
+    {
+        const uint8_t* id = data + chunk;
+        const size_t chunkSize = std::min<size_t>(readU32(id + 4), size - chunk - 8);
+        const uint8_t* body = id + 8;
+
+        if (std::memcmp(id, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            wav.format = readU16(body);
+            wav.numChannels = readU16(body + 2);
+            wav.sampleRate = static_cast<int>(readU32(body + 4));
+            wav.blockAlign = readU16(body + 12);
+            wav.bytesPerSample = readU16(body + 14) / 8;
+            if (wav.format == wavFormatExtensible && chunkSize >= 40)
+                wav.format = readU16(body + 24); // Sub-format GUID starts with the format tag
+            hasFormat = true;
+        }
+        else if (std::memcmp(id, "data", 4) == 0)
+        {
+            wav.frames = body;
+            wav.numFrames = chunkSize;      // Bytes until the format is known
+        }
+        else if (std::memcmp(id, "smpl", 4) == 0 && chunkSize >= 36)
+        {
+            wav.unityNote = static_cast<int>(readU32(body + 12));
+            if (readU32(body + 28) > 0 && chunkSize >= 60)
+            {
+                // Loop end is inclusive in the file
+                wav.loopStart = readU32(body + 36 + 8);
+                wav.loopEnd = static_cast<size_t>(readU32(body + 36 + 12)) + 1;
+                wav.hasLoop = wav.loopEnd > wav.loopStart;
+            }
+        }
+
+        chunk += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    const bool pcm = wav.format == wavFormatPcm && wav.bytesPerSample >= 1 && wav.bytesPerSample <= 4;
+    const bool floating = wav.format == wavFormatFloat && (wav.bytesPerSample == 4 || wav.bytesPerSample == 8);
+    if (!hasFormat || !wav.frames || (!pcm && !floating) || wav.numChannels < 1 || wav.sampleRate <= 0
+        || wav.blockAlign < static_cast<size_t>(wav.numChannels * wav.bytesPerSample))
+        return false;
+
+    wav.numFrames /= wav.blockAlign;
+    if (wav.unityNote > 127)
+        wav.unityNote = -1;
+    if (wav.hasLoop && wav.loopEnd > wav.numFrames)
+        wav.hasLoop = false;
+    return wav.numFrames > 0;
+}
+
+template <typename Read>
+void decodeFrames(const WavInfo& wav, int channel, size_t begin, size_t count, float* out, Read read)
+{
+    const uint8_t* p = wav.frames + begin * wav.blockAlign + static_cast<size_t>(channel * wav.bytesPerSample);
+    for (size_t n = 0; n < count; ++n, p += wav.blockAlign)
+        out[n] = read(p);
+}
+
+// Convert frames [begin, begin + count) of one channel to float
+void decodeChannel(const WavInfo& wav, int channel, size_t begin, size_t count, float* out)
+{
+    if (wav.format == wavFormatFloat)
+    {
+        if (wav.bytesPerSample == 4)
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                float value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            });
+        else
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                double value;
+                std::memcpy(&value, p, sizeof(value));
+                return static_cast<float>(value);
+            });
+        return;
+    }
+
+    switch (wav.bytesPerSample)
+    {
+        case 1: // Unsigned
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                return (p[0] - 128) / 128.0f;
+            });
+            break;
+        case 2:
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                return static_cast<int16_t>(readU16(p)) / 32768.0f;
+            });
+            break;
+        case 3:
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                const int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0] << 8 | p[1] << 16 | p[2] << 24)) >> 8;
+                return static_cast<float>(value / 8388608.0);
+            });
+            break;
+        default:
+            decodeFrames(wav, channel, begin, count, out, [](const uint8_t* p) {
+                return static_cast<float>(static_cast<int32_t>(readU32(p)) / 2147483648.0);
+            });
+            break;
+    }
+}
+
+//==============================================================================
+// SFZ Parsing
+//==============================================================================
+
+// Opcode values in SFZ units. Every header level holds a full set, so a
+// region starts as a copy of its group, which started as a copy of its
+// master, and so on up to <global>
+struct SfzRegion
+{
+    std::string sample;             // Resolved path
+    int loKey = 0;
+    int hiKey = 127;
+    int loVel = 0;
+    int hiVel = 127;
+    int keyCenter = 60;             // -1: the WAV's unity note (pitch_keycenter=sample)
+    int transpose = 0;
+    float tune = 0.0f;              // Cents
+    float pitchKeytrack = 100.0f;   // Cents per key
+    float volume = 0.0f;            // dB
+    float pan = 0.0f;               // -100 (left) to 100 (right)
+    float ampVeltrack = 100.0f;     // Percent
+
+    // Amplitude envelope (seconds; sustain in percent)
+    float attack = 0.0f;
+    float hold = 0.0f;
+    float decay = 0.0f;
+    float sustain = 100.0f;
+    float release = 0.001f;
+
+    float cutoff = -1.0f;           // Hz; negative means no filter
+    float resonance = 0.0f;         // dB
+    float filVeltrack = 0.0f;       // Cents at full velocity
+    float bendUp = 0.0f;            // Cents
+    bool hasBendUp = false;         // Otherwise the engine's pitch bend range applies
+
+    int loopMode = -1;              // -1: loop when the WAV has a loop, else a zone sampleMode
+    long long offset = 0;           // First frame played
+    long long end = -1;             // Last frame played (inclusive); -1 plays to the end
+    long long loopStart = -1;       // -1: the WAV's loop
+    long long loopEnd = -1;         // Inclusive
+    bool releaseTrigger = false;
+};
+
+inline bool isNameChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+class SfzParser
+{
+public:
+    explicit SfzParser(std::string rootDirectory) : rootDirectory_(std::move(rootDirectory)) {}
+
+    std::vector<SfzRegion> regions;
+
+    // Parse a file, and its includes, into regions; false if it cannot be read
+    bool parseFile(const std::string& path, int depth)
+    {
+        MappedFile file;
+        if (!file.open(path.c_str()))
+            return false;
+
+        parseText(reinterpret_cast<const char*>(file.data()), reinterpret_cast<const char*>(file.data()) + file.size(),
+                  depth);
+        return true;
+    }
+
+    // The last region ends with the top-level file
+    void finish() { endRegion(); }
+
+private:
+    enum class Level { None, Control, Global, Master, Group, Region };
+
+    static constexpr int maxIncludeDepth = 16;
+
+    std::string rootDirectory_;
+    std::string defaultPath_;
+    int noteOffset_ = 0;
+    std::vector<std::pair<std::string, std::string>> defines_;
+
+    Level level_ = Level::None;
+    SfzRegion global_;
+    SfzRegion master_;
+    SfzRegion group_;
+    SfzRegion region_;
+
+    // Levels copied when the next group or region starts (a level's opcodes
+    // follow its header, so copies are taken at the child's header)
+    const SfzRegion* groupParent_ = &global_;
+    const SfzRegion* regionParent_ = &global_;
+
+    void parseText(const char* p, const char* end, int depth)
+    {
+        while (p < end)
+        {
+            const char c = *p;
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                ++p;
+            }
+            else if (c == '/' && p + 1 < end && p[1] == '/')
+            {
+                p = skipLine(p, end);
+            }
+            else if (c == '/' && p + 1 < end && p[1] == '*')
+            {
+                p += 2;
+                while (p + 1 < end && !(p[0] == '*' && p[1] == '/'))
+                    ++p;
+                p = std::min(end, p + 2);
+            }
+            else if (c == '<')
+            {
+                const char* close = static_cast<const char*>(std::memchr(p, '>', static_cast<size_t>(end - p)));
+                if (!close)
+                    return;
+                beginHeader(std::string(p + 1, close));
+                p = close + 1;
+            }
+            else if (c == '#')
+            {
+                p = parseDirective(p, end, depth);
+            }
+            else
+            {
+                p = parseOpcode(p, end);
+            }
+        }
+    }
+
+    static const char* skipLine(const char* p, const char* end)
+    {
+        while (p < end && *p != '\n')
+            ++p;
+        return p;
+    }
+
+    // Line end, header or comment
+    static bool endsValue(const char* p, const char* end)
+    {
+        if (p >= end || *p == '\n' || *p == '\r' || *p == '<')
+            return true;
+        return *p == '/' && p + 1 < end && (p[1] == '/' || p[1] == '*');
+    }
+
+    static bool startsOpcode(const char* p, const char* end)
+    {
+        const char* name = p;
+        while (name < end && isNameChar(*name))
+            ++name;
+        return name > p && name < end && *name == '=';
+    }
+
+    const char* parseOpcode(const char* p, const char* end)
+    {
+        const char* nameEnd = p;
+        while (nameEnd < end && isNameChar(*nameEnd))
+            ++nameEnd;
+        if (nameEnd == p || nameEnd >= end || *nameEnd != '=')
+            return skipLine(p, end); // Not an opcode: drop the rest of the line
+
+        // Values run to the next opcode on the line, so sample paths keep their spaces
+        const char* value = nameEnd + 1;
+        const char* valueEnd = value;
+        while (!endsValue(valueEnd, end))
+        {
+            if (isBlank(*valueEnd))
+            {
+                const char* next = valueEnd;
+                while (next < end && isBlank(*next))
+                    ++next;
+                if (endsValue(next, end) || startsOpcode(next, end))
+                    break;
+                valueEnd = next;
+            }
+            else
+            {
+                ++valueEnd;
+            }
+        }
+
+        std::string name(p, nameEnd);
+        std::string text(value, valueEnd);
+        expandDefines(name);
+        expandDefines(text);
+        applyOpcode(name, text);
+        return valueEnd;
+    }
+
+    const char* parseDirective(const char* p, const char* end, int depth)
+    {
+        auto word = [end](const char*& q) {
+            while (q < end && isBlank(*q))
+                ++q;
+            const char* begin = q;
+            while (q < end && !std::isspace(static_cast<unsigned char>(*q)))
+                ++q;
+            return std::string(begin, q);
+        };
+
+        const char* q = p;
+        const std::string directive = word(q);
+        if (directive == "#define")
+        {
+            std::string name = word(q);
+            std::string value = word(q);
+            if (name.size() > 1 && name[0] == '$')
+            {
+                expandDefines(value);
+                auto existing = std::find_if(defines_.begin(), defines_.end(),
+                                             [&](const auto& define) { return define.first == name; });
+                if (existing != defines_.end())
+                    existing->second = value;
+                else
+                    defines_.emplace_back(std::move(name), std::move(value));
+            }
+        }
+        else if (directive == "#include")
+        {
+            const char* open = static_cast<const char*>(std::memchr(q, '"', static_cast<size_t>(skipLine(q, end) - q)));
+            const char* close = open ? static_cast<const char*>(std::memchr(open + 1, '"', static_cast<size_t>(end - open - 1)))
+                                     : nullptr;
+            if (close && depth < maxIncludeDepth)
+            {
+                std::string path(open + 1, close);
+                expandDefines(path);
+                parseFile(resolvePath(path), depth + 1); // A missing include leaves the rest intact
+                q = close + 1;
+            }
+        }
+        return skipLine(q, end);
+    }
+
+    // Replace each $name with the longest definition that matches there
+    void expandDefines(std::string& text) const
+    {
+        if (defines_.empty() || text.find('$') == std::string::npos)
+            return;
+
+        std::string expanded;
+        for (size_t i = 0; i < text.size();)
+        {
+            const std::pair<std::string, std::string>* match = nullptr;
+            if (text[i] == '$')
+                for (const auto& define : defines_)
+                    if (text.compare(i, define.first.size(), define.first) == 0
+                        && (!match || define.first.size() > match->first.size()))
+                        match = &define;
+
+            if (match)
+            {
+                expanded += match->second;
+                i += match->first.size();
+            }
+            else
+            {
+                expanded += text[i++];
+            }
+        }
+        text = std::move(expanded);
+    }
+
+    std::string resolvePath(std::string path) const
+    {
+        std::replace(path.begin(), path.end(), '\\', '/');
+        const bool absolute = (!path.empty() && path[0] == '/')
+            || (path.size() > 1 && std::isalpha(static_cast<unsigned char>(path[0])) && path[1] == ':');
+        return absolute ? path : rootDirectory_ + path;
+    }
+
+    void endRegion()
+    {
+        if (level_ == Level::Region)
+            regions.push_back(region_);
+    }
+
+    void beginHeader(const std::string& header)
+    {
+        endRegion();
+
+        if (header == "region")
+        {
+            region_ = *regionParent_;
+            level_ = Level::Region;
+        }
+        else if (header == "group")
+        {
+            group_ = *groupParent_;
+            regionParent_ = &group_;
+            level_ = Level::Group;
+        }
+        else if (header == "master")
+        {
+            master_ = global_;
+            groupParent_ = regionParent_ = &master_;
+            level_ = Level::Master;
+        }
+        else if (header == "global")
+        {
+            global_ = SfzRegion();
+            groupParent_ = regionParent_ = &global_;
+            level_ = Level::Global;
+        }
+        else if (header == "control")
+        {
+            level_ = Level::Control;
+        }
+        else
+        {
+            level_ = Level::None; // <curve>, <effect>, <midi>: nothing the engine plays
+        }
+    }
+
+    SfzRegion* levelRegion()
+    {
+        switch (level_)
+        {
+            case Level::Global: return &global_;
+            case Level::Master: return &master_;
+            case Level::Group: return &group_;
+            case Level::Region: return &region_;
+            default: return nullptr;
+        }
+    }
+
+    // MIDI note from a number or a name (c4 = 60, c#4, db4), shifted by the control offsets
+    int parseNote(const std::string& value) const
+    {
+        static const int semitones[] = { 9, 11, 0, 2, 4, 5, 7 }; // a b c d e f g
+        int note;
+        const char letter = static_cast<char>(std::tolower(static_cast<unsigned char>(value.empty() ? '0' : value[0])));
+        if (letter >= 'a' && letter <= 'g')
+        {
+            size_t i = 1;
+            note = semitones[letter - 'a'];
+            if (i < value.size() && value[i] == '#')
+            {
+                ++note;
+                ++i;
+            }
+            else if (i < value.size() && value[i] == 'b')
+            {
+                --note;
+                ++i;
+            }
+            note += (std::atoi(value.c_str() + i) + 1) * 12;
+        }
+        else
+        {
+            note = std::atoi(value.c_str());
+        }
+        return note + noteOffset_;
+    }
+
+    void applyOpcode(const std::string& opcode, const std::string& value)
+    {
+        const char* name = opcode.c_str();
+
+        if (level_ == Level::Control)
+        {
+            if (std::strcmp(name, "default_path") == 0)
+            {
+                defaultPath_ = value;
+                std::replace(defaultPath_.begin(), defaultPath_.end(), '\\', '/');
+            }
+            else if (std::strcmp(name, "note_offset") == 0)
+                noteOffset_ += std::atoi(value.c_str());
+            else if (std::strcmp(name, "octave_offset") == 0)
+                noteOffset_ += 12 * std::atoi(value.c_str());
+            return;
+        }
+
+        SfzRegion* region = levelRegion();
+        if (!region)
+            return;
+
+        const float number = static_cast<float>(std::strtod(value.c_str(), nullptr));
+        const long long frames = std::strtoll(value.c_str(), nullptr, 10);
+
+        if (std::strcmp(name, "sample") == 0)
+            region->sample = resolvePath(defaultPath_ + value);
+        else if (std::strcmp(name, "lokey") == 0)
+            region->loKey = parseNote(value);
+        else if (std::strcmp(name, "hikey") == 0)
+            region->hiKey = parseNote(value);
+        else if (std::strcmp(name, "key") == 0)
+            region->loKey = region->hiKey = region->keyCenter = parseNote(value);
+        else if (std::strcmp(name, "pitch_keycenter") == 0)
+            region->keyCenter = value == "sample" ? -1 : parseNote(value);
+        else if (std::strcmp(name, "lovel") == 0)
+            region->loVel = std::atoi(value.c_str());
+        else if (std::strcmp(name, "hivel") == 0)
+            region->hiVel = std::atoi(value.c_str());
+        else if (std::strcmp(name, "transpose") == 0)
+            region->transpose = std::atoi(value.c_str());
+        else if (std::strcmp(name, "tune") == 0)
+            region->tune = number;
+        else if (std::strcmp(name, "pitch_keytrack") == 0)
+            region->pitchKeytrack = number;
+        else if (std::strcmp(name, "volume") == 0)
+            region->volume = number;
+        else if (std::strcmp(name, "pan") == 0)
+            region->pan = number;
+        else if (std::strcmp(name, "amp_veltrack") == 0)
+            region->ampVeltrack = number;
+        else if (std::strcmp(name, "ampeg_attack") == 0)
+            region->attack = number;
+        else if (std::strcmp(name, "ampeg_hold") == 0)
+            region->hold = number;
+        else if (std::strcmp(name, "ampeg_decay") == 0)
+            region->decay = number;
+        else if (std::strcmp(name, "ampeg_sustain") == 0)
+            region->sustain = number;
+        else if (std::strcmp(name, "ampeg_release") == 0)
+            region->release = number;
+        else if (std::strcmp(name, "cutoff") == 0)
+            region->cutoff = number;
+        else if (std::strcmp(name, "resonance") == 0)
+            region->resonance = number;
+        else if (std::strcmp(name, "fil_veltrack") == 0)
+            region->filVeltrack = number;
+        else if (std::strcmp(name, "bend_up") == 0)
+        {
+            region->bendUp = number;
+            region->hasBendUp = true;
+        }
+        else if (std::strcmp(name, "loop_mode") == 0 || std::strcmp(name, "loopmode") == 0)
+        {
+            if (value == "loop_continuous")
+                region->loopMode = 1;
+            else if (value == "loop_sustain")
+                region->loopMode = 3;
+            else if (value == "no_loop" || value == "one_shot")
+                region->loopMode = 0;
+        }
+        else if (std::strcmp(name, "loop_start") == 0 || std::strcmp(name, "loopstart") == 0)
+            region->loopStart = frames;
+        else if (std::strcmp(name, "loop_end") == 0 || std::strcmp(name, "loopend") == 0)
+            region->loopEnd = frames;
+        else if (std::strcmp(name, "offset") == 0)
+            region->offset = std::max(0LL, frames);
+        else if (std::strcmp(name, "end") == 0)
+            region->end = frames;
+        else if (std::strcmp(name, "trigger") == 0)
+            region->releaseTrigger = value == "release" || value == "release_key";
+    }
+};
+
+// SF2 modulator sources and curves the compiled programs use (see ModulatorProgram::Op)
+constexpr uint8_t sourceVelocity = 2;
+constexpr uint8_t sourcePitchWheel = 14;
+constexpr uint8_t sourcePitchWheelSensitivity = 16;
+constexpr uint8_t shapeLinear = 0;
+constexpr uint8_t shapeBipolar = 2;
+constexpr uint8_t shapeConcaveFalling = 5;   // Concave, max to min: the SF2 velocity law
+
+// A region's opcodes in the zone record's units
+SF2Reader::Zone compileRegion(const SfzRegion& region, const Sample& sample, int sampleIndex, int sampleMode,
+                              int unityNote)
+{
+    SF2Reader::Zone zone;
+    zone.hasGenerators = true;
+    zone.sampleIndex = sampleIndex;
+    zone.keyRangeLow = std::max(0, region.loKey);
+    zone.keyRangeHigh = std::min(127, region.hiKey);
+    zone.velocityRangeLow = std::max(0, region.loVel);
+    zone.velocityRangeHigh = std::min(127, region.hiVel);
+    zone.rootKey = region.keyCenter >= 0 ? std::min(127, region.keyCenter) : (unityNote >= 0 ? unityNote : 60);
+    zone.tuning = region.transpose * 100.0 + region.tune;
+    zone.scaleTuning = region.pitchKeytrack;
+    zone.pan = static_cast<int>(std::max(-500.0f, std::min(500.0f, region.pan * 5.0f)));
+
+    // Zone levels only attenuate, so positive volumes play at 0 dB
+    zone.attenuation = std::max(0.0f, std::min(144.0f, -region.volume));
+
+    zone.envAttack = std::max(0.001f, region.attack);
+    zone.envHold = std::max(0.001f, region.hold);
+    zone.envDecay = std::max(0.001f, region.decay);
+    zone.envSustain = std::max(0.0f, std::min(1.0f, region.sustain / 100.0f));
+    zone.envRelease = std::max(0.001f, region.release);
+
+    if (region.cutoff > 0.0f)
+    {
+        zone.filterCutoff = std::min(20000.0f, region.cutoff);
+        zone.filterQ = std::max(0.0f, std::min(960.0f, region.resonance * 10.0f));
+        zone.filterResonance = static_cast<float>(ModulatorProgram::resonanceForQ(zone.filterQ));
+    }
+
+    zone.sampleMode = sampleMode;
+    zone.loopStart = sample.loopStart;
+    zone.loopEnd = sample.loopEnd;
+
+    // Velocity and pitch wheel, as the SF2 defaults do; the filter tracks
+    // velocity only when asked
+    ModulatorProgram& program = zone.modulators;
+    auto addOp = [&program](uint8_t source, uint8_t shape, uint8_t amountSource, ModulatorProgram::Target target,
+                            float amount) {
+        ModulatorProgram::Op op;
+        op.source = source;
+        op.sourceShape = shape;
+        op.amountSource = amountSource;
+        op.amountShape = shapeLinear;
+        op.target = static_cast<uint8_t>(target);
+        op.amount = amount;
+        program.ops.push_back(op);
+    };
+
+    if (region.ampVeltrack != 0.0f)
+        addOp(sourceVelocity, shapeConcaveFalling, 0, ModulatorProgram::Attenuation, 9.6f * region.ampVeltrack);
+    if (region.cutoff > 0.0f && region.filVeltrack != 0.0f)
+        addOp(sourceVelocity, shapeLinear, 0, ModulatorProgram::FilterCutoff, region.filVeltrack);
+    if (region.hasBendUp)
+        addOp(sourcePitchWheel, shapeBipolar, 0, ModulatorProgram::Pitch, region.bendUp);
+    else
+        addOp(sourcePitchWheel, shapeBipolar, sourcePitchWheelSensitivity, ModulatorProgram::Pitch, 12700.0f);
+    program.initial[ModulatorProgram::FilterQ] = zone.filterQ;
+    program.partition();
+
+    return zone;
+}
+
+std::string directoryOf(const std::string& path)
+{
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+std::string stemOf(const std::string& path)
+{
+    const size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+} // namespace
+
+//==============================================================================
+// SF2Reader SFZ Loading
+//==============================================================================
+
+bool SF2Reader::loadSFZ(const char* filePath)
+{
+    SfzParser parser(directoryOf(filePath));
+    if (!parser.parseFile(filePath, 0))
+        return false;
+    parser.finish();
+
+    const std::vector<SfzRegion>& regions = parser.regions;
+
+    // Regions sharing a WAV are compiled together, so each file is mapped once
+    std::vector<size_t> order(regions.size());
+    std::iota(order.begin(), order.end(), size_t { 0 });
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return regions[a].sample < regions[b].sample; });
+
+    // Zones keep the file's region order: the first matching zone plays
+    std::vector<Zone> zones(regions.size());
+    std::vector<bool> compiled(regions.size(), false);
+
+    // One sample per distinct (start, end, loop) of a WAV, shared by its regions
+    struct SampleRange
+    {
+        size_t begin;
+        size_t end;
+        int loopStart;
+        int loopEnd;
+        int index;
+    };
+    std::vector<SampleRange> ranges;
+
+    for (size_t first = 0; first < order.size();)
+    {
+        const std::string& path = regions[order[first]].sample;
+        size_t last = first;
+        while (last < order.size() && regions[order[last]].sample == path)
+            ++last;
+
+        MappedFile file;
+        WavInfo wav;
+        if (path.empty() || !file.open(path.c_str()) || !parseWav(file.data(), file.size(), wav))
+        {
+            first = last;
+            continue;
+        }
+
+        ranges.clear();
+        for (size_t i = first; i < last; ++i)
+        {
+            const SfzRegion& region = regions[order[i]];
+
+            // Release-triggered regions need voices started at note-off
+            if (region.releaseTrigger)
+                continue;
+
+            const size_t begin = std::min(static_cast<size_t>(region.offset), wav.numFrames);
+            const size_t end = region.end < 0 ? wav.numFrames
+                                              : std::min(static_cast<size_t>(region.end) + 1, wav.numFrames);
+            if (end <= begin || end - begin > static_cast<size_t>(INT_MAX))
+                continue;
+
+            // Loop points default to the WAV's smpl loop; they are frames from the sample start
+            const long long length = static_cast<long long>(end - begin);
+            long long loopStart = region.loopStart >= 0 ? region.loopStart
+                                : (wav.hasLoop ? static_cast<long long>(wav.loopStart) : 0);
+            long long loopEnd = region.loopEnd >= 0 ? region.loopEnd + 1
+                              : (wav.hasLoop ? static_cast<long long>(wav.loopEnd) : 0);
+            loopStart = std::max(0LL, std::min(length, loopStart - static_cast<long long>(begin)));
+            loopEnd = std::max(0LL, std::min(length, loopEnd - static_cast<long long>(begin)));
+            if (loopEnd <= loopStart)
+                loopStart = loopEnd = 0;
+
+            int sampleMode = region.loopMode >= 0 ? region.loopMode
+                           : (wav.hasLoop || region.loopEnd >= 0 ? 1 : 0);
+            if (loopEnd <= loopStart)
+                sampleMode = 0;
+
+            auto range = std::find_if(ranges.begin(), ranges.end(), [&](const SampleRange& r) {
+                return r.begin == begin && r.end == end && r.loopStart == loopStart && r.loopEnd == loopEnd;
+            });
+            if (range == ranges.end())
+            {
+                auto sample = std::make_unique<Sample>();
+                sample->numSamples = static_cast<int>(end - begin);
+                sample->numChannels = std::min(wav.numChannels, 2);
+                sample->sampleRate = wav.sampleRate;
+                sample->rootNote = wav.unityNote >= 0 ? wav.unityNote : 60;
+                sample->loopStart = static_cast<int>(loopStart);
+                sample->loopEnd = static_cast<int>(loopEnd);
+                sample->ownLoop = true;
+                sample->channels.assign(static_cast<size_t>(sample->numChannels),
+                                        AudioChannelBuffer(static_cast<size_t>(sample->numSamples)));
+                for (int ch = 0; ch < sample->numChannels; ++ch)
+                    decodeChannel(wav, ch, begin, end - begin, sample->channels[static_cast<size_t>(ch)].data());
+                sample->addGuardFrames();
+
+                SampleHeader header;
+                header.name = stemOf(path);
+                header.end = static_cast<uint32_t>(end - begin);
+                header.loopStart = static_cast<uint32_t>(loopStart);
+                header.loopEnd = static_cast<uint32_t>(loopEnd);
+                header.sampleRate = static_cast<uint32_t>(wav.sampleRate);
+                header.originalPitch = static_cast<int>(sample->rootNote);
+
+                ranges.push_back({ begin, end, static_cast<int>(loopStart), static_cast<int>(loopEnd),
+                                   static_cast<int>(samples_.size()) });
+                samples_.push_back(std::move(sample));
+                sampleHeaders_.push_back(header);
+                range = ranges.end() - 1;
+            }
+
+            zones[order[i]] = compileRegion(region, *samples_[static_cast<size_t>(range->index)], range->index,
+                                            sampleMode, wav.unityNote);
+            compiled[order[i]] = true;
+        }
+
+        first = last;
+    }
+
+    Instrument instrument;
+    instrument.name = stemOf(filePath);
+    for (size_t i = 0; i < zones.size(); ++i)
+        if (compiled[i] && zones[i].keyRangeLow <= zones[i].keyRangeHigh
+            && zones[i].velocityRangeLow <= zones[i].velocityRangeHigh)
+            instrument.zones.push_back(std::move(zones[i]));
+
+    if (instrument.zones.empty())
+        return false;
+
+    indexZones(instrument);
+    instruments_.push_back(std::move(instrument));
+    romName_ = stemOf(filePath);
+    romVersion_ = "SFZ";
+    return true;
+}
+
+} // namespace DSP
@@ -3,7 +3,7 @@
 
     SamSamplerStereo.cpp
     Stereo processing implementation for Sam Sampler
-    Demonstrates sample position offset and stereo filtering
+    Block-based sample position offset, stereo filter spread and bus width
 
   ==============================================================================
 */
@@ -11,212 +11,90 @@
 #include "dsp/SamSamplerDSP.h"
 #include "../../../../include/dsp/StereoProcessor.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace DSP {
 
 //==============================================================================
 // SamSamplerVoice Stereo Processing
 //==============================================================================
 
-void SamSamplerVoice::processStereo(float** outputs, int numChannels,
-                                    int numSamples, double sampleRate,
-                                    double positionOffset, double filterSpread)
+void SamSamplerVoice::setStereoEnhancement(double offsetSeconds, double filterSpread)
 {
-    // Calculate playback position for each channel
-    double leftPosition = playPosition_;
-    double rightPosition = playPosition_;
-
-    if (positionOffset > 0.0)
-    {
-        // Offset positions between channels for stereo effect
-        leftPosition = playPosition_ - positionOffset * 0.5;
-        rightPosition = playPosition_ + positionOffset * 0.5;
+    const int maxDelay = static_cast<int>(stereoDelayLine_.size()) - 1;
+    stereoDelay_ = std::max(0, std::min(maxDelay, static_cast<int>(std::lround(offsetSeconds * sampleRate_))));
+    filterSpread_ = std::max(0.0, std::min(1.0, filterSpread));
 
-        // Clamp to sample bounds
-        leftPosition = std::max(0.0, leftPosition);
-        rightPosition = std::max(0.0, rightPosition);
-    }
+    // A new note starts with an empty delay line: the lagging channel enters late
+    if (stereoDelay_ > 0)
+        std::fill(stereoDelayLine_.begin(), stereoDelayLine_.end(), 0.0f);
+    stereoDelayWrite_ = 0;
 
-    // Process envelope once (shared)
-    double envLevel = envelope_.process(sampleRate, numSamples);
+    applyFilterParameters();
+}
 
-    // Process each sample
+void SamSamplerVoice::renderStereoChannels(int numSamples)
+{
+    float* left = voiceBuffers_[0].data();
+    float* right = voiceBuffers_[1].data();
+
+    // A mono sample feeds both channels
+    if (blockChannels_ == 1)
+        std::copy(left, left + numSamples, right);
+    blockChannels_ = 2;
+
+    if (stereoDelay_ == 0)
+        return;
+
+    // Left lags right by stereoDelay_ samples (equivalent to reading the sample
+    // at two positions, without a second interpolator or boundary tracking)
+    float* line = stereoDelayLine_.data();
+    const int mask = static_cast<int>(stereoDelayLine_.size()) - 1;
+    int write = stereoDelayWrite_;
     for (int i = 0; i < numSamples; ++i)
     {
-        float leftSample = 0.0f;
-        float rightSample = 0.0f;
-
-        // Get sample for left channel
-        if (sample_ && leftPosition < sample_->numSamples)
-        {
-            leftSample = interpolateLinear(leftPosition);
-            leftPosition += playbackRate_;
-        }
-
-        // Get sample for right channel
-        if (sample_ && rightPosition < sample_->numSamples)
-        {
-            rightSample = interpolateLinear(rightPosition);
-            rightPosition += playbackRate_;
-        }
-
-        // Apply envelope
-        leftSample *= static_cast<float>(envLevel);
-        rightSample *= static_cast<float>(envLevel);
-
-        // Apply per-channel filter if enabled
-        if (filterEnabled_)
-        {
-            // Left channel filter
-            {
-                double leftCutoff = filter_.cutoff;
-                if (filterSpread > 0.0)
-                {
-                    // Lower cutoff for left channel
-                    leftCutoff *= (1.0 - filterSpread * 0.5);
-                }
-                filter_.setParameters(leftCutoff, filter_.resonance);
-            }
-
-            // Right channel filter
-            {
-                double rightCutoff = filter_.cutoff;
-                if (filterSpread > 0.0)
-                {
-                    // Higher cutoff for right channel
-                    rightCutoff *= (1.0 + filterSpread * 0.5);
-                }
-                filter_.setParameters(rightCutoff, filter_.resonance);
-            }
-
-            // Process through stereo filter
-            float tempSamples[2] = {leftSample, rightSample};
-            float* tempPtr[2] = {&tempSamples[0], &tempSamples[1]};
-            filter_.process(tempPtr, 2, 1);
-
-            leftSample = tempSamples[0];
-            rightSample = tempSamples[1];
-        }
-
-        // Output to channels
-        if (numChannels >= 2)
-        {
-            outputs[0][i] += leftSample;
-            outputs[1][i] += rightSample;
-        }
-        else if (numChannels == 1)
-        {
-            outputs[0][i] += (leftSample + rightSample) * 0.5f;
-        }
+        line[write] = left[i];
+        left[i] = line[(write - stereoDelay_) & mask];
+        write = (write + 1) & mask;
     }
-
-    // Update play position
-    playPosition_ += playbackRate_ * numSamples;
+    stereoDelayWrite_ = write;
 }
 
 //==============================================================================
 // SamSamplerDSP Stereo Processing
 //==============================================================================
 
-void SamSamplerDSP::processStereoSample(float& left, float& right, double phase)
+void SamSamplerDSP::applyStereoWidth(float** outputs, int numChannels, int numSamples)
 {
     using namespace StereoProcessor;
 
-    // Get stereo parameters
-    double width = params_.stereoWidth;
-    double positionOffset = params_.stereoPositionOffset;
-    double filterSpread = params_.stereoFilterSpread;
-
-    // Process all voices with stereo enhancement
-    float leftSum = 0.0f;
-    float rightSum = 0.0f;
-
-    for (auto& voice : voices_)
-    {
-        if (voice && voice->isActive())
-        {
-            // Create temporary output buffers for this voice
-            float voiceBuffer[2];
-
-            // Process with stereo offset
-            float tempLeft = 0.0f;
-            float tempRight = 0.0f;
-            float* tempPtr[2] = {&tempLeft, &tempRight};
-
-            // Process voice with stereo parameters
-            voice->processStereo(tempPtr, 2, 1, sampleRate_, positionOffset, filterSpread);
-
-            leftSum += tempLeft;
-            rightSum += tempRight;
-        }
-    }
-
-    // Apply stereo width
-    left = leftSum;
-    right = rightSum;
-
-    StereoWidth::processWidth(left, right, static_cast<float>(width));
+    // Full width leaves the bus untouched
+    const float width = static_cast<float>(params_.stereoWidth);
+    if (numChannels < 2 || width >= 1.0f)
+        return;
 
-    // Apply master volume
-    left *= static_cast<float>(params_.masterVolume);
-    right *= static_cast<float>(params_.masterVolume);
+    float* left = outputs[0];
+    float* right = outputs[1];
+    for (int i = 0; i < numSamples; ++i)
+        StereoWidth::processWidth(left[i], right[i], width);
 }
 
-//==============================================================================
-// Implementation Example: Multi-Sample Stereo Layering
-//==============================================================================
-
-/*
- * Advanced stereo technique using multiple sample layers:
- */
-
-void SamSamplerDSP::processMultiLayerStereo(float& left, float& right)
+double SamSamplerDSP::voicePan(int midiNote, float velocity, int part) const
 {
-    using namespace StereoProcessor;
-
-    float width = static_cast<float>(params_.stereoWidth);
-
-    // Layer 1: Main sample (center)
-    float mainLeft = 0.0f;
-    float mainRight = 0.0f;
+    double pan = params_.pan + params_.panKeySpread * (midiNote - 60) / 64.0;
+    if (params_.multiTimbral)
+        pan += parts_[static_cast<size_t>(part)].pan;
 
-    // Layer 2: Stereo layer (offset)
-    float stereoLeft = 0.0f;
-    float stereoRight = 0.0f;
-
-    // Process voices
-    for (auto& voice : voices_)
+    // Zone velocity ranges are MIDI values; SF2 pan is in 0.1% (500 = hard right)
+    if (sf2Reader_)
     {
-        if (voice && voice->isActive())
-        {
-            // Main layer (center)
-            float tempLeft = 0.0f;
-            float tempRight = 0.0f;
-            float* tempPtr[2] = {&tempLeft, &tempRight};
-            voice->process(tempPtr, 2, 1, sampleRate_);
-
-            mainLeft += tempLeft;
-            mainRight += tempRight;
-
-            // Stereo layer (offset position)
-            voice->processStereo(tempPtr, 2, 1, sampleRate_,
-                               params_.stereoPositionOffset,
-                               params_.stereoFilterSpread);
-
-            stereoLeft += tempLeft;
-            stereoRight += tempRight;
-        }
+        const SF2Reader::Zone* zone = sf2Reader_->findZone(partInstrument(part), midiNote, velocity * 127.0f);
+        if (zone)
+            pan += zone->pan / 500.0;
     }
 
-    // Mix layers
-    left = mainLeft * 0.7f + stereoLeft * 0.3f;
-    right = mainRight * 0.7f + stereoRight * 0.3f;
-
-    // Apply width
-    StereoWidth::processWidth(left, right, width);
-
-    // Apply master volume
-    left *= static_cast<float>(params_.masterVolume);
-    right *= static_cast<float>(params_.masterVolume);
+    return std::max(-1.0, std::min(1.0, pan));
 }
 
 } // namespace DSP
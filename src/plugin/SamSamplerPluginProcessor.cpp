@@ -17,16 +17,35 @@
 // SamSamplerPluginProcessor Implementation
 //==============================================================================
 
+#ifndef JucePlugin_PreferredChannelConfigurations
+namespace {
+
+// Main output plus SamSamplerDSP::maxAuxOutputs stereo aux outputs, disabled
+// until the host enables them (kit pieces routed with setOutputGroup)
+juce::AudioProcessor::BusesProperties createBusesProperties() {
+    auto buses = juce::AudioProcessor::BusesProperties()
+                 #if ! JucePlugin_IsMidiEffect
+                  #if ! JucePlugin_IsSynth
+                   .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                  #endif
+                   .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                 #endif
+                   ;
+
+   #if ! JucePlugin_IsMidiEffect
+    for (int aux = 1; aux <= SamSamplerDSP::maxAuxOutputs; ++aux)
+        buses = buses.withOutput("Aux " + juce::String(aux), juce::AudioChannelSet::stereo(), false);
+   #endif
+
+    return buses;
+}
+
+} // namespace
+#endif
+
 SamSamplerPluginProcessor::SamSamplerPluginProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
-     : juce::AudioProcessor(BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
+     : juce::AudioProcessor(createBusesProperties())
 #endif
 {
     // Initialize parameter tree
@@ -87,6 +106,16 @@ bool SamSamplerPluginProcessor::isBusesLayoutSupported(const BusesLayout& layout
         return false;
     #endif
 
+    // Aux outputs are stereo and enabled in order, so the enabled ones are
+    // exactly the trailing channel pairs SamSamplerDSP::process expects
+    bool previousEnabled = true;
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus) {
+        const auto& set = layouts.outputBuses.getReference(bus);
+        if (!set.isDisabled() && (set != juce::AudioChannelSet::stereo() || !previousEnabled))
+            return false;
+        previousEnabled = !set.isDisabled();
+    }
+
     return true;
     #endif
 }
@@ -107,7 +136,6 @@ void SamSamplerPluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     // Process MIDI events
     for (const auto metadata : midiMessages) {
         const auto message = metadata.getMessage();
-        int samplePosition = metadata.samplePosition;
 
         if (message.isNoteOn()) {
             int midiNote = message.getNoteNumber();
@@ -119,44 +147,46 @@ void SamSamplerPluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                 applyMPEToNote(midiNote, channel);
             }
 
-            samSampler.noteOn(midiNote, velocity);
+            samSampler.noteOn(midiNote, velocity, channel);
         } else if (message.isNoteOff()) {
-            samSampler.noteOff(message.getNoteNumber());
+            samSampler.noteOff(message.getNoteNumber(), message.getVelocity() / 127.0f, message.getChannel());
+        } else if (message.isProgramChange()) {
+            // Multi-timbral parts pick their instrument per channel
+            samSampler.setPartInstrument(message.getChannel(), message.getProgramChangeNumber());
         } else if (message.isPitchWheel()) {
-            // Samples are baked, so pitch bend has limited effect
-            // But we still pass it through for sample pitch shifting if supported
+            // Bends SF2 voices of the channel's part through their modulators
             float pitchBendValue = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            DSP::ScheduledEvent event;
-            event.type = DSP::ScheduledEvent::PITCH_BEND;
-            event.time = 0.0;
-            event.sampleOffset = samplePosition;
-            event.data.pitchBend.bendValue = pitchBendValue;
-            samSampler.handleEvent(event);
+            samSampler.pitchBend(pitchBendValue, message.getChannel());
         } else if (message.isController()) {
-            // Handle CC messages
-            DSP::ScheduledEvent event;
-            event.type = DSP::ScheduledEvent::CONTROL_CHANGE;
-            event.time = 0.0;
-            event.sampleOffset = samplePosition;
-            event.data.controlChange.controllerNumber = message.getControllerNumber();
-            event.data.controlChange.value = message.getControllerValue() / 127.0f;
-            samSampler.handleEvent(event);
+            // Handle CC messages (volume and pan address the channel's part)
+            samSampler.controlChange(message.getControllerNumber(),
+                                     message.getControllerValue() / 127.0f,
+                                     message.getChannel());
         } else if (message.isChannelPressure()) {
-            DSP::ScheduledEvent event;
-            event.type = DSP::ScheduledEvent::CHANNEL_PRESSURE;
-            event.time = 0.0;
-            event.sampleOffset = samplePosition;
-            event.data.channelPressure.pressure = message.getChannelPressureValue() / 127.0f;
-            samSampler.handleEvent(event);
+            samSampler.channelPressure(message.getChannelPressureValue() / 127.0f, message.getChannel());
         }
     }
 
-    // Clear output buffer
-    buffer.clear();
+    // Aux buses are enabled in order (see isBusesLayoutSupported)
+    int auxOutputs = 0;
+    for (int bus = 1; bus < getBusCount(false); ++bus) {
+        if (getBus(false, bus)->isEnabled())
+            ++auxOutputs;
+    }
+    samSampler.setParameter("auxOutputs", static_cast<float>(auxOutputs));
+
+    // The sampler clears and writes the host channels in place: main bus first,
+    // then each aux pair, so no routing copies are made
+    const int numOutputChannels = juce::jmin(getTotalNumOutputChannels(), buffer.getNumChannels(),
+                                             static_cast<int>(maxOutputChannels));
+    for (int ch = numOutputChannels; ch < buffer.getNumChannels(); ++ch)
+        buffer.clear(ch, 0, buffer.getNumSamples());
 
-    // Process audio through sampler
-    float* outputs[2] = { buffer.getWritePointer(0), buffer.getWritePointer(1) };
-    samSampler.process(outputs, buffer.getNumChannels(), buffer.getNumSamples());
+    std::array<float*, maxOutputChannels> outputs {};
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+        outputs[static_cast<size_t>(ch)] = buffer.getWritePointer(ch);
+
+    samSampler.process(outputs.data(), numOutputChannels, buffer.getNumSamples());
 }
 
 juce::AudioProcessorEditor* SamSamplerPluginProcessor::createEditor() {
@@ -388,6 +418,7 @@ void SamSamplerPluginProcessor::setupParameters() {
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f));
     layout.add(std::make_unique<juce::AudioParameterFloat>("pitchBendRange", "Pitch Bend Range",
         juce::NormalisableRange<float>(0.0f, 24.0f, 0.5f), 2.0f));
+    layout.add(std::make_unique<juce::AudioParameterBool>("multiTimbral", "Multi-Timbral", false));
 
     // Sample playback parameters
     layout.add(std::make_unique<juce::AudioParameterFloat>("basePitch", "Base Pitch",
@@ -435,6 +466,7 @@ void SamSamplerPluginProcessor::setupParameters() {
     // Get parameter pointers for fast access
     masterVolumeParam = parameters->getRawParameterValue("masterVolume");
     pitchBendRangeParam = parameters->getRawParameterValue("pitchBendRange");
+    multiTimbralParam = parameters->getRawParameterValue("multiTimbral");
 
     basePitchParam = parameters->getRawParameterValue("basePitch");
     sampleStartParam = parameters->getRawParameterValue("sampleStart");
@@ -475,6 +507,10 @@ void SamSamplerPluginProcessor::updateSamSamplerParameters() {
         samSampler.setParameter("pitchBendRange", pitchBendRangeParam->load());
     }
 
+    if (multiTimbralParam) {
+        samSampler.setParameter("multiTimbral", multiTimbralParam->load());
+    }
+
     // Update sample playback parameters
     if (basePitchParam) {
         samSampler.setParameter("basePitch", basePitchParam->load());
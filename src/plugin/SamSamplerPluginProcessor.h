@@ -77,6 +77,9 @@ private:
     // Core sampler instrument
     SamSamplerDSP samSampler;
 
+    // Stereo main bus plus every aux pair
+    static constexpr size_t maxOutputChannels = 2 + 2 * SamSamplerDSP::maxAuxOutputs;
+
     // MPE Support (Lite - pressure to filter/amp only)
     std::unique_ptr<MPEUniversalSupport> mpeSupport;
     bool mpeEnabled = true;
@@ -91,6 +94,7 @@ private:
     // Global parameters
     std::atomic<float>* masterVolumeParam = nullptr;
     std::atomic<float>* pitchBendRangeParam = nullptr;
+    std::atomic<float>* multiTimbralParam = nullptr;
 
     // Sample playback parameters
     std::atomic<float>* basePitchParam = nullptr;
@@ -130,14 +130,15 @@ void testInterpolationQuality()
     sample->numSamples = 100;
     sample->numChannels = 1;
     sample->sampleRate = 48000;
-    sample->audioData.resize(100);
+    sample->channels.assign(1, AudioChannelBuffer(100));
 
     // Fill with sine wave
     for (int i = 0; i < 100; ++i)
     {
         double t = static_cast<double>(i) / 48000.0;
-        sample->audioData[i] = std::sin(2.0 * M_PI * 440.0 * t);
+        sample->channels[0][i] = std::sin(2.0 * M_PI * 440.0 * t);
     }
+    sample->addGuardFrames();
 
     SamSamplerVoice voice;
     voice.startNote(60, 0.8f, sample);
@@ -15,6 +15,13 @@
 #include <cstdio>
 #include <cmath>
 #include <vector>
+#include <cstdint>
+#include <chrono>
+#include <utility>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
 
 using namespace DSP;
 
@@ -70,6 +77,21 @@ void processAudioInChunks(SamSamplerDSP& sampler, float* left, float* right, int
     }
 }
 
+// Mono sine sample at root note 60, guard frames added
+std::shared_ptr<Sample> makeSineSample(double frequency, int sampleRate, int numFrames) {
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = sampleRate;
+    sample->rootNote = 60;
+    sample->numSamples = numFrames;
+    sample->numChannels = 1;
+    sample->channels.assign(1, AudioChannelBuffer(static_cast<size_t>(numFrames)));
+    for (int i = 0; i < numFrames; ++i) {
+        sample->channels[0][i] = static_cast<float>(std::sin(2.0 * M_PI * frequency * i / sampleRate));
+    }
+    sample->addGuardFrames();
+    return sample;
+}
+
 //==============================================================================
 // Test 1: Instrument Initialization
 //==============================================================================
@@ -294,6 +316,2265 @@ bool testPitchBend(TestStats& stats) {
     return true;
 }
 
+//==============================================================================
+// Test 8: Span Rendering Block Invariance
+//==============================================================================
+
+bool testSpanRendering(TestStats& stats) {
+    std::cout << "\n[Test 8] Span Rendering" << std::endl;
+
+    // The voice splits each block at envelope/playhead events, so the rendered
+    // audio must not depend on how the host chops the timeline into blocks
+    const int numSamples = 48000;
+    std::vector<float> reference[2];
+    int blockSizes[] = {512, 37};
+
+    for (int run = 0; run < 2; ++run) {
+        SamSamplerDSP sampler;
+        sampler.prepare(48000.0, 512);
+        sampler.setParameter("envAttack", 0.003f);
+        sampler.setParameter("envHold", 0.01f);
+        sampler.setParameter("envDecay", 0.05f);
+
+        ScheduledEvent event;
+        event.type = ScheduledEvent::NOTE_ON;
+        event.time = 0.0;
+        event.sampleOffset = 0;
+        event.data.note.midiNote = 72;
+        event.data.note.velocity = 0.8f;
+        sampler.handleEvent(event);
+
+        reference[run].assign(numSamples, 0.0f);
+        std::vector<float> right(numSamples, 0.0f);
+        processAudioInChunks(sampler, reference[run].data(), right.data(), numSamples, blockSizes[run]);
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        if (reference[0][i] != reference[1][i]) {
+            stats.fail("span_rendering", "Output differs between block sizes at sample " + std::to_string(i));
+            return false;
+        }
+    }
+
+    std::cout << "    Peak: " << getPeakLevel(reference[0].data(), numSamples) << std::endl;
+
+    stats.pass("span_rendering");
+    return true;
+}
+
+//==============================================================================
+// Test 9: Guard-Padded Samples
+//==============================================================================
+
+bool testGuardFrames(TestStats& stats) {
+    std::cout << "\n[Test 9] Guard Frames" << std::endl;
+
+    Sample sample;
+    sample.numChannels = 1;
+    sample.numSamples = 64;
+    sample.loopStart = 16;
+    sample.loopEnd = 64;
+    sample.channels.assign(1, AudioChannelBuffer(64));
+    for (int i = 0; i < 64; ++i) {
+        sample.channels[0][i] = static_cast<float>(i + 1);
+    }
+
+    if (sample.isValid()) {
+        stats.fail("guard_frames", "Unpadded sample reported as playable");
+        return false;
+    }
+
+    sample.addGuardFrames();
+
+    const float* frames = sample.frames(0);
+    bool ok = sample.isValid()
+           && frames[0] == 1.0f && frames[63] == 64.0f
+           && frames[-1] == 0.0f && frames[-Sample::guardFrames] == 0.0f;
+
+    // Post-guard continues into the loop start
+    for (int i = 0; i < Sample::guardFrames; ++i) {
+        ok = ok && frames[64 + i] == frames[16 + i];
+    }
+
+    if (!ok) {
+        stats.fail("guard_frames", "Guard frames not laid out as expected");
+        return false;
+    }
+
+    stats.pass("guard_frames");
+    return true;
+}
+
+//==============================================================================
+// Test 10: Baked Loop Crossfade
+//==============================================================================
+
+bool testLoopCrossfade(TestStats& stats) {
+    std::cout << "\n[Test 10] Loop Crossfade" << std::endl;
+
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 512);
+    sampler.setParameter("envSustain", 1.0f);
+    sampler.setParameter("loopEnabled", 1.0f);
+    sampler.setParameter("loopStart", 0.3f);
+    sampler.setParameter("loopEnd", 0.7337f);   // Not a whole number of cycles
+    sampler.setParameter("crossfade", 0.01f);
+    sampler.rebuildLoopRegions();               // Bake now instead of on the build thread
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = 60;
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    // Three seconds of a one second test sample
+    const int numSamples = 48000 * 3;
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples);
+
+    float maxStep = 0.0f;
+    for (int i = 48000; i < numSamples; ++i) {
+        maxStep = std::max(maxStep, std::abs(left[i] - left[i - 1]));
+    }
+    float tailPeak = getPeakLevel(left.data() + numSamples - 4800, 4800);
+
+    std::cout << "    Tail peak: " << tailPeak << ", max step: " << maxStep << std::endl;
+
+    if (sampler.getActiveVoiceCount() != 1 || tailPeak < 0.5f) {
+        stats.fail("loop_crossfade", "Looping voice did not sustain past the sample end");
+        return false;
+    }
+
+    // A 440 Hz sine at this level moves at most ~0.05 per sample; a raw seam jumps far more
+    if (maxStep > 0.1f) {
+        stats.fail("loop_crossfade", "Discontinuity at the loop seam");
+        return false;
+    }
+
+    stats.pass("loop_crossfade");
+    return true;
+}
+
+//==============================================================================
+// Test 11: Planar Stereo Playback
+//==============================================================================
+
+bool testStereoPlayback(TestStats& stats) {
+    std::cout << "\n[Test 11] Stereo Playback" << std::endl;
+
+    // Interleaved stereo source with opposite polarity per channel
+    const int numFrames = 4800;
+    std::vector<float> interleaved(numFrames * 2);
+    for (int i = 0; i < numFrames; ++i) {
+        float value = std::sin(2.0f * static_cast<float>(M_PI) * 440.0f * i / 48000.0f);
+        interleaved[i * 2] = value;
+        interleaved[i * 2 + 1] = -value;
+    }
+
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = 48000;
+    sample->rootNote = 60;
+    sample->setInterleaved(interleaved.data(), numFrames, 2);
+    sample->addGuardFrames();
+
+    bool aligned = true;
+    for (const auto& channel : sample->channels) {
+        aligned = aligned && (reinterpret_cast<std::uintptr_t>(channel.data()) % 64 == 0);
+    }
+    if (!aligned) {
+        stats.fail("stereo_playback", "Channel buffers are not 64-byte aligned");
+        return false;
+    }
+
+    SamSamplerVoice voice;
+    voice.prepare(48000.0, 512);
+    voice.startNote(60, 1.0f, sample);
+
+    std::vector<float> left(512, 0.0f);
+    std::vector<float> right(512, 0.0f);
+    float* outputs[] = { left.data(), right.data() };
+    voice.process(outputs, 2, 512, 48000.0);
+
+    float peak = getPeakLevel(left.data(), 512);
+    float imbalance = 0.0f;
+    for (int i = 0; i < 512; ++i) {
+        imbalance = std::max(imbalance, std::abs(left[i] + right[i]));
+    }
+
+    std::cout << "    Peak: " << peak << ", L+R residual: " << imbalance << std::endl;
+
+    if (peak < 0.1f || imbalance > 1e-6f) {
+        stats.fail("stereo_playback", "Right channel does not carry the sample's right channel");
+        return false;
+    }
+
+    stats.pass("stereo_playback");
+    return true;
+}
+
+//==============================================================================
+// Test 12: Fixed-Point Phase Accumulator
+//==============================================================================
+
+namespace {
+
+std::vector<float> renderLoopedNote(bool fixedPoint, int blockSize, int numSamples,
+                                    int quality = SamSamplerVoice::Cubic) {
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 512);
+    sampler.setParameter("interpolationQuality", static_cast<float>(quality));
+    sampler.setParameter("envSustain", 1.0f);
+    sampler.setParameter("loopEnabled", 1.0f);
+    sampler.setParameter("loopStart", 0.3f);
+    sampler.setParameter("loopEnd", 0.7337f);
+    sampler.setParameter("fixedPointPhase", fixedPoint ? 1.0f : 0.0f);
+    sampler.rebuildLoopRegions();
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = 67;            // Non-integer playback rate
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, blockSize);
+    return left;
+}
+
+} // namespace
+
+bool testFixedPointPhase(TestStats& stats) {
+    std::cout << "\n[Test 12] Fixed-Point Phase" << std::endl;
+
+    const int numSamples = 48000 * 2;       // Several passes through the loop
+    auto fixedLarge = renderLoopedNote(true, 512, numSamples);
+    auto fixedSmall = renderLoopedNote(true, 37, numSamples);
+    auto floating = renderLoopedNote(false, 512, numSamples);
+
+    if (fixedLarge != fixedSmall) {
+        stats.fail("fixed_point_phase", "Fixed-point render depends on block size");
+        return false;
+    }
+
+    float maxDiff = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        maxDiff = std::max(maxDiff, std::abs(fixedLarge[i] - floating[i]));
+    }
+
+    std::cout << "    Max deviation from double playhead: " << maxDiff << std::endl;
+
+    if (getPeakLevel(fixedLarge.data() + numSamples - 4800, 4800) < 0.1f || maxDiff > 1e-3f) {
+        stats.fail("fixed_point_phase", "Fixed-point playhead drifted from the double playhead");
+        return false;
+    }
+
+    // The sinc kernel takes its table row and blend weight from the fraction bits
+    auto fixedSinc = renderLoopedNote(true, 512, numSamples, SamSamplerVoice::Sinc16);
+    auto floatingSinc = renderLoopedNote(false, 512, numSamples, SamSamplerVoice::Sinc16);
+    float maxSincDiff = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        maxSincDiff = std::max(maxSincDiff, std::abs(fixedSinc[i] - floatingSinc[i]));
+    }
+
+    std::cout << "    Sinc16 deviation from double playhead: " << maxSincDiff << std::endl;
+
+    if (getPeakLevel(fixedSinc.data() + numSamples - 4800, 4800) < 0.1f || maxSincDiff > 1e-3f) {
+        stats.fail("fixed_point_phase", "Fixed-point sinc reads drifted from the double playhead");
+        return false;
+    }
+
+    stats.pass("fixed_point_phase");
+    return true;
+}
+
+//==============================================================================
+// Test 13: Windowed-Sinc Interpolation
+//==============================================================================
+
+namespace {
+
+// Worst error against the ideal resampled sine once the attack has settled
+float interpolationError(int quality) {
+    const double sampleRate = 48000.0;
+    const double omega = 2.0 * M_PI * 3000.0 / sampleRate;
+    auto sample = makeSineSample(3000.0, 48000, 48000);
+
+    SamSamplerVoice voice;
+    voice.prepare(sampleRate, 512);
+    voice.setEnvelopeParameters(0.0, 0.0, 0.0, 1.0, 0.1,
+                                EnvelopeCurve::Linear, EnvelopeCurve::Linear, EnvelopeCurve::Linear);
+    voice.setInterpolationQuality(quality);
+    voice.startNote(53, 1.0f, sample);    // Rate ~0.667: every fraction gets exercised at the full cutoff
+
+    const int numSamples = 4096;
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    float* outputs[] = { left.data(), right.data() };
+    voice.process(outputs, 2, numSamples, sampleRate);
+
+    const double rate = std::pow(2.0, -7.0 / 12.0);
+    float maxError = 0.0f;
+    for (int i = 64; i < numSamples; ++i) {
+        float ideal = static_cast<float>(std::sin(omega * rate * i));
+        maxError = std::max(maxError, std::abs(left[i] - ideal));
+    }
+    return maxError;
+}
+
+// Peak of a 22 kHz sine played a whole tone up with mip mapping off: it lands
+// past the 24 kHz output Nyquist, so everything that comes out is aliasing
+float aliasPeak(int quality) {
+    auto sample = makeSineSample(22000.0, 48000, 48000);
+
+    SamSamplerVoice voice;
+    voice.prepare(48000.0, 512);
+    voice.setEnvelopeParameters(0.0, 0.0, 0.0, 1.0, 0.1,
+                                EnvelopeCurve::Linear, EnvelopeCurve::Linear, EnvelopeCurve::Linear);
+    voice.setMipMapping(false);
+    voice.setInterpolationQuality(quality);
+    voice.startNote(62, 1.0f, sample);
+
+    std::vector<float> left(4096, 0.0f);
+    std::vector<float> right(4096, 0.0f);
+    float* outputs[] = { left.data(), right.data() };
+    voice.process(outputs, 2, 4096, 48000.0);
+    return getPeakLevel(left.data() + 512, 2048);
+}
+
+} // namespace
+
+bool testSincInterpolation(TestStats& stats) {
+    std::cout << "\n[Test 13] Windowed-Sinc Interpolation" << std::endl;
+
+    float errors[5];
+    for (int quality = SamSamplerVoice::Linear; quality <= SamSamplerVoice::Sinc32; ++quality) {
+        errors[quality] = interpolationError(quality);
+        std::cout << "    Quality " << quality << " max error: " << errors[quality] << std::endl;
+    }
+
+    if (!(errors[SamSamplerVoice::Sinc32] < errors[SamSamplerVoice::Sinc16]
+          && errors[SamSamplerVoice::Sinc16] < errors[SamSamplerVoice::Sinc8]
+          && errors[SamSamplerVoice::Sinc16] < errors[SamSamplerVoice::Cubic]
+          && errors[SamSamplerVoice::Sinc32] < 1e-4f)) {
+        stats.fail("sinc_interpolation", "Longer kernels did not track the ideal signal more closely");
+        return false;
+    }
+
+    // Above unity the sinc cutoff narrows with the rate
+    float aliasCubic = aliasPeak(SamSamplerVoice::Cubic);
+    float aliasSinc = aliasPeak(SamSamplerVoice::Sinc32);
+    std::cout << "    Alias peak cubic/sinc32 a tone up: " << aliasCubic << " / " << aliasSinc << std::endl;
+
+    if (aliasSinc > 0.05f) {
+        stats.fail("sinc_interpolation", "Sinc kernel let content above the output Nyquist alias");
+        return false;
+    }
+
+    stats.pass("sinc_interpolation");
+    return true;
+}
+
+//==============================================================================
+// Test 14: Mip-Mapped Sample Pyramid
+//==============================================================================
+
+namespace {
+
+// Peak of a sine sample played two octaves up, after the attack
+float transposedPeak(double frequency, bool mipMapping) {
+    auto sample = makeSineSample(frequency, 48000, 48000);
+    std::atomic_store(&sample->pyramid, SamplePyramid::create(*sample));
+
+    SamSamplerVoice voice;
+    voice.prepare(48000.0, 512);
+    voice.setEnvelopeParameters(0.0, 0.0, 0.0, 1.0, 0.1,
+                                EnvelopeCurve::Linear, EnvelopeCurve::Linear, EnvelopeCurve::Linear);
+    voice.setMipMapping(mipMapping);
+    voice.startNote(84, 1.0f, sample);
+
+    std::vector<float> left(4096, 0.0f);
+    std::vector<float> right(4096, 0.0f);
+    float* outputs[] = { left.data(), right.data() };
+    voice.process(outputs, 2, 4096, 48000.0);
+    return getPeakLevel(left.data() + 512, 2048);
+}
+
+} // namespace
+
+bool testMipMapping(TestStats& stats) {
+    std::cout << "\n[Test 14] Mip-Mapped Sample Pyramid" << std::endl;
+
+    // 15 kHz at four times the rate lands above Nyquist: it can only alias
+    float aliasedPlain = transposedPeak(15000.0, false);
+    float aliasedMip = transposedPeak(15000.0, true);
+    // 500 Hz becomes 2 kHz and must come through the decimation intact
+    float tonePlain = transposedPeak(500.0, false);
+    float toneMip = transposedPeak(500.0, true);
+
+    std::cout << "    Alias peak plain/mip: " << aliasedPlain << " / " << aliasedMip
+              << ", in-band peak plain/mip: " << tonePlain << " / " << toneMip << std::endl;
+
+    if (aliasedPlain < 0.3f || aliasedMip > 0.01f) {
+        stats.fail("mip_mapping", "Pyramid levels did not remove the aliasing content");
+        return false;
+    }
+
+    if (std::abs(toneMip - tonePlain) > 0.01f) {
+        stats.fail("mip_mapping", "Pyramid levels changed in-band content");
+        return false;
+    }
+
+    stats.pass("mip_mapping");
+    return true;
+}
+
+//==============================================================================
+// Test 15: Sample Rate Conversion
+//==============================================================================
+
+namespace {
+
+// Pitch of the built-in 440 Hz / 44.1 kHz test sample played at its root key
+double measureRootPitch(SamSamplerDSP& sampler, double sampleRate) {
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = 60;
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    const int numSamples = static_cast<int>(sampleRate * 0.5);
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples);
+
+    // Rising zero crossings over the last 0.4 s
+    const int start = numSamples - static_cast<int>(sampleRate * 0.4);
+    int crossings = 0;
+    for (int i = start + 1; i < numSamples; ++i) {
+        if (left[i - 1] < 0.0f && left[i] >= 0.0f) {
+            ++crossings;
+        }
+    }
+
+    event.type = ScheduledEvent::NOTE_OFF;
+    sampler.handleEvent(event);
+    std::vector<float> flush(static_cast<size_t>(sampleRate), 0.0f);
+    std::vector<float> flushRight(flush.size(), 0.0f);
+    processAudioInChunks(sampler, flush.data(), flushRight.data(), static_cast<int>(flush.size()));
+
+    return crossings / 0.4;
+}
+
+} // namespace
+
+bool testSampleRateConversion(TestStats& stats) {
+    std::cout << "\n[Test 15] Sample Rate Conversion" << std::endl;
+
+    SamSamplerDSP native;
+    native.prepare(48000.0, 512);
+    native.setParameter("envSustain", 1.0f);
+    double nativePitch = measureRootPitch(native, 48000.0);
+
+    SamSamplerDSP converted;
+    converted.setParameter("resampleOnLoad", 1.0f);
+    converted.prepare(48000.0, 512);
+    converted.setParameter("envSustain", 1.0f);
+    double convertedPitch = measureRootPitch(converted, 48000.0);
+
+    // Host rate change: prepare() converts again from the native data
+    converted.prepare(96000.0, 512);
+    double reconvertedPitch = measureRootPitch(converted, 96000.0);
+
+    std::cout << "    Root pitch native/48k/96k: " << nativePitch << " / " << convertedPitch
+              << " / " << reconvertedPitch << " Hz" << std::endl;
+
+    for (double pitch : { nativePitch, convertedPitch, reconvertedPitch }) {
+        if (std::abs(pitch - 440.0) > 5.0) {
+            stats.fail("sample_rate_conversion", "Root key is off pitch at the engine rate");
+            return false;
+        }
+    }
+
+    stats.pass("sample_rate_conversion");
+    return true;
+}
+
+//==============================================================================
+// Test 16: Parallel Voice Rendering
+//==============================================================================
+
+namespace {
+
+std::vector<float> renderChord(int renderThreads) {
+    SamSamplerDSP sampler;
+    sampler.setParameter("renderThreads", static_cast<float>(renderThreads));
+    sampler.setParameter("interpolationQuality", 4.0f);
+    sampler.prepare(48000.0, 256);
+
+    // Every voice busy, at different rates
+    for (int note = 0; note < sampler.getMaxPolyphony(); ++note) {
+        ScheduledEvent event;
+        event.type = ScheduledEvent::NOTE_ON;
+        event.time = 0.0;
+        event.sampleOffset = 0;
+        event.data.note.midiNote = 48 + note * 2;
+        event.data.note.velocity = 0.3f + 0.04f * note;
+        sampler.handleEvent(event);
+    }
+
+    const int numSamples = 48000;
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+} // namespace
+
+bool testParallelRendering(TestStats& stats) {
+    std::cout << "\n[Test 16] Parallel Voice Rendering" << std::endl;
+
+    auto serial = renderChord(0);
+    auto parallel = renderChord(3);
+
+    if (getPeakLevel(serial.data(), static_cast<int>(serial.size())) < 0.1f) {
+        stats.fail("parallel_rendering", "Chord rendered silence");
+        return false;
+    }
+
+    // Ordered summation: the worker pool must not change a single bit
+    if (serial != parallel) {
+        stats.fail("parallel_rendering", "Parallel mix differs from the serial mix");
+        return false;
+    }
+
+    stats.pass("parallel_rendering");
+    return true;
+}
+
+//==============================================================================
+// Test 17: CPU Governor
+//==============================================================================
+
+bool testCpuGovernor(TestStats& stats) {
+    std::cout << "\n[Test 17] CPU Governor" << std::endl;
+
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("interpolationQuality", 4.0f);
+    sampler.setParameter("envSustain", 1.0f);
+    sampler.setParameter("cpuGovernor", 1.0f);
+
+    for (int note = 0; note < sampler.getMaxPolyphony(); ++note) {
+        ScheduledEvent event;
+        event.type = ScheduledEvent::NOTE_ON;
+        event.time = 0.0;
+        event.sampleOffset = 0;
+        event.data.note.midiNote = 48 + note;
+        event.data.note.velocity = 0.2f + 0.05f * note;
+        sampler.handleEvent(event);
+    }
+
+    std::vector<float> left(256 * 8, 0.0f);
+    std::vector<float> right(256 * 8, 0.0f);
+
+    // A budget no render can meet: every block is under pressure
+    sampler.setParameter("cpuBudget", 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), static_cast<int>(left.size()), 256);
+    processAudioInChunks(sampler, left.data(), right.data(), static_cast<int>(left.size()), 256);
+
+    int degradedLevel = static_cast<int>(sampler.getParameter("governorLevel"));
+    int survivingVoices = sampler.getActiveVoiceCount();
+    std::cout << "    Under pressure: level " << degradedLevel << ", voices " << survivingVoices
+              << ", load " << sampler.getParameter("cpuLoad") << std::endl;
+
+    if (degradedLevel != 4 || survivingVoices >= sampler.getMaxPolyphony()) {
+        stats.fail("cpu_governor", "Governor did not step down to shedding voices");
+        return false;
+    }
+
+    // A note at the voice limit fades the quietest voice out beside it
+    // instead of restarting that voice in place
+    sampler.setParameter("cpuBudget", 1.0f);
+    ScheduledEvent stealEvent;
+    stealEvent.type = ScheduledEvent::NOTE_ON;
+    stealEvent.time = 0.0;
+    stealEvent.sampleOffset = 0;
+    stealEvent.data.note.midiNote = 30;
+    stealEvent.data.note.velocity = 1.0f;
+    sampler.handleEvent(stealEvent);
+    int stealVoices = sampler.getActiveVoiceCount();
+    processAudioInChunks(sampler, left.data(), right.data(), 1024, 256);
+    int fadedVoices = sampler.getActiveVoiceCount();
+    std::cout << "    Steal at the limit: voices " << survivingVoices << " -> " << stealVoices
+              << " -> " << fadedVoices << " after 21 ms" << std::endl;
+
+    if (stealVoices != survivingVoices + 1 || fadedVoices >= stealVoices) {
+        stats.fail("cpu_governor", "Stolen voice was restarted instead of faded out");
+        return false;
+    }
+
+    // Generous budget: quality comes back one step per ~250 ms of headroom
+    sampler.setParameter("cpuBudget", 1.0f);
+    std::vector<float> longLeft(48000 * 2, 0.0f);
+    std::vector<float> longRight(longLeft.size(), 0.0f);
+    processAudioInChunks(sampler, longLeft.data(), longRight.data(), static_cast<int>(longLeft.size()), 256);
+
+    int restoredLevel = static_cast<int>(sampler.getParameter("governorLevel"));
+    std::cout << "    With headroom: level " << restoredLevel << std::endl;
+
+    if (restoredLevel != 0) {
+        stats.fail("cpu_governor", "Governor did not restore full quality");
+        return false;
+    }
+
+    stats.pass("cpu_governor");
+    return true;
+}
+
+//==============================================================================
+// Test 18: Silent Voice Retirement
+//==============================================================================
+
+bool testSilentVoiceRetirement(TestStats& stats) {
+    std::cout << "\n[Test 18] Silent Voice Retirement" << std::endl;
+
+    // Decay to a zero sustain: the voice is inaudible long before the sample ends
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("envDecay", 0.05f);
+    sampler.setParameter("envSustain", 0.0f);
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = 60;
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    std::vector<float> left(48000 / 4, 0.0f);
+    std::vector<float> right(left.size(), 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), static_cast<int>(left.size()), 256);
+
+    if (sampler.getActiveVoiceCount() != 0) {
+        stats.fail("silent_voice_retirement", "Voice at zero sustain still active");
+        return false;
+    }
+
+    // Quiet sample content never retires a voice whose gain is audible: 200 ms
+    // of leading silence, a 100 ms tone, then silence held at full sustain
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = 48000;
+    sample->rootNote = 60;
+    sample->numSamples = 48000;
+    sample->numChannels = 1;
+    sample->channels.assign(1, AudioChannelBuffer(48000, 0.0f));
+    for (int i = 9600; i < 14400; ++i) {
+        sample->channels[0][i] = static_cast<float>(std::sin(2.0 * M_PI * 440.0 * i / 48000.0));
+    }
+    sample->addGuardFrames();
+
+    SamSamplerVoice voice;
+    voice.prepare(48000.0, 256);
+    voice.setEnvelopeParameters(0.001, 0.0, 0.0, 1.0, 0.1,
+                                EnvelopeCurve::Linear, EnvelopeCurve::Linear, EnvelopeCurve::Linear);
+    voice.startNote(60, 1.0f, sample);
+
+    std::vector<float> voiceLeft(256, 0.0f);
+    std::vector<float> voiceRight(256, 0.0f);
+    float* outputs[] = { voiceLeft.data(), voiceRight.data() };
+    float tonePeak = 0.0f;
+    for (int block = 0; block < 24000 / 256; ++block) {
+        std::fill(voiceLeft.begin(), voiceLeft.end(), 0.0f);
+        voice.process(outputs, 2, 256, 48000.0);
+        for (float value : voiceLeft)
+            tonePeak = std::max(tonePeak, std::abs(value));
+    }
+
+    std::cout << "    Held voice after 0.5 s: " << (voice.isActive() ? "active" : "retired")
+              << ", tone peak after leading silence " << tonePeak << std::endl;
+
+    if (!voice.isActive() || tonePeak < 0.1f) {
+        stats.fail("silent_voice_retirement", "Voice with audible gain was retired during quiet sample content");
+        return false;
+    }
+
+    // Released, its gain falls below the threshold and the voice retires
+    voice.stopNote(0.0f);
+    int releaseBlocks = 0;
+    while (voice.isActive() && releaseBlocks < 48000 / 256) {
+        voice.process(outputs, 2, 256, 48000.0);
+        ++releaseBlocks;
+    }
+
+    double retiredAt = releaseBlocks * 256 / 48000.0;
+    std::cout << "    Released voice retired after " << retiredAt << " s (0.1 s release)" << std::endl;
+
+    if (voice.isActive() || retiredAt > 0.2) {
+        stats.fail("silent_voice_retirement", "Released voice was not retired once inaudible");
+        return false;
+    }
+
+    stats.pass("silent_voice_retirement");
+    return true;
+}
+
+//==============================================================================
+// Test 19: Denormal Protection
+//==============================================================================
+
+bool testDenormalProtection(TestStats& stats) {
+    std::cout << "\n[Test 19] Denormal Protection" << std::endl;
+
+    // Resonant filter and a long release. With early retirement off the tail
+    // decays all the way into subnormal range; with it on (the default) the
+    // voices stop rendering once inaudible. Work is counted in voice-blocks.
+    auto renderTail = [](bool retire, int& subnormals, int& tailVoiceBlocks) {
+        SamSamplerDSP sampler;
+        sampler.prepare(48000.0, 256);
+        if (!retire)
+            sampler.setParameter("silenceThreshold", -160.0f);
+        sampler.setParameter("filterEnabled", 1.0f);
+        sampler.setParameter("filterCutoff", 2000.0f);
+        sampler.setParameter("filterResonance", 0.9f);
+        sampler.setParameter("envRelease", 5.0f);
+
+        auto sendNotes = [&](ScheduledEvent::Type type, float velocity) {
+            for (int note = 0; note < 8; ++note) {
+                ScheduledEvent event;
+                event.type = type;
+                event.time = 0.0;
+                event.sampleOffset = 0;
+                event.data.note.midiNote = 48 + note;
+                event.data.note.velocity = velocity;
+                sampler.handleEvent(event);
+            }
+        };
+
+        const int blockSize = 256;
+        std::vector<float> left(blockSize, 0.0f);
+        std::vector<float> right(blockSize, 0.0f);
+        float* outputs[] = { left.data(), right.data() };
+
+        auto renderBlocks = [&](int numBlocks) {
+            int voiceBlocks = 0;
+            for (int block = 0; block < numBlocks; ++block) {
+                voiceBlocks += sampler.getActiveVoiceCount();
+                sampler.process(outputs, 2, blockSize);
+                for (int i = 0; i < blockSize; ++i) {
+                    subnormals += (std::fpclassify(left[i]) == FP_SUBNORMAL) + (std::fpclassify(right[i]) == FP_SUBNORMAL);
+                }
+            }
+            return voiceBlocks;
+        };
+
+        sendNotes(ScheduledEvent::NOTE_ON, 0.8f);
+        renderBlocks(48000 / 4 / blockSize);
+        sendNotes(ScheduledEvent::NOTE_OFF, 0.0f);
+        tailVoiceBlocks = renderBlocks(48000 / 2 / blockSize);
+        return sampler.getActiveVoiceCount();
+    };
+
+    int subnormals = 0;
+    int fullTail = 0, retiredTail = 0;
+    renderTail(false, subnormals, fullTail);
+    const int stillActive = renderTail(true, subnormals, retiredTail);
+
+    std::cout << "    Tail voice-blocks without/with retirement: " << fullTail << " / " << retiredTail
+              << ", subnormal outputs: " << subnormals << std::endl;
+
+    if (subnormals > 0) {
+        stats.fail("denormal_protection", "Subnormal samples reached the output");
+        return false;
+    }
+
+    // Inaudible tails are not rendered all the way down into denormal range
+    if (stillActive != 0 || retiredTail * 4 > fullTail) {
+        stats.fail("denormal_protection", "Release tail kept rendering after it became inaudible");
+        return false;
+    }
+
+    stats.pass("denormal_protection");
+    return true;
+}
+
+//==============================================================================
+// Test 20: Single-Precision Parity
+//==============================================================================
+
+namespace {
+
+// Ten seconds of a looped, filtered chord with a release half-way through
+std::vector<float> renderLongPassage(bool singlePrecision, bool fixedPointPhase) {
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("singlePrecision", singlePrecision ? 1.0f : 0.0f);
+    sampler.setParameter("fixedPointPhase", fixedPointPhase ? 1.0f : 0.0f);
+    sampler.setParameter("interpolationQuality", 2.0f);
+    sampler.setParameter("loopEnabled", 1.0f);
+    sampler.setParameter("loopStart", 0.2f);
+    sampler.setParameter("loopEnd", 0.8f);
+    sampler.setParameter("filterEnabled", 1.0f);
+    sampler.setParameter("filterCutoff", 3000.0f);
+    sampler.setParameter("filterResonance", 0.6f);
+    sampler.setParameter("envRelease", 2.0f);
+
+    const int notes[] = { 43, 55, 60, 64, 67, 71, 74, 79 };
+    ScheduledEvent event;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    for (int note : notes) {
+        event.type = ScheduledEvent::NOTE_ON;
+        event.data.note.midiNote = note;
+        event.data.note.velocity = 0.6f;
+        sampler.handleEvent(event);
+    }
+
+    const int half = 48000 * 5;
+    std::vector<float> left(half * 2, 0.0f);
+    std::vector<float> right(half * 2, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), half, 256);
+
+    for (int note : notes) {
+        event.type = ScheduledEvent::NOTE_OFF;
+        event.data.note.midiNote = note;
+        event.data.note.velocity = 0.0f;
+        sampler.handleEvent(event);
+    }
+    processAudioInChunks(sampler, left.data() + half, right.data() + half, half, 256);
+
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+} // namespace
+
+bool testSinglePrecisionParity(TestStats& stats) {
+    std::cout << "\n[Test 20] Single-Precision Parity" << std::endl;
+
+    for (bool fixedPointPhase : { false, true }) {
+        auto reference = renderLongPassage(false, fixedPointPhase);
+        auto single = renderLongPassage(true, fixedPointPhase);
+
+        double signal = 0.0, error = 0.0, maxError = 0.0;
+        for (size_t i = 0; i < reference.size(); ++i) {
+            double diff = static_cast<double>(single[i]) - reference[i];
+            signal += static_cast<double>(reference[i]) * reference[i];
+            error += diff * diff;
+            maxError = std::max(maxError, std::abs(diff));
+        }
+
+        double snr = 10.0 * std::log10(signal / std::max(error, 1e-30));
+        std::cout << "    " << (fixedPointPhase ? "Fixed" : "Float") << " playhead: peak deviation "
+                  << maxError << ", SNR " << snr << " dB" << std::endl;
+
+        if (signal < 1.0) {
+            stats.fail("single_precision_parity", "Passage rendered silence");
+            return false;
+        }
+
+        // Float keeps ~24 bits; allow a little growth through the filter recursion
+        if (maxError > 2e-5 || snr < 120.0) {
+            stats.fail("single_precision_parity", "Float render strays too far from the double reference");
+            return false;
+        }
+    }
+
+    stats.pass("single_precision_parity");
+    return true;
+}
+
+//==============================================================================
+// Test 21: SVF Coefficient Approximation
+//==============================================================================
+
+bool testFilterCoefficients(TestStats& stats) {
+    std::cout << "\n[Test 21] SVF Coefficient Approximation" << std::endl;
+
+    // Prewarp gain against std::tan over the audible range at common rates
+    double worstError = 0.0;
+    for (double sampleRate : { 44100.0, 48000.0, 96000.0 }) {
+        for (double cutoff = 20.0; cutoff <= 20000.0; cutoff *= 1.01) {
+            double exact = std::tan(M_PI * cutoff / sampleRate);
+            double approx = StateVariableFilter::cutoffToGain(cutoff, sampleRate);
+            worstError = std::max(worstError, std::abs(approx - exact) / exact);
+        }
+    }
+    std::cout << "    Worst relative gain error: " << worstError << std::endl;
+
+    if (worstError > 1e-7) {
+        stats.fail("filter_coefficients", "tan approximation is not accurate enough");
+        return false;
+    }
+
+    // A constant per-sample cutoff must match the block-rate filter once settled
+    const double sampleRate = 44100.0;
+    const int numSamples = 4096;
+    std::vector<float> blockPath(numSamples), modulatedPath(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        blockPath[i] = modulatedPath[i] = static_cast<float>(std::sin(2.0 * M_PI * 3000.0 * i / sampleRate));
+    std::vector<float> cutoffs(numSamples, 1500.0f);
+
+    StateVariableFilter blockFilter, modulatedFilter;
+    for (auto* filter : { &blockFilter, &modulatedFilter }) {
+        filter->prepare(sampleRate);
+        filter->type = FilterType::Lowpass;
+        filter->cutoff = filter->cutoffSmooth = 1500.0;
+        filter->resonance = filter->resonanceSmooth = 0.5;
+    }
+
+    float* blockChannels[1] = { blockPath.data() };
+    float* modulatedChannels[1] = { modulatedPath.data() };
+    blockFilter.process(blockChannels, 1, numSamples);
+    modulatedFilter.processModulated<double>(modulatedChannels, 1, numSamples, cutoffs.data());
+
+    float maxDiff = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+        maxDiff = std::max(maxDiff, std::abs(blockPath[i] - modulatedPath[i]));
+
+    // Settled gain at 3 kHz (RMS over 2058 samples = exactly 140 periods)
+    // against the bilinear-prewarped analog response at the prepared rate
+    const int measured = 2058;
+    double energy = 0.0;
+    for (int i = numSamples - measured; i < numSamples; ++i)
+        energy += static_cast<double>(blockPath[i]) * blockPath[i];
+    double gain = std::sqrt(2.0 * energy / measured);
+
+    double w = std::tan(M_PI * 3000.0 / sampleRate) / std::tan(M_PI * 1500.0 / sampleRate);
+    double q = 1.0 / (2.0 * (1.0 - 0.5 * 0.99));
+    double expected = 1.0 / std::sqrt((1.0 - w * w) * (1.0 - w * w) + (w / q) * (w / q));
+
+    std::cout << "    Block vs modulated: " << maxDiff << ", 3 kHz gain: " << gain
+              << " (expected " << expected << ")" << std::endl;
+
+    if (maxDiff > 1e-5f) {
+        stats.fail("filter_coefficients", "Per-sample path differs from the block path");
+        return false;
+    }
+    if (std::abs(gain - expected) > 2e-4) {
+        stats.fail("filter_coefficients", "Lowpass response does not follow the prepared sample rate");
+        return false;
+    }
+
+    stats.pass("filter_coefficients");
+    return true;
+}
+
+//==============================================================================
+// Test 22: SIMD Filter Bank
+//==============================================================================
+
+namespace {
+
+std::vector<float> renderFilteredChord(bool filterBank) {
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("singlePrecision", 1.0f);
+    sampler.setParameter("filterBank", filterBank ? 1.0f : 0.0f);
+    sampler.setParameter("filterEnabled", 1.0f);
+    sampler.setParameter("filterCutoff", 1200.0f);
+    sampler.setParameter("filterResonance", 0.7f);
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    for (int note = 0; note < 7; ++note) {
+        event.data.note.midiNote = 50 + note * 3;
+        event.data.note.velocity = 0.4f + 0.05f * note;
+        sampler.handleEvent(event);
+    }
+
+    const int numSamples = 48000;
+    std::vector<float> left(numSamples, 0.0f);
+    std::vector<float> right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+} // namespace
+
+bool testFilterBank(TestStats& stats) {
+    std::cout << "\n[Test 22] SIMD Filter Bank" << std::endl;
+
+    // Nine lanes (two full passes and a partial one) across all four types;
+    // an odd block length exercises the per-sample tail
+    struct Setup { FilterType type; double cutoff; double resonance; int channels; };
+    const Setup setups[] = {
+        { FilterType::Lowpass,  800.0,   0.2, 2 },
+        { FilterType::Highpass, 3000.0,  0.6, 1 },
+        { FilterType::Bandpass, 1500.0,  0.9, 2 },
+        { FilterType::Notch,    5000.0,  0.4, 1 },
+        { FilterType::Lowpass,  12000.0, 0.8, 2 },
+        { FilterType::Bandpass, 200.0,   0.0, 1 },
+    };
+    const int numFilters = 6;
+    const int numSamples = 1001;
+
+    std::vector<StateVariableFilter> banked(numFilters), reference(numFilters);
+    std::vector<std::vector<float>> bankedAudio, referenceAudio;
+    for (int f = 0; f < numFilters; ++f) {
+        for (auto* filter : { &banked[f], &reference[f] }) {
+            filter->prepare(48000.0);
+            filter->type = setups[f].type;
+            filter->cutoff = filter->cutoffSmooth = setups[f].cutoff;
+            filter->resonance = filter->resonanceSmooth = setups[f].resonance;
+        }
+        for (int ch = 0; ch < 2; ++ch) {
+            std::vector<float> noise(numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                noise[i] = static_cast<float>(std::sin(0.37 * i * (f + 1) + ch) * std::cos(0.011 * i));
+            bankedAudio.push_back(noise);
+            referenceAudio.push_back(noise);
+        }
+    }
+
+    SvfBank bank;
+    bank.prepare(numSamples);
+    float maxDiff = 0.0f;
+
+    // Two blocks, so lane state must carry over between passes
+    for (int block = 0; block < 2; ++block) {
+        for (int f = 0; f < numFilters; ++f) {
+            float* bankedChannels[2] = { bankedAudio[f * 2].data(), bankedAudio[f * 2 + 1].data() };
+            float* referenceChannels[2] = { referenceAudio[f * 2].data(), referenceAudio[f * 2 + 1].data() };
+            bank.add(banked[f], bankedChannels, setups[f].channels, numSamples);
+            reference[f].processBlock<float>(referenceChannels, setups[f].channels, numSamples);
+        }
+        bank.flush();
+
+        for (size_t c = 0; c < bankedAudio.size(); ++c)
+            for (int i = 0; i < numSamples; ++i)
+                maxDiff = std::max(maxDiff, std::abs(bankedAudio[c][i] - referenceAudio[c][i]));
+    }
+
+    auto withBank = renderFilteredChord(true);
+    auto withoutBank = renderFilteredChord(false);
+    float engineDiff = 0.0f;
+    for (size_t i = 0; i < withBank.size(); ++i)
+        engineDiff = std::max(engineDiff, std::abs(withBank[i] - withoutBank[i]));
+
+    std::cout << "    Bank vs scalar float filter: " << maxDiff
+              << ", engine with/without bank: " << engineDiff << std::endl;
+
+    // Same operations in the same order; only FMA contraction may differ
+    if (maxDiff > 1e-6f || engineDiff > 1e-5f) {
+        stats.fail("filter_bank", "Banked filters differ from the per-voice filter");
+        return false;
+    }
+    if (getPeakLevel(withBank.data(), static_cast<int>(withBank.size())) < 0.05f) {
+        stats.fail("filter_bank", "Filtered chord rendered silence");
+        return false;
+    }
+
+    stats.pass("filter_bank");
+    return true;
+}
+
+//==============================================================================
+// Test 23: Stereo Enhancement
+//==============================================================================
+
+namespace {
+
+struct StereoRender {
+    std::vector<float> left, right;
+};
+
+StereoRender renderStereoNote(float offset, float spread, float width, bool filter, int midiNote) {
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("stereoPositionOffset", offset);
+    sampler.setParameter("stereoFilterSpread", spread);
+    sampler.setParameter("stereoWidth", width);
+    sampler.setParameter("envSustain", 1.0f);
+    if (filter) {
+        sampler.setParameter("filterEnabled", 1.0f);
+        sampler.setParameter("filterCutoff", 1500.0f);
+    }
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = midiNote;
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    StereoRender render { std::vector<float>(24000, 0.0f), std::vector<float>(24000, 0.0f) };
+    // Odd block size: the delay line must carry across block boundaries
+    processAudioInChunks(sampler, render.left.data(), render.right.data(), 24000, 100);
+    return render;
+}
+
+double rms(const std::vector<float>& audio, int begin) {
+    double sum = 0.0;
+    for (size_t i = static_cast<size_t>(begin); i < audio.size(); ++i)
+        sum += static_cast<double>(audio[i]) * audio[i];
+    return std::sqrt(sum / static_cast<double>(audio.size() - static_cast<size_t>(begin)));
+}
+
+} // namespace
+
+bool testStereoEnhancement(TestStats& stats) {
+    std::cout << "\n[Test 23] Stereo Enhancement" << std::endl;
+
+    // Offset 0.5 = 10 ms: the left channel is the right one, 480 samples later
+    auto offset = renderStereoNote(0.5f, 0.0f, 1.0f, false, 60);
+    const int lag = 480;
+    float lagError = 0.0f;
+    for (int i = lag; i < 24000; ++i)
+        lagError = std::max(lagError, std::abs(offset.left[i] - offset.right[i - lag]));
+    float leadIn = getPeakLevel(offset.left.data(), lag);
+
+    // Zero width folds the offset pair back to identical channels
+    auto mono = renderStereoNote(0.5f, 0.0f, 0.0f, false, 60);
+    float widthError = 0.0f;
+    for (int i = 0; i < 24000; ++i)
+        widthError = std::max(widthError, std::abs(mono.left[i] - mono.right[i]));
+
+    // Spread 0.5 around 1.5 kHz: 1125 Hz left, 1875 Hz right, on a ~1.76 kHz note
+    auto spread = renderStereoNote(0.0f, 0.5f, 1.0f, true, 84);
+    double leftLevel = rms(spread.left, 4800);
+    double rightLevel = rms(spread.right, 4800);
+
+    std::cout << "    Lag error: " << lagError << ", left lead-in peak: " << leadIn
+              << ", width 0 difference: " << widthError << std::endl;
+    std::cout << "    Spread RMS left/right: " << leftLevel << " / " << rightLevel << std::endl;
+
+    if (lagError > 0.0f || leadIn > 0.0f || getPeakLevel(offset.right.data(), 24000) < 0.1f) {
+        stats.fail("stereo_enhancement", "Position offset does not delay the left channel");
+        return false;
+    }
+    if (widthError > 1e-6f) {
+        stats.fail("stereo_enhancement", "Zero stereo width did not collapse to mono");
+        return false;
+    }
+    if (rightLevel < leftLevel * 1.2) {
+        stats.fail("stereo_enhancement", "Filter spread did not open the right channel");
+        return false;
+    }
+
+    stats.pass("stereo_enhancement");
+    return true;
+}
+
+//==============================================================================
+// Test 24: Constant-Power Panning
+//==============================================================================
+
+namespace {
+
+// Mean-square level of each side for one sustained note
+std::pair<double, double> renderPannedNote(float pan, float keySpread, int midiNote) {
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("pan", pan);
+    sampler.setParameter("panKeySpread", keySpread);
+    sampler.setParameter("envSustain", 1.0f);
+
+    ScheduledEvent event;
+    event.type = ScheduledEvent::NOTE_ON;
+    event.time = 0.0;
+    event.sampleOffset = 0;
+    event.data.note.midiNote = midiNote;
+    event.data.note.velocity = 0.8f;
+    sampler.handleEvent(event);
+
+    const int numSamples = 12000;
+    std::vector<float> left(numSamples, 0.0f), right(numSamples, 0.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+
+    double l = 0.0, r = 0.0;
+    for (int i = 2400; i < numSamples; ++i) {
+        l += static_cast<double>(left[i]) * left[i];
+        r += static_cast<double>(right[i]) * right[i];
+    }
+    return { l, r };
+}
+
+} // namespace
+
+bool testConstantPowerPanning(TestStats& stats) {
+    std::cout << "\n[Test 24] Constant-Power Panning" << std::endl;
+
+    auto center = renderPannedNote(0.0f, 0.0f, 60);
+    auto hardLeft = renderPannedNote(-1.0f, 0.0f, 60);
+    auto partRight = renderPannedNote(0.4f, 0.0f, 60);
+    auto lowKey = renderPannedNote(0.0f, 1.0f, 36);
+    auto highKey = renderPannedNote(0.0f, 1.0f, 84);
+
+    const double centerPower = center.first + center.second;
+    const double leftPower = hardLeft.first + hardLeft.second;
+    const double partPower = partRight.first + partRight.second;
+
+    std::cout << "    Power left/center/0.4: " << leftPower / centerPower << " / 1 / "
+              << partPower / centerPower << ", hard-left right side: " << hardLeft.second << std::endl;
+    std::cout << "    Key spread L/R: note 36 " << lowKey.first << "/" << lowKey.second
+              << ", note 84 " << highKey.first << "/" << highKey.second << std::endl;
+
+    if (std::abs(center.first - center.second) > 1e-9 * centerPower) {
+        stats.fail("constant_power_panning", "Centered voice is not balanced");
+        return false;
+    }
+    if (hardLeft.second > 1e-12 || std::abs(leftPower / centerPower - 1.0) > 1e-4
+        || std::abs(partPower / centerPower - 1.0) > 1e-4 || partRight.second <= partRight.first) {
+        stats.fail("constant_power_panning", "Pan law does not keep total power constant");
+        return false;
+    }
+    if (lowKey.first <= lowKey.second || highKey.second <= highKey.first) {
+        stats.fail("constant_power_panning", "Key spread does not place low keys left and high keys right");
+        return false;
+    }
+
+    stats.pass("constant_power_panning");
+    return true;
+}
+
+//==============================================================================
+// Test 25: Multi-Output Routing
+//==============================================================================
+
+namespace {
+
+// Plays one note per key and returns the mean-square level of every channel
+std::vector<double> renderRoutedNotes(SamSamplerDSP& sampler, const std::vector<int>& notes, int numChannels) {
+    for (int note : notes) {
+        ScheduledEvent event;
+        event.type = ScheduledEvent::NOTE_ON;
+        event.time = 0.0;
+        event.sampleOffset = 0;
+        event.data.note.midiNote = note;
+        event.data.note.velocity = 0.8f;
+        sampler.handleEvent(event);
+    }
+
+    const int blockSize = 256;
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(numChannels), std::vector<float>(blockSize));
+    std::vector<float*> outputs;
+    for (auto& buffer : buffers)
+        outputs.push_back(buffer.data());
+
+    std::vector<double> power(static_cast<size_t>(numChannels), 0.0);
+    for (int block = 0; block < 32; ++block) {
+        sampler.process(outputs.data(), numChannels, blockSize);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (float x : buffers[static_cast<size_t>(ch)])
+                power[static_cast<size_t>(ch)] += static_cast<double>(x) * x;
+    }
+    return power;
+}
+
+} // namespace
+
+bool testMultiOutputRouting(TestStats& stats) {
+    std::cout << "\n[Test 25] Multi-Output Routing" << std::endl;
+
+    // Kick to aux 1, snare to aux 2, everything else on the main bus
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("envSustain", 1.0f);
+    sampler.setParameter("auxOutputs", 2.0f);
+    sampler.setOutputGroup(36, 36, 1);
+    sampler.setOutputGroup(38, 38, 2);
+
+    const int notes[3] = { 36, 38, 60 };
+    const int pairs[3] = { 2, 4, 0 };
+    std::vector<double> solo[3];
+    for (int n = 0; n < 3; ++n) {
+        sampler.reset();
+        solo[n] = renderRoutedNotes(sampler, { notes[n] }, 6);
+    }
+    sampler.reset();
+    auto kit = renderRoutedNotes(sampler, { 36, 38, 60 }, 6);
+
+    std::cout << "    Kit, per channel:";
+    for (double p : kit)
+        std::cout << " " << p;
+    std::cout << std::endl;
+
+    // Each piece plays on its own pair only, and the kit is the pieces side by side
+    bool routed = true;
+    for (int n = 0; n < 3; ++n) {
+        for (int ch = 0; ch < 6; ++ch) {
+            const double p = solo[n][static_cast<size_t>(ch)];
+            const bool own = ch == pairs[n] || ch == pairs[n] + 1;
+            routed = routed && (own ? p > 0.0 : p == 0.0);
+            if (own)
+                routed = routed && std::abs(kit[static_cast<size_t>(ch)] - p) < 1e-9 * p;
+        }
+    }
+    if (!routed) {
+        stats.fail("multi_output_routing", "Key groups do not land on their own output pairs");
+        return false;
+    }
+    const double level = solo[0][2];
+
+    // A bus the channel layout does not carry falls back to the main bus
+    SamSamplerDSP stereo;
+    stereo.prepare(48000.0, 256);
+    stereo.setParameter("envSustain", 1.0f);
+    stereo.setParameter("auxOutputs", 2.0f);
+    stereo.setOutputGroup(36, 36, 2);
+    auto fallback = renderRoutedNotes(stereo, { 36 }, 4);
+    if (std::abs(fallback[0] - level) > 1e-6 * level || fallback[2] != 0.0 || fallback[3] != 0.0) {
+        stats.fail("multi_output_routing", "Uncovered aux bus does not fall back to the main bus");
+        return false;
+    }
+
+    stats.pass("multi_output_routing");
+    return true;
+}
+
+//==============================================================================
+// Test 26: Multi-Timbral Parts
+//==============================================================================
+
+namespace {
+
+// Mean-square level of each side over numBlocks blocks
+std::pair<double, double> renderSides(SamSamplerDSP& sampler, int numBlocks) {
+    const int blockSize = 256;
+    std::vector<float> left(blockSize), right(blockSize);
+    float* outputs[2] = { left.data(), right.data() };
+
+    double l = 0.0, r = 0.0;
+    for (int block = 0; block < numBlocks; ++block) {
+        sampler.process(outputs, 2, blockSize);
+        for (int i = 0; i < blockSize; ++i) {
+            l += static_cast<double>(left[i]) * left[i];
+            r += static_cast<double>(right[i]) * right[i];
+        }
+    }
+    return { l, r };
+}
+
+} // namespace
+
+bool testMultiTimbralParts(TestStats& stats) {
+    std::cout << "\n[Test 26] Multi-Timbral Parts" << std::endl;
+
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    sampler.setParameter("envSustain", 1.0f);
+    sampler.setParameter("multiTimbral", 1.0f);
+    sampler.setPartPan(1, -1.0f);
+    sampler.setPartPan(2, 1.0f);
+    sampler.setPartVolume(2, 0.5f);
+
+    // The same key on two channels is two voices from the shared pool
+    sampler.noteOn(60, 0.8f, 1);
+    sampler.noteOn(60, 0.8f, 2);
+    renderSides(sampler, 8);
+    auto both = renderSides(sampler, 16);
+
+    // Note-off on channel 2 releases only channel 2's voice
+    sampler.noteOff(60, 0.0f, 2);
+    renderSides(sampler, 64);
+    auto afterOff = renderSides(sampler, 16);
+
+    // CC 7 turns channel 1 down while its note sounds
+    sampler.controlChange(7, 0.5f, 1);
+    auto ccVolume = renderSides(sampler, 16);
+
+    std::cout << "    Both parts L/R: " << both.first << " / " << both.second
+              << ", after channel 2 off: " << afterOff.first << " / " << afterOff.second
+              << ", CC 7 at 64: " << ccVolume.first << std::endl;
+
+    if (sampler.getActiveVoiceCount() != 1 || afterOff.second > 1e-9 * afterOff.first) {
+        stats.fail("multi_timbral_parts", "Note-off does not address the voice of its own channel");
+        return false;
+    }
+    if (std::abs(both.second / both.first - 0.25) > 1e-3 || std::abs(afterOff.first - both.first) > 1e-2 * both.first) {
+        stats.fail("multi_timbral_parts", "Part volume and pan are not applied per channel");
+        return false;
+    }
+    if (std::abs(ccVolume.first / afterOff.first - 0.0625) > 1e-3) {
+        stats.fail("multi_timbral_parts", "CC 7 does not follow the GM volume curve on sounding voices");
+        return false;
+    }
+
+    // Single-timbral mode ignores the channel and the part settings
+    sampler.reset();
+    sampler.setParameter("multiTimbral", 0.0f);
+    sampler.noteOn(60, 0.8f, 2);
+    auto single = renderSides(sampler, 16);
+    sampler.noteOff(60, 0.0f, 5);
+    if (std::abs(single.first - single.second) > 1e-9 * single.first || sampler.getActiveVoiceCount() != 1) {
+        stats.fail("multi_timbral_parts", "Single-timbral mode does not ignore the MIDI channel");
+        return false;
+    }
+
+    stats.pass("multi_timbral_parts");
+    return true;
+}
+
+//==============================================================================
+// Test 27: SF2 Generator Flattening
+//==============================================================================
+
+namespace {
+
+// Minimal SoundFont writer: one preset playing one instrument
+struct TestSoundFont {
+    struct Zone {
+        std::vector<std::pair<uint16_t, int16_t>> generators;
+        std::vector<std::vector<uint16_t>> modulators;   // src, dest, amount, amountSrc, transform
+    };
+
+    struct SampleData {
+        std::vector<int16_t> pcm;
+        uint32_t loopStart = 0;        // Relative to the sample
+        uint32_t loopEnd = 0;
+        uint32_t sampleRate = 44100;
+        uint8_t originalPitch = 60;
+        int8_t pitchCorrection = 0;
+        uint16_t link = 0;
+        uint16_t type = 1;
+    };
+
+    std::vector<Zone> presetZones;        // A zone without an instrument generator is global
+    std::vector<Zone> instrumentZones;    // A zone without a sampleID generator is global
+    std::vector<SampleData> samples;
+
+    static std::vector<int16_t> sine(double frequency, double amplitude, int numFrames, double sampleRate = 44100.0) {
+        std::vector<int16_t> pcm(static_cast<size_t>(numFrames));
+        for (int i = 0; i < numFrames; ++i)
+            pcm[static_cast<size_t>(i)] = static_cast<int16_t>(std::lround(
+                32767.0 * amplitude * std::sin(2.0 * M_PI * frequency * i / sampleRate)));
+        return pcm;
+    }
+
+    std::string write(const char* fileName) const {
+        std::vector<uint8_t> out;
+        auto u8 = [](std::vector<uint8_t>& b, int v) { b.push_back(static_cast<uint8_t>(v)); };
+        auto u16 = [&](std::vector<uint8_t>& b, int v) { u8(b, v & 0xFF); u8(b, (v >> 8) & 0xFF); };
+        auto u32 = [&](std::vector<uint8_t>& b, uint32_t v) { u16(b, static_cast<int>(v & 0xFFFF)); u16(b, static_cast<int>(v >> 16)); };
+        auto name = [&](std::vector<uint8_t>& b, const char* text) {
+            for (size_t i = 0; i < 20; ++i)
+                u8(b, i < std::strlen(text) ? text[i] : 0);
+        };
+        auto chunk = [&](std::vector<uint8_t>& b, const char* id, const std::vector<uint8_t>& body) {
+            b.insert(b.end(), id, id + 4);
+            u32(b, static_cast<uint32_t>(body.size()));
+            b.insert(b.end(), body.begin(), body.end());
+            if (body.size() & 1)
+                u8(b, 0);
+        };
+        auto list = [&](const char* type, const std::vector<uint8_t>& body) {
+            std::vector<uint8_t> content(type, type + 4);
+            content.insert(content.end(), body.begin(), body.end());
+            chunk(out, "LIST", content);
+        };
+        auto zoneTables = [&](const std::vector<Zone>& zones, std::vector<uint8_t>& bag,
+                              std::vector<uint8_t>& mod, std::vector<uint8_t>& gen) {
+            int genIndex = 0, modIndex = 0;
+            for (const auto& zone : zones) {
+                u16(bag, genIndex);
+                u16(bag, modIndex);
+                for (const auto& m : zone.modulators) {
+                    for (uint16_t field : m)
+                        u16(mod, field);
+                    ++modIndex;
+                }
+                for (const auto& g : zone.generators) {
+                    u16(gen, g.first);
+                    u16(gen, static_cast<uint16_t>(g.second));
+                    ++genIndex;
+                }
+            }
+            u16(bag, genIndex);
+            u16(bag, modIndex);
+            for (int i = 0; i < 5; ++i)
+                u16(mod, 0);
+            u32(gen, 0);
+        };
+
+        std::vector<uint8_t> info, smpl, pdta;
+        std::vector<uint8_t> ifil;
+        u16(ifil, 2);
+        u16(ifil, 1);
+        chunk(info, "ifil", ifil);
+        chunk(info, "INAM", std::vector<uint8_t>({ 'T', 'e', 's', 't', 0, 0 }));
+
+        std::vector<uint32_t> starts;
+        for (const auto& sample : samples) {
+            starts.push_back(static_cast<uint32_t>(smpl.size() / 2));
+            for (int16_t v : sample.pcm)
+                u16(smpl, static_cast<uint16_t>(v));
+            for (int i = 0; i < 46; ++i)
+                u16(smpl, 0);
+        }
+        std::vector<uint8_t> sdta;
+        chunk(sdta, "smpl", smpl);
+
+        std::vector<uint8_t> phdr, pbag, pmod, pgen, inst, ibag, imod, igen, shdr;
+        name(phdr, "Test Preset");
+        u16(phdr, 0); u16(phdr, 0); u16(phdr, 0); u32(phdr, 0); u32(phdr, 0); u32(phdr, 0);
+        name(phdr, "EOP");
+        u16(phdr, 0); u16(phdr, 0); u16(phdr, static_cast<int>(presetZones.size())); u32(phdr, 0); u32(phdr, 0); u32(phdr, 0);
+        zoneTables(presetZones, pbag, pmod, pgen);
+
+        name(inst, "Test Instrument");
+        u16(inst, 0);
+        name(inst, "EOI");
+        u16(inst, static_cast<int>(instrumentZones.size()));
+        zoneTables(instrumentZones, ibag, imod, igen);
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const auto& sample = samples[i];
+            name(shdr, "Sample");
+            u32(shdr, starts[i]);
+            u32(shdr, starts[i] + static_cast<uint32_t>(sample.pcm.size()));
+            u32(shdr, starts[i] + sample.loopStart);
+            u32(shdr, starts[i] + sample.loopEnd);
+            u32(shdr, sample.sampleRate);
+            u8(shdr, sample.originalPitch);
+            u8(shdr, static_cast<uint8_t>(sample.pitchCorrection));
+            u16(shdr, sample.link);
+            u16(shdr, sample.type);
+        }
+        name(shdr, "EOS");
+        for (int i = 0; i < 26; ++i)
+            u8(shdr, 0);
+
+        chunk(pdta, "phdr", phdr); chunk(pdta, "pbag", pbag); chunk(pdta, "pmod", pmod); chunk(pdta, "pgen", pgen);
+        chunk(pdta, "inst", inst); chunk(pdta, "ibag", ibag); chunk(pdta, "imod", imod); chunk(pdta, "igen", igen);
+        chunk(pdta, "shdr", shdr);
+
+        list("INFO", info);
+        list("sdta", sdta);
+        list("pdta", pdta);
+
+        std::vector<uint8_t> riff({ 's', 'f', 'b', 'k' });
+        riff.insert(riff.end(), out.begin(), out.end());
+        std::vector<uint8_t> file;
+        chunk(file, "RIFF", riff);
+
+        const std::string path = (std::filesystem::temp_directory_path() / fileName).string();
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()),
+                                                    static_cast<std::streamsize>(file.size()));
+        return path;
+    }
+};
+
+inline uint16_t keyRange(int low, int high) { return static_cast<uint16_t>(low | (high << 8)); }
+
+// Removes a test SoundFont and the index cache loading it left beside it
+void removeSoundFont(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove(SF2Reader::indexCachePath(path.c_str()).c_str());
+}
+
+// Zero-crossing frequency of one channel over [begin, end)
+double measureFrequency(const std::vector<float>& signal, int begin, int end, double sampleRate) {
+    int crossings = 0;
+    for (int i = begin + 1; i < end; ++i)
+        if ((signal[static_cast<size_t>(i) - 1] < 0.0f) != (signal[static_cast<size_t>(i)] < 0.0f))
+            ++crossings;
+    return crossings * 0.5 * sampleRate / (end - begin);
+}
+
+} // namespace
+
+bool testSF2GeneratorFlattening(TestStats& stats) {
+    std::cout << "\n[Test 27] SF2 Generator Flattening" << std::endl;
+
+    // Preset global attenuation adds to the instrument's; the instrument global
+    // zone sets sustain and cutoff for every zone; keys 64+ are a linked L/R pair
+    TestSoundFont font;
+    font.presetZones = {
+        { { { 48, 20 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(0, 127)) }, { 41, 0 } }, {} } };
+    font.instrumentZones = {
+        { { { 37, 60 }, { 8, 8000 }, { 48, 30 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(0, 63)) }, { 51, 12 }, { 53, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(64, 127)) }, { 17, -500 }, { 53, 1 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(64, 127)) }, { 17, 500 }, { 53, 2 } }, {} } };
+
+    TestSoundFont::SampleData mono;
+    mono.pcm = TestSoundFont::sine(440.0, 0.5, 44100);
+    mono.originalPitch = 69;
+    TestSoundFont::SampleData left = mono, right = mono;
+    left.originalPitch = right.originalPitch = 80;
+    right.pcm.assign(right.pcm.size(), 0);
+    left.type = 4; left.link = 2;
+    right.type = 2; right.link = 1;
+    font.samples = { mono, left, right };
+
+    const std::string path = font.write("samsampler_flatten_test.sf2");
+
+    SF2Reader reader;
+    if (!reader.loadFile(path.c_str()) || reader.getInstrumentCount() != 1) {
+        stats.fail("sf2_flattening", "Test SoundFont did not load");
+        return false;
+    }
+
+    const SF2Reader::Instrument* preset = reader.getInstrument(0);
+    const SF2Reader::Zone* low = reader.findZone(0, 40, 100.0f);
+    const SF2Reader::Zone* high = reader.findZone(0, 80, 100.0f);
+    const Sample* stereo = high ? reader.getSample(high->sampleIndex) : nullptr;
+
+    std::cout << "    Zones: " << preset->zones.size() << ", attenuation " << (low ? low->attenuation : -1.0f)
+              << " dB, sustain " << (low ? low->envSustain : -1.0f) << ", cutoff "
+              << (low ? low->filterCutoff : -1.0f) << " Hz, tuning " << (low ? low->tuning : -1.0) << " cents" << std::endl;
+
+    if (preset->zones.size() != 2 || !low || !high || !low->hasGenerators) {
+        stats.fail("sf2_flattening", "Zone hierarchy did not flatten to one record per playable zone");
+        return false;
+    }
+    if (std::abs(low->attenuation - 5.0f) > 1e-4f || std::abs(low->envSustain - 0.501187f) > 1e-4f
+        || std::abs(low->filterCutoff - 830.6f) > 0.5f || low->tuning != 1200.0 || low->rootKey != 69
+        || std::abs(high->attenuation - 5.0f) > 1e-4f) {
+        stats.fail("sf2_flattening", "Global and additive preset generators were not resolved");
+        return false;
+    }
+    if (!stereo || stereo->numChannels != 2 || high->pan != 0) {
+        stats.fail("sf2_flattening", "Linked left/right zones were not merged into a stereo zone");
+        return false;
+    }
+
+    // Note-on plays the zone record: coarse tune lifts A3 to the sample's A4
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    if (!sampler.loadSoundFont(path.c_str())) {
+        stats.fail("sf2_flattening", "Engine did not load the SoundFont");
+        return false;
+    }
+    sampler.noteOn(57, 0.8f);
+
+    const int numSamples = 9600;
+    std::vector<float> outLeft(numSamples, 0.0f), outRight(numSamples, 0.0f);
+    processAudioInChunks(sampler, outLeft.data(), outRight.data(), numSamples, 256);
+    const double frequency = measureFrequency(outLeft, 2400, numSamples, 48000.0);
+
+    sampler.reset();
+    sampler.noteOn(80, 0.8f);
+    processAudioInChunks(sampler, outLeft.data(), outRight.data(), numSamples, 256);
+    double leftPower = 0.0, rightPower = 0.0;
+    for (int i = 0; i < numSamples; ++i) {
+        leftPower += static_cast<double>(outLeft[i]) * outLeft[i];
+        rightPower += static_cast<double>(outRight[i]) * outRight[i];
+    }
+
+    std::cout << "    Note 57 plays " << frequency << " Hz; stereo zone L/R power "
+              << leftPower << " / " << rightPower << std::endl;
+
+    removeSoundFont(path);
+
+    if (std::abs(frequency - 440.0) > 5.0) {
+        stats.fail("sf2_flattening", "Zone tuning was not applied at note-on");
+        return false;
+    }
+    if (leftPower <= 0.0 || rightPower > 1e-12 * leftPower) {
+        stats.fail("sf2_flattening", "Stereo zone does not keep its channels apart");
+        return false;
+    }
+
+    stats.pass("sf2_flattening");
+    return true;
+}
+
+bool testSF2Modulators(TestStats& stats) {
+    std::cout << "\n[Test 28] SF2 Modulators" << std::endl;
+
+    // The zone adds CC 2 -> attenuation (linear, 20 dB at full), CC 3 ->
+    // attenuation (-60 dB at full, a boost past the +12 dB ceiling) and
+    // switches off the default velocity -> cutoff modulator with an identical
+    // zero one
+    TestSoundFont font;
+    font.presetZones = { { { { 41, 0 } }, {} } };
+    font.instrumentZones = { { { { 53, 0 } }, { { 0x0082, 48, 200, 0, 0 },
+                                                { 0x0083, 48, static_cast<uint16_t>(-600), 0, 0 },
+                                                { 0x0102, 8, 0, 0, 0 } } } };
+    TestSoundFont::SampleData sine;
+    sine.pcm = TestSoundFont::sine(440.0, 0.5, 88200);
+    sine.originalPitch = 69;
+    font.samples = { sine };
+
+    const std::string path = font.write("samsampler_modulator_test.sf2");
+
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    SF2Reader reader;
+    if (!reader.loadFile(path.c_str()) || !sampler.loadSoundFont(path.c_str())) {
+        stats.fail("sf2_modulators", "Test SoundFont did not load");
+        return false;
+    }
+
+    // Velocity -> attenuation runs at note-on; pressure, mod wheel, expression,
+    // pitch wheel, CC 2 and CC 3 at control rate
+    const ModulatorProgram& program = reader.findZone(0, 69, 127.0f)->modulators;
+    std::cout << "    Program: " << program.ops.size() << " ops, " << program.numStatic << " at note-on" << std::endl;
+    if (program.ops.size() != 7 || program.numStatic != 1 || !program.isDynamic(ModulatorProgram::Pitch)
+        || !program.isDynamic(ModulatorProgram::Attenuation) || program.isDynamic(ModulatorProgram::FilterCutoff)) {
+        stats.fail("sf2_modulators", "Default and zone modulators did not compile as expected");
+        removeSoundFont(path);
+        return false;
+    }
+
+    const int numSamples = 9600;
+    std::vector<float> left(numSamples, 0.0f), right(numSamples, 0.0f);
+    auto rms = [&](int begin) {
+        double sum = 0.0;
+        for (int i = begin; i < numSamples; ++i)
+            sum += static_cast<double>(left[static_cast<size_t>(i)]) * left[static_cast<size_t>(i)];
+        return std::sqrt(sum / (numSamples - begin));
+    };
+
+    sampler.setParameter("pitchBendRange", 2.0f);
+    sampler.noteOn(69, 1.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    const double plain = measureFrequency(left, 2400, numSamples, 48000.0);
+    const double plainLevel = rms(2400);
+
+    // Full bend up: the default pitch wheel modulator moves by pitchBendRange
+    sampler.pitchBend(1.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    const double bent = measureFrequency(left, 2400, numSamples, 48000.0);
+
+    sampler.controlChange(2, 1.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    const double attenuatedLevel = rms(2400);
+
+    // Modulators can lift a voice at most 12 dB over its note-on level
+    sampler.controlChange(2, 0.0f);
+    sampler.controlChange(3, 1.0f);
+    processAudioInChunks(sampler, left.data(), right.data(), numSamples, 256);
+    const double boostedLevel = rms(2400);
+
+    std::cout << "    " << plain << " Hz, bent " << bent << " Hz; CC 2 level ratio "
+              << attenuatedLevel / plainLevel << ", CC 3 level ratio " << boostedLevel / plainLevel << std::endl;
+
+    removeSoundFont(path);
+
+    if (std::abs(plain - 440.0) > 5.0 || std::abs(bent - 493.88) > 5.0) {
+        stats.fail("sf2_modulators", "Pitch wheel did not bend through the default modulator");
+        return false;
+    }
+    if (plainLevel <= 0.0 || std::abs(attenuatedLevel / plainLevel - 0.1) > 0.01) {
+        stats.fail("sf2_modulators", "Zone modulator did not attenuate at control rate");
+        return false;
+    }
+    if (std::abs(boostedLevel / plainLevel - std::pow(10.0, 12.0 / 20.0)) > 0.05) {
+        stats.fail("sf2_modulators", "Modulated gain was not held at +12 dB");
+        return false;
+    }
+
+    stats.pass("sf2_modulators");
+    return true;
+}
+
+bool testSF2ZoneLoops(TestStats& stats) {
+    std::cout << "\n[Test 29] SF2 Zone Loops" << std::endl;
+
+    // 440 Hz at 44 kHz: 100-frame periods, looped over nine of them. Key 60
+    // plays once, key 62 loops (its loop start moved a period in by an
+    // offset), key 64 loops until release. Release is one second.
+    TestSoundFont font;
+    font.presetZones = { { { { 41, 0 } }, {} } };
+    font.instrumentZones = {
+        { { { 38, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(60, 60)) }, { 58, 60 }, { 53, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(62, 62)) }, { 58, 62 }, { 2, 100 }, { 54, 1 }, { 53, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(64, 64)) }, { 58, 64 }, { 54, 3 }, { 53, 0 } }, {} } };
+    TestSoundFont::SampleData sine;
+    sine.pcm = TestSoundFont::sine(440.0, 0.5, 2000, 44000.0);
+    sine.sampleRate = 44000;
+    sine.loopStart = 1000;
+    sine.loopEnd = 1900;
+    font.samples = { sine };
+
+    const std::string path = font.write("samsampler_loop_test.sf2");
+
+    SF2Reader reader;
+    if (!reader.loadFile(path.c_str())) {
+        stats.fail("sf2_zone_loops", "Test SoundFont did not load");
+        return false;
+    }
+    const SF2Reader::Zone* once = reader.findZone(0, 60, 127.0f);
+    const SF2Reader::Zone* offset = reader.findZone(0, 62, 127.0f);
+    const Sample* onceSample = once ? reader.getSample(once->sampleIndex) : nullptr;
+    const Sample* offsetSample = offset ? reader.getSample(offset->sampleIndex) : nullptr;
+    if (!onceSample || !offsetSample || onceSample->loopStart != 1000 || offsetSample->loopStart != 1100
+        || offsetSample->loopEnd != 1900 || !offsetSample->ownLoop) {
+        stats.fail("sf2_zone_loops", "Zone loop points did not reach the zone's sample");
+        removeSoundFont(path);
+        return false;
+    }
+
+    // Half a second holds each note well past the 2000-frame sample
+    auto play = [&](int note, int& heldVoices, int& releasedVoices, float& maxStep) {
+        SamSamplerDSP sampler;
+        sampler.prepare(48000.0, 256);
+        sampler.loadSoundFont(path.c_str());
+        sampler.setParameter("silenceThreshold", -160.0f); // Voices last the whole release
+
+        std::vector<float> left(24000, 0.0f), right(24000, 0.0f);
+        sampler.noteOn(note, 1.0f);
+        processAudioInChunks(sampler, left.data(), right.data(), 24000, 256);
+        heldVoices = sampler.getActiveVoiceCount();
+
+        maxStep = 0.0f;
+        for (size_t i = 4800; i < left.size(); ++i)
+            maxStep = std::max(maxStep, std::abs(left[i] - left[i - 1]));
+
+        sampler.noteOff(note);
+        processAudioInChunks(sampler, left.data(), right.data(), 4800, 256);
+        releasedVoices = sampler.getActiveVoiceCount();
+    };
+
+    int onceHeld, onceReleased, loopHeld, loopReleased, untilHeld, untilReleased;
+    float onceStep, loopStep, untilStep;
+    play(60, onceHeld, onceReleased, onceStep);
+    play(62, loopHeld, loopReleased, loopStep);
+    play(64, untilHeld, untilReleased, untilStep);
+
+    std::cout << "    Voices held/released: once " << onceHeld << "/" << onceReleased << ", loop "
+              << loopHeld << "/" << loopReleased << ", until release " << untilHeld << "/" << untilReleased
+              << "; largest step " << std::max(loopStep, untilStep) << std::endl;
+
+    removeSoundFont(path);
+
+    if (onceHeld != 0 || loopHeld != 1 || untilHeld != 1) {
+        stats.fail("sf2_zone_loops", "Sample modes did not decide which zones loop");
+        return false;
+    }
+    if (loopReleased != 1 || untilReleased != 0) {
+        stats.fail("sf2_zone_loops", "Loop-until-release did not play out to the sample end");
+        return false;
+    }
+
+    // A full-scale 440 Hz sine at 0.55 moves at most ~0.032 per sample at 48 kHz
+    if (loopStep > 0.04f || untilStep > 0.04f) {
+        stats.fail("sf2_zone_loops", "Loop seam is not continuous");
+        return false;
+    }
+
+    stats.pass("sf2_zone_loops");
+    return true;
+}
+
+//==============================================================================
+// Test 30: SFZ Loading
+//==============================================================================
+
+namespace {
+
+// 16-bit mono WAV, with a smpl loop when loopEnd > loopStart (end exclusive)
+void writeTestWav(const std::filesystem::path& path, const std::vector<int16_t>& pcm, uint32_t sampleRate,
+                  uint32_t loopStart = 0, uint32_t loopEnd = 0) {
+    std::vector<uint8_t> body({ 'W', 'A', 'V', 'E' });
+    auto u16 = [](std::vector<uint8_t>& b, uint32_t v) { b.push_back(static_cast<uint8_t>(v)); b.push_back(static_cast<uint8_t>(v >> 8)); };
+    auto u32 = [&](std::vector<uint8_t>& b, uint32_t v) { u16(b, v & 0xFFFF); u16(b, v >> 16); };
+    auto chunk = [&](const char* id, const std::vector<uint8_t>& content) {
+        body.insert(body.end(), id, id + 4);
+        u32(body, static_cast<uint32_t>(content.size()));
+        body.insert(body.end(), content.begin(), content.end());
+    };
+
+    std::vector<uint8_t> format;
+    u16(format, 1); u16(format, 1); u32(format, sampleRate); u32(format, sampleRate * 2); u16(format, 2); u16(format, 16);
+    chunk("fmt ", format);
+
+    if (loopEnd > loopStart) {
+        std::vector<uint8_t> smpl;
+        for (int i = 0; i < 7; ++i)
+            u32(smpl, 0);
+        u32(smpl, 1); u32(smpl, 0);
+        u32(smpl, 0); u32(smpl, 0); u32(smpl, loopStart); u32(smpl, loopEnd - 1); u32(smpl, 0); u32(smpl, 0);
+        chunk("smpl", smpl);
+    }
+
+    std::vector<uint8_t> data;
+    for (int16_t v : pcm)
+        u16(data, static_cast<uint16_t>(v));
+    chunk("data", data);
+
+    std::vector<uint8_t> file({ 'R', 'I', 'F', 'F' });
+    u32(file, static_cast<uint32_t>(body.size()));
+    file.insert(file.end(), body.begin(), body.end());
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()),
+                                                static_cast<std::streamsize>(file.size()));
+}
+
+} // namespace
+
+bool testSFZLoading(TestStats& stats) {
+    std::cout << "\n[Test 30] SFZ Loading" << std::endl;
+
+    namespace fs = std::filesystem;
+    const fs::path directory = fs::temp_directory_path() / "samsampler_sfz_test";
+    fs::create_directories(directory / "samples");
+
+    // A looped 440 Hz sine (100-frame periods at 44 kHz) and an unlooped 220 Hz one
+    writeTestWav(directory / "samples" / "sine 440.wav", TestSoundFont::sine(440.0, 0.5, 22000, 44000.0), 44000,
+                 11000, 21000);
+    writeTestWav(directory / "samples" / "low.wav", TestSoundFont::sine(220.0, 0.5, 22000, 44000.0), 44000);
+
+    std::ofstream(directory / "common.sfzh") << "#define $TOP 79\n";
+    std::ofstream(directory / "test.sfz") <<
+        "// Two velocity layers over one looped sample, and a transposed one-shot\n"
+        "<control> default_path=samples/\n"
+        "#include \"common.sfzh\"\n"
+        "<global> ampeg_release=0.5 /* every region\n"
+        "   releases over half a second */\n"
+        "<group> lokey=c4 hikey=$TOP pitch_keycenter=a4\n"
+        "<region> sample=sine 440.wav lovel=1 hivel=63 volume=-6\n"
+        "<region> sample=sine 440.wav lovel=64 tune=100\n"
+        "<group> key=a2 loop_mode=one_shot\n"
+        "<region> sample=low.wav transpose=12 pitch_keycenter=a3\n"
+        "<region> sample=low.wav trigger=release\n";
+    const std::string path = (directory / "test.sfz").string();
+
+    SF2Reader reader;
+    if (!reader.loadFile(path.c_str()) || reader.getInstrumentCount() != 1) {
+        stats.fail("sfz_loading", "SFZ file did not load");
+        fs::remove_all(directory);
+        return false;
+    }
+
+    const SF2Reader::Instrument* instrument = reader.getInstrument(0);
+    const SF2Reader::Zone* soft = reader.findZone(0, 69, 30.0f);
+    const SF2Reader::Zone* loud = reader.findZone(0, 69, 100.0f);
+    const SF2Reader::Zone* low = reader.findZone(0, 45, 100.0f);
+    const Sample* looped = soft ? reader.getSample(soft->sampleIndex) : nullptr;
+
+    std::cout << "    Zones: " << instrument->zones.size() << ", soft layer " << (soft ? soft->attenuation : -1.0f)
+              << " dB, loop " << (looped ? looped->loopStart : -1) << "-" << (looped ? looped->loopEnd : -1)
+              << ", release " << (soft ? soft->envRelease : -1.0f) << " s" << std::endl;
+
+    if (instrument->zones.size() != 3 || !soft || !loud || !low || soft == loud
+        || reader.findZone(0, 80, 100.0f) || reader.findZone(0, 50, 100.0f)) {
+        stats.fail("sfz_loading", "Regions did not compile to one zone per playable region");
+        fs::remove_all(directory);
+        return false;
+    }
+    if (soft->keyRangeLow != 60 || soft->keyRangeHigh != 79 || soft->rootKey != 69 || soft->attenuation != 6.0f
+        || loud->tuning != 100.0 || std::abs(soft->envRelease - 0.5f) > 1e-6f
+        || low->rootKey != 57 || low->tuning != 1200.0) {
+        stats.fail("sfz_loading", "Group, global, #define or #include opcodes were not applied");
+        fs::remove_all(directory);
+        return false;
+    }
+    if (!looped || soft->sampleIndex != loud->sampleIndex || soft->sampleMode != 1 || low->sampleMode != 0
+        || looped->loopStart != 11000 || looped->loopEnd != 21000 || looped->numSamples != 22000) {
+        stats.fail("sfz_loading", "WAV data or its smpl loop did not reach the zones");
+        fs::remove_all(directory);
+        return false;
+    }
+
+    // A4 tuned up a semitone; A2 transposed up an octave from its A3 sample
+    SamSamplerDSP sampler;
+    sampler.prepare(48000.0, 256);
+    if (!sampler.loadSoundFont(path.c_str())) {
+        stats.fail("sfz_loading", "Engine did not load the SFZ file");
+        fs::remove_all(directory);
+        return false;
+    }
+
+    const int numSamples = 9600;
+    std::vector<float> outLeft(numSamples, 0.0f), outRight(numSamples, 0.0f);
+    sampler.noteOn(69, 1.0f);
+    processAudioInChunks(sampler, outLeft.data(), outRight.data(), numSamples, 256);
+    const double loudFrequency = measureFrequency(outLeft, 2400, numSamples, 48000.0);
+
+    sampler.reset();
+    sampler.noteOn(45, 1.0f);
+    processAudioInChunks(sampler, outLeft.data(), outRight.data(), numSamples, 256);
+    const double lowFrequency = measureFrequency(outLeft, 2400, numSamples, 48000.0);
+
+    std::cout << "    Note 69 plays " << loudFrequency << " Hz, note 45 plays " << lowFrequency << " Hz" << std::endl;
+
+    fs::remove_all(directory);
+
+    if (std::abs(loudFrequency - 466.16) > 5.0 || std::abs(lowFrequency - 220.0) > 5.0) {
+        stats.fail("sfz_loading", "Region tuning was not applied at note-on");
+        return false;
+    }
+
+    stats.pass("sfz_loading");
+    return true;
+}
+
+bool testSFZLoadTime(TestStats& stats) {
+    std::cout << "\n[Test 31] SFZ Load Time" << std::endl;
+
+    namespace fs = std::filesystem;
+    const fs::path directory = fs::temp_directory_path() / "samsampler_sfz_load_test";
+    fs::create_directories(directory);
+
+    // 5,120 regions: 40 velocity layers per key over 128 keys, sharing 64 WAVs
+    const int numWavs = 64;
+    for (int w = 0; w < numWavs; ++w)
+        writeTestWav(directory / ("s" + std::to_string(w) + ".wav"),
+                     TestSoundFont::sine(110.0 * (1 + w % 8), 0.5, 4410, 44100.0), 44100, 1000, 4000);
+
+    std::string text = "<global> ampeg_release=0.3 amp_veltrack=80\n";
+    int numRegions = 0;
+    for (int key = 0; key < 128; ++key) {
+        text += "<group> key=" + std::to_string(key) + " loop_mode=loop_continuous\n";
+        for (int layer = 0; layer < 40; ++layer, ++numRegions)
+            text += "<region> sample=s" + std::to_string((key + layer) % numWavs) + ".wav lovel="
+                  + std::to_string(layer * 3 + 1) + " hivel=" + std::to_string(layer * 3 + 3)
+                  + " tune=" + std::to_string(layer - 20) + "\n";
+    }
+    std::ofstream(directory / "large.sfz") << text;
+    const std::string path = (directory / "large.sfz").string();
+
+    const auto start = std::chrono::steady_clock::now();
+    SF2Reader reader;
+    const bool loaded = reader.loadFile(path.c_str());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const SF2Reader::Instrument* instrument = loaded ? reader.getInstrument(0) : nullptr;
+    const SF2Reader::Zone* zone = loaded ? reader.findZone(0, 100, 64.0f) : nullptr;
+
+    std::cout << "    " << numRegions << " regions, " << (instrument ? instrument->zones.size() : 0) << " zones, "
+              << reader.getSampleCount() << " samples loaded in " << seconds * 1000.0 << " ms" << std::endl;
+
+    fs::remove_all(directory);
+
+    if (!instrument || static_cast<int>(instrument->zones.size()) != numRegions || !zone
+        || zone->keyRangeLow != 100 || zone->velocityRangeLow != 64 || zone->tuning != 1.0) {
+        stats.fail("sfz_load_time", "Large SFZ did not compile every region");
+        return false;
+    }
+    if (seconds > 1.0) {
+        stats.fail("sfz_load_time", "Large SFZ took over a second to load");
+        return false;
+    }
+
+    stats.pass("sfz_load_time");
+    return true;
+}
+
+//==============================================================================
+// Test 32: Packed Instruments
+//==============================================================================
+
+bool testPackedInstruments(TestStats& stats) {
+    std::cout << "\n[Test 32] Packed Instruments" << std::endl;
+
+    // The loop test's instrument, packed at 48 kHz with mip levels
+    TestSoundFont font;
+    font.presetZones = { { { { 41, 0 } }, {} } };
+    font.instrumentZones = {
+        { { { 38, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(0, 61)) }, { 58, 60 }, { 53, 0 } }, {} },
+        { { { 43, static_cast<int16_t>(keyRange(62, 127)) }, { 58, 62 }, { 2, 100 }, { 54, 1 }, { 53, 0 } }, {} } };
+    TestSoundFont::SampleData sine;
+    sine.pcm = TestSoundFont::sine(440.0, 0.5, 2000, 44100.0);
+    sine.loopStart = 1000;
+    sine.loopEnd = 1900;
+    font.samples = { sine };
+
+    const std::string path = font.write("samsampler_pack_test.sf2");
+    const std::string packedPath = (std::filesystem::temp_directory_path() / "samsampler_pack_test.sampack").string();
+
+    SF2Reader source;
+    SF2Reader packed;
+    const bool saved = source.loadFile(path.c_str()) && source.savePacked(packedPath.c_str(), 48000, true);
+    if (!saved || !packed.loadFile(packedPath.c_str())) {
+        stats.fail("packed_instruments", "Instrument did not round-trip through a packed file");
+        removeSoundFont(path);
+        std::remove(packedPath.c_str());
+        return false;
+    }
+
+    const SF2Reader::Zone* sourceZone = source.findZone(0, 70, 100.0f);
+    const SF2Reader::Zone* zone = packed.findZone(0, 70, 100.0f);
+    const Sample* sample = zone ? packed.getSample(zone->sampleIndex) : nullptr;
+    const bool zonesMatch = sourceZone && zone && zone->keyRangeLow == 62 && zone->sampleMode == 1
+                         && zone->rootKey == sourceZone->rootKey && zone->attenuation == sourceZone->attenuation
+                         && zone->modulators.ops.size() == sourceZone->modulators.ops.size()
+                         && packed.getSampleCount() == source.getSampleCount();
+    const bool mapped = sample && sample->mapping && sample->sampleRate == 48000 && sample->ownLoop
+                     && sample->loopStart == 1197 && zone->loopStart == 1197 && sample->isValid()
+                     && std::atomic_load(&sample->pyramid) && std::atomic_load(&sample->loopRegion);
+
+    std::cout << "    Packed: " << packed.getSampleCount() << " samples, zone loop " << (zone ? zone->loopStart : -1)
+              << "-" << (zone ? zone->loopEnd : -1) << " at " << (sample ? sample->sampleRate : 0) << " Hz" << std::endl;
+
+    if (!zonesMatch || !mapped) {
+        stats.fail("packed_instruments", "Packed zones or mapped samples do not match the source");
+        removeSoundFont(path);
+        std::remove(packedPath.c_str());
+        return false;
+    }
+
+    // Played from the SoundFont (converted on load) and from the packed file (as stored)
+    auto render = [](const std::string& file, int note) {
+        SamSamplerDSP sampler;
+        sampler.prepare(48000.0, 256);
+        sampler.setParameter("resampleOnLoad", 1.0f);
+        sampler.setParameter("mipMapping", 1.0f);
+        sampler.loadSoundFont(file.c_str());
+
+        std::vector<float> left(9600, 0.0f), right(9600, 0.0f);
+        sampler.noteOn(note, 0.8f);
+        processAudioInChunks(sampler, left.data(), right.data(), 9600, 256);
+        return left;
+    };
+
+    float maxDifference = 0.0f, peak = 0.0f;
+    for (int note : { 60, 86 }) {
+        const std::vector<float> expected = render(path, note);
+        const std::vector<float> actual = render(packedPath, note);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::abs(expected[i] - actual[i]));
+            peak = std::max(peak, std::abs(actual[i]));
+        }
+    }
+
+    std::cout << "    Largest difference from the SoundFont: " << maxDifference << " (peak " << peak << ")" << std::endl;
+
+    removeSoundFont(path);
+    std::remove(packedPath.c_str());
+
+    if (peak < 0.1f || maxDifference > 1.0e-6f) {
+        stats.fail("packed_instruments", "Packed instrument does not play like its source");
+        return false;
+    }
+
+    stats.pass("packed_instruments");
+    return true;
+}
+
+//==============================================================================
+// Test 33: SF2 Index Cache
+//==============================================================================
+
+namespace {
+
+// Same zones (key index included) and bit-identical samples, guard frames too
+bool sameInstruments(const SF2Reader& a, const SF2Reader& b) {
+    if (a.getInstrumentCount() != b.getInstrumentCount() || a.getSampleCount() != b.getSampleCount())
+        return false;
+
+    for (int i = 0; i < a.getSampleCount(); ++i) {
+        const Sample* x = a.getSample(i);
+        const Sample* y = b.getSample(i);
+        if (!x || !y) {
+            if (x || y)
+                return false;
+            continue;
+        }
+        if (x->numChannels != y->numChannels || x->numSamples != y->numSamples || x->sampleRate != y->sampleRate
+            || x->loopStart != y->loopStart || x->loopEnd != y->loopEnd || x->rootNote != y->rootNote
+            || x->ownLoop != y->ownLoop)
+            return false;
+        for (int ch = 0; ch < x->numChannels; ++ch)
+            for (int n = -Sample::guardFrames; n < x->numSamples + Sample::guardFrames; ++n)
+                if (x->frames(ch)[n] != y->frames(ch)[n])
+                    return false;
+    }
+
+    for (int i = 0; i < a.getInstrumentCount(); ++i) {
+        const SF2Reader::Instrument& x = *a.getInstrument(i);
+        const SF2Reader::Instrument& y = *b.getInstrument(i);
+        if (x.name != y.name || x.zones.size() != y.zones.size() || x.keyZoneStart != y.keyZoneStart
+            || x.keyZones != y.keyZones)
+            return false;
+        for (size_t z = 0; z < x.zones.size(); ++z) {
+            const SF2Reader::Zone& p = x.zones[z];
+            const SF2Reader::Zone& q = y.zones[z];
+            if (p.sampleIndex != q.sampleIndex || p.keyRangeLow != q.keyRangeLow || p.keyRangeHigh != q.keyRangeHigh
+                || p.sampleMode != q.sampleMode || p.loopStart != q.loopStart || p.loopEnd != q.loopEnd
+                || p.attenuation != q.attenuation || p.pan != q.pan || p.tuning != q.tuning
+                || p.modulators.ops.size() != q.modulators.ops.size())
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool testSF2IndexCache(TestStats& stats) {
+    std::cout << "\n[Test 33] SF2 Index Cache" << std::endl;
+
+    // A looped copy below key 60 and a linked L/R pair above it, the kinds of
+    // sample a cache rebuilds from other samples' frames
+    auto makeFont = [](int16_t attenuation) {
+        TestSoundFont font;
+        font.presetZones = { { { { 41, 0 } }, {} } };
+        font.instrumentZones = {
+            { { { 48, attenuation } }, {} },
+            { { { 43, static_cast<int16_t>(keyRange(0, 59)) }, { 2, 100 }, { 54, 1 }, { 53, 0 } }, {} },
+            { { { 43, static_cast<int16_t>(keyRange(60, 127)) }, { 17, -500 }, { 53, 1 } }, {} },
+            { { { 43, static_cast<int16_t>(keyRange(60, 127)) }, { 17, 500 }, { 53, 2 } }, {} } };
+        TestSoundFont::SampleData mono;
+        mono.pcm = TestSoundFont::sine(440.0, 0.5, 2000);
+        mono.loopStart = 1000;
+        mono.loopEnd = 1900;
+        TestSoundFont::SampleData left = mono, right = mono;
+        right.pcm = TestSoundFont::sine(220.0, 0.25, 2000);
+        left.type = 4; left.link = 2;
+        right.type = 2; right.link = 1;
+        font.samples = { mono, left, right };
+        return font;
+    };
+
+    const std::string path = makeFont(30).write("samsampler_index_test.sf2");
+    const std::string cachePath = SF2Reader::indexCachePath(path.c_str());
+    std::remove(cachePath.c_str());
+
+    SF2Reader parsed, cached, uncached;
+    const bool parsedLoaded = parsed.loadFile(path.c_str());
+    const bool cacheWritten = std::filesystem::exists(cachePath);
+    const bool cachedLoaded = cached.loadFile(path.c_str());
+    uncached.setIndexCacheEnabled(false);
+    uncached.loadFile(path.c_str());
+
+    std::cout << "    Parsed: " << parsed.getSampleCount() << " samples, cache "
+              << (cacheWritten ? "written" : "missing") << ", second load "
+              << (cached.isLoadedFromIndexCache() ? "from cache" : "parsed") << std::endl;
+
+    if (!parsedLoaded || parsed.isLoadedFromIndexCache() || !cacheWritten || !cachedLoaded
+        || !cached.isLoadedFromIndexCache() || uncached.isLoadedFromIndexCache()) {
+        stats.fail("sf2_index_cache", "Index cache was not written and used");
+        removeSoundFont(path);
+        return false;
+    }
+    if (!sameInstruments(parsed, cached) || std::string(cached.getRomName()) != parsed.getRomName()) {
+        stats.fail("sf2_index_cache", "Cached load differs from parsing the SoundFont");
+        removeSoundFont(path);
+        return false;
+    }
+
+    // Same size and modification time, different pdta: the content hash catches it
+    const auto modified = std::filesystem::last_write_time(path);
+    makeFont(31).write("samsampler_index_test.sf2");
+    std::filesystem::last_write_time(path, modified);
+
+    SF2Reader edited;
+    edited.loadFile(path.c_str());
+    const SF2Reader::Zone* zone = edited.findZone(0, 40, 100.0f);
+    const bool stale = edited.isLoadedFromIndexCache() || !zone || std::abs(zone->attenuation - 3.1f) > 1e-4f;
+
+    removeSoundFont(path);
+
+    if (stale) {
+        stats.fail("sf2_index_cache", "A stale index cache was used for an edited SoundFont");
+        return false;
+    }
+
+    stats.pass("sf2_index_cache");
+    return true;
+}
+
 //==============================================================================
 // Main Test Runner
 //==============================================================================
@@ -312,6 +2593,32 @@ int main(int argc, char* argv[]) {
     testSampleRates(stats);
     testPolyphony(stats);
     testPitchBend(stats);
+    testSpanRendering(stats);
+    testGuardFrames(stats);
+    testLoopCrossfade(stats);
+    testStereoPlayback(stats);
+    testFixedPointPhase(stats);
+    testSincInterpolation(stats);
+    testMipMapping(stats);
+    testSampleRateConversion(stats);
+    testParallelRendering(stats);
+    testCpuGovernor(stats);
+    testSilentVoiceRetirement(stats);
+    testDenormalProtection(stats);
+    testSinglePrecisionParity(stats);
+    testFilterCoefficients(stats);
+    testFilterBank(stats);
+    testStereoEnhancement(stats);
+    testConstantPowerPanning(stats);
+    testMultiOutputRouting(stats);
+    testMultiTimbralParts(stats);
+    testSF2GeneratorFlattening(stats);
+    testSF2Modulators(stats);
+    testSF2ZoneLoops(stats);
+    testSFZLoading(stats);
+    testSFZLoadTime(stats);
+    testPackedInstruments(stats);
+    testSF2IndexCache(stats);
 
     stats.printSummary();
 
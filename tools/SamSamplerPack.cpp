@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    SamSamplerPack.cpp
+    Converts SF2 and SFZ instruments to Sam Sampler packed instruments
+
+    Usage: sam_sampler_pack input.sf2|input.sfz output.sampack [--rate N] [--mips]
+
+      --rate N   Store the PCM resampled to N Hz (the host rate the sampler
+                 will run at), so loading skips resampling too
+      --mips     Store anti-aliased mip levels for high transpositions
+
+  ==============================================================================
+*/
+
+#include "dsp/SamSamplerDSP.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr, "Usage: sam_sampler_pack input.sf2|input.sfz output.sampack [--rate N] [--mips]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+        return usage();
+
+    const char* inputPath = argv[1];
+    const char* outputPath = argv[2];
+    int sampleRate = 0;
+    bool mipLevels = false;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            sampleRate = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--mips") == 0)
+            mipLevels = true;
+        else
+            return usage();
+    }
+
+    if (sampleRate < 0)
+        return usage();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    DSP::SF2Reader reader;
+    if (!reader.loadFile(inputPath))
+    {
+        std::fprintf(stderr, "Could not load %s\n", inputPath);
+        return 1;
+    }
+
+    if (!reader.savePacked(outputPath, sampleRate, mipLevels))
+    {
+        std::fprintf(stderr, "Could not write %s\n", outputPath);
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %d instruments, %d samples -> %s (%.2f s)\n", inputPath, reader.getInstrumentCount(),
+                reader.getSampleCount(), outputPath, seconds);
+    return 0;
+}